@@ -0,0 +1,161 @@
+#pragma once
+#ifndef ACTIONJOURNAL_HPP
+#define ACTIONJOURNAL_HPP
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <SFML/System/Vector2.hpp>
+#include "TileTypeEnum.hpp"
+
+/**
+ * This enum class contains all types of records inside the action journal.
+ */
+enum class JournalRecordEnum : std::uint8_t
+{
+	BULLDOZE = 1,
+	FUND = 2,
+	DAY = 3,
+	ADVANCE = 4
+};
+
+/**
+ * Represents one record of the action journal. Only members related to the record's type are meaningful.
+ */
+struct JournalRecord
+{
+	// Type of the record.
+	JournalRecordEnum m_type{JournalRecordEnum::DAY};
+	// Sequence number of the record, increases by one for each appended record.
+	std::uint32_t m_seq{0};
+	// Selected rectangle's top left and bottom right positions of a bulldoze record.
+	sf::Vector2i m_start_pos{0, 0};
+	sf::Vector2i m_end_pos{0, 0};
+	// New tile type of a bulldoze record.
+	TileTypeEnum m_tile_type{TileTypeEnum::VOID};
+	// New fund of a fund record.
+	double m_fund{0};
+	// The day reached by a day or advance record.
+	std::uint32_t m_day{0};
+};
+
+/**
+ * An append-only journal of all player mutations and day ticks since the last city snapshot. Loading replays the
+ * journal onto the snapshot, so each action is persisted by appending a few bytes instead of rewriting the whole map.
+ */
+class ActionJournal
+{
+ public:
+	/**
+	 * One parameter constructor. Open the journal file for appending.
+	 * @param journal_path A const std::string indicates the journal file's path.
+	 */
+	explicit ActionJournal(std::string journal_path);
+
+	/**
+	 * Append a bulldoze record.
+	 * @param seq A std::uint32_t indicates the record's sequence number.
+	 * @param start_pos A reference of const sf::Vector2i indicates selected rectangle's top left position.
+	 * @param end_pos A reference of const sf::Vector2i indicates selected rectangle's bottom right position.
+	 * @param tile_type A TileTypeEnum indicates the new tile type.
+	 */
+	void append_bulldoze(std::uint32_t seq, const sf::Vector2i& start_pos, const sf::Vector2i& end_pos,
+		TileTypeEnum tile_type);
+
+	/**
+	 * Append a fund record.
+	 * @param seq A std::uint32_t indicates the record's sequence number.
+	 * @param fund A double indicates the city's new fund.
+	 */
+	void append_fund(std::uint32_t seq, double fund);
+
+	/**
+	 * Append a day record.
+	 * @param seq A std::uint32_t indicates the record's sequence number.
+	 * @param day A unsigned integer indicates the day reached.
+	 */
+	void append_day(std::uint32_t seq, unsigned int day);
+
+	/**
+	 * Append an advance record, which stands for all days skipped by one fast-forward.
+	 * @param seq A std::uint32_t indicates the record's sequence number.
+	 * @param day A unsigned integer indicates the day reached.
+	 */
+	void append_advance(std::uint32_t seq, unsigned int day);
+
+	/**
+	 * Read all complete records whose sequence numbers are larger than the input one. A record truncated by a crash
+	 * ends the reading.
+	 * @param after_seq A std::uint32_t indicates the sequence number already included by the snapshot.
+	 * @param records_vec A reference of vector indicates the records to be filled.
+	 */
+	void read(std::uint32_t after_seq, std::vector<JournalRecord>& records_vec) const;
+
+	/**
+	 * Drop all records which have already been included by a snapshot, equivalent to prepare_compaction followed by
+	 * finish_compaction.
+	 * @param snapshot_seq A std::uint32_t indicates the last sequence number included by the snapshot.
+	 */
+	void compact(std::uint32_t snapshot_seq);
+
+	/**
+	 * First half of a compaction, which can run on any thread while records are still appended. Copy all records
+	 * after the snapshot into the temporary journal file without touching the journal object.
+	 * @param journal_path A reference of const string indicates the journal file's path.
+	 * @param snapshot_seq A std::uint32_t indicates the last sequence number included by the snapshot.
+	 * @param read_size_ref A reference of std::size_t to be set to the amount of bytes of the journal file which have
+	 * been read, records appended after them are copied by finish_compaction.
+	 * @return A bool indicates whether the temporary journal file is written successfully or not.
+	 */
+	static bool prepare_compaction(const std::string& journal_path, std::uint32_t snapshot_seq,
+		std::size_t& read_size_ref);
+
+	/**
+	 * Second half of a compaction, which has to run on the thread appending records. Copy the records appended since
+	 * prepare_compaction into the temporary journal file, then replace the journal file with it and continue appending
+	 * to it. Only the few records appended in between are copied.
+	 * @param read_size A std::size_t indicates the amount of bytes read by prepare_compaction.
+	 */
+	void finish_compaction(std::size_t read_size);
+
+	/**
+	 * Retrieve the journal file's size in bytes.
+	 * @return A std::size_t indicates the journal file's size.
+	 */
+	std::size_t get_size() const;
+
+ private:
+	/**
+	 * Write one record in binary form into the input stream.
+	 * @param output_stream A reference of std::ostream indicates the stream to write to.
+	 * @param record A reference of const JournalRecord indicates the record to be written.
+	 * @return A std::size_t indicates the amount of written bytes.
+	 */
+	static std::size_t write_record(std::ostream& output_stream, const JournalRecord& record);
+
+	/**
+	 * Read all complete records of the journal file whose sequence numbers are larger than the input one.
+	 * @param journal_path A reference of const string indicates the journal file's path.
+	 * @param after_seq A std::uint32_t indicates the sequence number already included by the snapshot.
+	 * @param records_vec A reference of vector indicates the records to be filled.
+	 * @return A std::size_t indicates the amount of bytes taken by all complete records, including skipped ones.
+	 */
+	static std::size_t read_records(const std::string& journal_path, std::uint32_t after_seq,
+		std::vector<JournalRecord>& records_vec);
+
+	/**
+	 * Write one record into the journal file and flush it.
+	 * @param record A reference of const JournalRecord indicates the record to be appended.
+	 */
+	void append(const JournalRecord& record);
+
+	// The journal file's path.
+	std::string m_journal_path;
+	// The journal file opened in append mode.
+	std::ofstream m_output_file;
+	// The journal file's size in bytes.
+	std::size_t m_size{0};
+};
+
+#endif //ACTIONJOURNAL_HPP
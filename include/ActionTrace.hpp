@@ -0,0 +1,184 @@
+#pragma once
+#ifndef ACTIONTRACE_HPP
+#define ACTIONTRACE_HPP
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <SFML/System/Vector2.hpp>
+#include "CitySnapshot.hpp"
+#include "TileTypeEnum.hpp"
+
+// Forward declarations.
+class City;
+class Tile;
+
+/**
+ * This enum class contains all types of logical player actions inside an action trace.
+ */
+enum class TraceRecordEnum : std::uint8_t
+{
+	FRAME = 1,
+	SELECT = 2,
+	PLACE = 3,
+	CANCEL = 4,
+	TILE = 5,
+	ZOOM = 6,
+	PAN = 7
+};
+
+/**
+ * Represents one logical player action of an action trace. Only members related to the record's type are meaningful.
+ */
+struct TraceRecord
+{
+	// Type of the record.
+	TraceRecordEnum m_type{TraceRecordEnum::FRAME};
+	// Elapsed time of a frame record.
+	float m_dt{0.f};
+	// Selected rectangle's corners(in tile coordinates) of a select record.
+	sf::Vector2i m_start_pos{0, 0};
+	sf::Vector2i m_end_pos{0, 0};
+	// Chosen tile type of a tile record.
+	TileTypeEnum m_tile_type{TileTypeEnum::GRASS};
+	// Zoom factor of a zoom record.
+	float m_zoom_factor{1.f};
+	// Camera offset(in world coordinates) of a pan record.
+	sf::Vector2f m_pan_offset{0.f, 0.f};
+};
+
+/**
+ * Record logical player actions of the main game state into a compact binary trace file.
+ */
+class TraceRecorder
+{
+ public:
+	/**
+	 * Two parameters' constructor. Create the trace file and write its header, which carries the recorded city when
+	 * recording starts. The save slot keeps changing while recording, so the trace cannot rely on it.
+	 * @param trace_path A reference of const std::string indicates the trace file's path.
+	 * @param start_snapshot A reference of const CitySnapshot indicates the recorded city when recording starts.
+	 */
+	TraceRecorder(const std::string& trace_path, const CitySnapshot& start_snapshot);
+
+	/**
+	 * Record the end of a frame.
+	 * @param dt A float indicates the frame's elapsed time in seconds.
+	 */
+	void record_frame(float dt);
+
+	/**
+	 * Record the current selected rectangle.
+	 * @param start_pos A reference of const sf::Vector2i indicates the rectangle's start corner in tile coordinates.
+	 * @param end_pos A reference of const sf::Vector2i indicates the rectangle's end corner in tile coordinates.
+	 */
+	void record_select(const sf::Vector2i& start_pos, const sf::Vector2i& end_pos);
+
+	/**
+	 * Record that the player releases the selection to place tiles.
+	 */
+	void record_place();
+
+	/**
+	 * Record that the player cancels the selection.
+	 */
+	void record_cancel();
+
+	/**
+	 * Record the tile type chosen by the player.
+	 * @param tile_type A TileTypeEnum indicates the chosen tile type.
+	 */
+	void record_tile(TileTypeEnum tile_type);
+
+	/**
+	 * Record a zoom of the game view.
+	 * @param zoom_factor A float indicates the zoom factor.
+	 */
+	void record_zoom(float zoom_factor);
+
+	/**
+	 * Record a pan of the game view.
+	 * @param pan_offset A reference of const sf::Vector2f indicates the camera offset in world coordinates.
+	 */
+	void record_pan(const sf::Vector2f& pan_offset);
+
+ private:
+	// The trace file.
+	std::ofstream m_output_file;
+};
+
+/**
+ * Read a binary trace file and replay its logical player actions onto a city at full speed.
+ */
+class TracePlayer
+{
+ public:
+	/**
+	 * One parameter constructor. Read the whole trace file.
+	 * @param trace_path A reference of const std::string indicates the trace file's path.
+	 */
+	explicit TracePlayer(const std::string& trace_path);
+
+	/**
+	 * Retrieve whether the trace file is read successfully or not.
+	 * @return A bool indicates whether the trace is valid.
+	 */
+	bool is_valid() const;
+
+	/**
+	 * Retrieve the recorded city when recording starts, which the trace must be replayed from.
+	 * @return A reference of const CitySnapshot indicates the recorded city.
+	 */
+	const CitySnapshot& get_start_snapshot() const;
+
+	/**
+	 * Replace the city with the recorded city when recording starts, so the trace is replayed from the same state.
+	 * @param city A reference of City object indicates the city to be replaced.
+	 * @param str_tile_map A reference of unordered_map indicates the mappings of each type Tile object's name and
+	 * related Tile object.
+	 * @return A bool indicates whether the replaced city matches the recorded one.
+	 */
+	bool restore_start(City& city, std::unordered_map<std::string, Tile>& str_tile_map) const;
+
+	/**
+	 * Retrieve the amount of frames inside the trace.
+	 * @return A std::size_t indicates the amount of frames.
+	 */
+	std::size_t get_frames_num() const;
+
+	/**
+	 * Retrieve the tile type chosen by the player so far.
+	 * @return A TileTypeEnum indicates the chosen tile type.
+	 */
+	TileTypeEnum get_tile_type() const;
+
+	/**
+	 * Apply the next frame's records onto the city, ending with the city's update of that frame.
+	 * @param city A reference of City object indicates the city to be driven.
+	 * @param str_tile_map A reference of unordered_map indicates the mappings of each type Tile object's name and
+	 * related Tile object.
+	 * @param view_records_vec A pointer of vector to be filled with the frame's zoom and pan records, which only affect
+	 * the game view. Can be nullptr if there is no game view.
+	 * @return A bool indicates whether a frame is played(false if the trace has ended).
+	 */
+	bool play_frame(City& city, std::unordered_map<std::string, Tile>& str_tile_map,
+		std::vector<TraceRecord>* view_records_vec = nullptr);
+
+ private:
+	// All records of the trace.
+	std::vector<TraceRecord> m_records_vec;
+	// Index of the next record to be played.
+	std::size_t m_next_record_idx{0};
+	// Amount of frame records.
+	std::size_t m_frames_num{0};
+	// Recorded city when recording starts.
+	CitySnapshot m_start_snapshot;
+	// Whether the trace is read successfully or not.
+	bool m_is_valid{false};
+	// Tile type chosen by the player so far.
+	TileTypeEnum m_tile_type{TileTypeEnum::GRASS};
+};
+
+#endif //ACTIONTRACE_HPP
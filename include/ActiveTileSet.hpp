@@ -0,0 +1,108 @@
+#pragma once
+#ifndef ACTIVETILESET_HPP
+#define ACTIVETILESET_HPP
+
+#include <cstdint>
+#include <map>
+#include <vector>
+#include "Utility.hpp"
+
+/**
+ * This enum class contains why a tile is skipped by the residential pass, or that it is not.
+ */
+enum class TileSleepEnum : std::uint8_t
+{
+	// Not a zone tile, the residential pass never changes it.
+	INERT,
+	// Updated by the residential pass each day.
+	ACTIVE,
+	// A zone tile at its population limit, which only changes once it levels up or is replaced.
+	FULL,
+	// An employing tile without anyone to hire, which only changes once the unemployed people group is not empty.
+	STARVED
+};
+
+/**
+ * Keeps the tiles which the residential pass has to update each day, in update order, so that the pass costs as much
+ * as the amount of awake tiles rather than the map's size. Tiles which cannot change are put to sleep and woken by the
+ * change they wait for. Full residential tiles are still growing beyond their limit each day, so they are counted by
+ * limit and their overflow is added as a whole.
+ */
+class ActiveTileSet
+{
+ public:
+	/**
+	 * Wake all zone tiles and put all other tiles to sleep.
+	 * @param update_order_vec A reference of const vector indicates the tiles' indices in update order.
+	 * @param is_zone_vec A reference of const vector indicates whether each tile is a zone tile.
+	 */
+	void reset(const std::vector<int>& update_order_vec, const std::vector<bool>& is_zone_vec);
+
+	/**
+	 * Wake the starved tiles if people can be hired, then bring the awake tiles up to date for the day's pass.
+	 * @param is_unemployment_available A bool indicates whether the unemployed people group is not empty.
+	 */
+	void begin_day(bool is_unemployment_available);
+
+	/**
+	 * Retrieve the awake tiles in update order, valid from begin_day until any tile is woken.
+	 * @return A reference of const vector indicates the tiles' indices.
+	 */
+	const std::vector<int>& get_active_idx_vec() const;
+
+	/**
+	 * Retrieve the amount of awake tiles as of the last begin_day, which are the tiles updated by the last pass.
+	 * @return A std::size_t indicates the amount.
+	 */
+	std::size_t get_active_tiles_num() const;
+
+	/**
+	 * Check whether every tile sleeps, so the next pass would only add the sleeping full residential tiles.
+	 * @return A bool indicates whether no tile is awake.
+	 */
+	bool is_all_asleep() const;
+
+	/**
+	 * Put an awake tile to sleep. It stays inside the awake tiles until the next begin_day.
+	 * @param tile_index A integer indicates the tile's index.
+	 * @param sleep_type A TileSleepEnum indicates why the tile sleeps.
+	 * @param residential_limit A unsigned integer indicates a full residential tile's population limit, zero for all
+	 * other tiles.
+	 */
+	void put_to_sleep(int tile_index, TileSleepEnum sleep_type, unsigned int residential_limit = 0);
+
+	/**
+	 * Wake a tile because it changed, for instance since it leveled up or was replaced. Tiles which are no longer
+	 * zone tiles are put to sleep again by the next pass.
+	 * @param tile_index A integer indicates the tile's index.
+	 */
+	void wake_tile(int tile_index);
+
+	/**
+	 * Add the overflow and population of all sleeping full residential tiles, as if each of them were updated.
+	 * @param rate A double indicates the residential growth rate, which is never negative while tiles sleep full.
+	 * @param homeless_ref A reference of double to be increased by the people beyond the limits.
+	 * @param total_population_ref A reference of double to be increased by the tiles' population.
+	 */
+	void add_full_residential(double rate, double& homeless_ref, double& total_population_ref) const;
+
+ private:
+	// Each tile's sleep state.
+	std::vector<TileSleepEnum> m_sleep_type_vec;
+	// Whether each tile is inside m_active_idx_vec or m_woken_idx_vec.
+	std::vector<std::uint8_t> m_is_listed_vec;
+	// Each tile's position inside the update order.
+	std::vector<int> m_update_position_vec;
+	// Population limit of each sleeping full residential tile.
+	std::vector<unsigned int> m_residential_limit_vec;
+	// Awake tiles in update order, including tiles put to sleep since the last begin_day.
+	std::vector<int> m_active_idx_vec;
+	// Tiles woken since the last begin_day.
+	std::vector<int> m_woken_idx_vec;
+	// Tiles put to sleep as starved, some may have been woken otherwise since.
+	std::vector<int> m_starved_idx_vec;
+	// Amount of sleeping full residential tiles of each population limit, in ascending limit order.
+	std::map<unsigned int, std::size_t> m_full_residential_num_map;
+};
+
+#endif //ACTIVETILESET_HPP
@@ -23,6 +23,18 @@ class Animation
 	 */
 	unsigned int getTotalFrame() const;
 
+	/**
+	 * Get the animation's start frame.
+	 * @return An unsigned integer indicates the animation's start frame.
+	 */
+	unsigned int getStartFrame() const;
+
+	/**
+	 * Get the animation's end frame.
+	 * @return An unsigned integer indicates the animation's end frame.
+	 */
+	unsigned int getEndFrame() const;
+
 	/**
 	 * Get the animation duration.
 	 * @return A float indicates the animation duration.
@@ -0,0 +1,136 @@
+#pragma once
+#ifndef ASSETPACK_HPP
+#define ASSETPACK_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <SFML/Graphics/Rect.hpp>
+
+/**
+ * One animation of a packed texture, the same as the Animation object created from it.
+ */
+struct PackedAnimation
+{
+	std::uint32_t m_start_frame{0};
+	std::uint32_t m_end_frame{0};
+	float m_duration{0.f};
+};
+
+/**
+ * One texture inside the asset pack, stored as raw RGBA pixels.
+ */
+struct PackedTexture
+{
+	// Name of the texture inside the TextureManager.
+	std::string m_name;
+	// Width and height of the texture in pixels.
+	std::uint32_t m_width{0};
+	std::uint32_t m_height{0};
+	// Size of each frame inside the texture(only width and height are used).
+	sf::IntRect m_frame_rect;
+	// All animations of the tile which uses the texture, empty for textures which are not tiles.
+	std::vector<PackedAnimation> m_animations_vec;
+	// Width x height RGBA pixels, pointing into the pack file's memory once opened.
+	const std::uint8_t* m_pixels_ptr{nullptr};
+};
+
+/**
+ * One font file inside the asset pack, stored as it is.
+ */
+struct PackedFont
+{
+	// Name of the font.
+	std::string m_name;
+	// The font file's bytes, pointing into the pack file's memory once opened.
+	const void* m_data_ptr{nullptr};
+	std::size_t m_size{0};
+};
+
+/**
+ * Represents the prebuilt asset pack file, which bakes all textures as raw RGBA pixels together with their frame
+ * rects and animation tables, and all font files into one file. The file is memory mapped and all pixels and font
+ * bytes are used straight from the mapping, so nothing needs to be decoded or copied at startup.
+ */
+class AssetPack
+{
+ public:
+	/**
+	 * Default constructor, no file is opened.
+	 */
+	AssetPack() = default;
+
+	/**
+	 * Destructor. Unmap the opened file.
+	 */
+	~AssetPack();
+
+	/**
+	 * Deleted copy constructor since the file mapping cannot be copied.
+	 */
+	AssetPack(const AssetPack&) = delete;
+	/**
+	 * Deleted copy assignment operator since the file mapping cannot be copied.
+	 */
+	AssetPack& operator=(const AssetPack&) = delete;
+
+	/**
+	 * Write the asset pack file.
+	 * @param pack_path A reference of const string indicates the file's path.
+	 * @param textures_vec A reference of const vector indicates all textures, their pixels must be valid.
+	 * @param fonts_vec A reference of const vector indicates all fonts, their bytes must be valid.
+	 * @return A bool indicates whether the file is written successfully or not.
+	 */
+	static bool write(const std::string& pack_path, const std::vector<PackedTexture>& textures_vec,
+		const std::vector<PackedFont>& fonts_vec);
+
+	/**
+	 * Map the asset pack file into memory and read its tables. Any previously opened file is closed first.
+	 * @param pack_path A reference of const string indicates the file's path.
+	 * @return A bool indicates whether the file exists and is a valid asset pack of the current version.
+	 */
+	bool open(const std::string& pack_path);
+
+	/**
+	 * Unmap the opened file, all textures' pixels and fonts' bytes become invalid.
+	 */
+	void close();
+
+	/**
+	 * Check whether an asset pack file is opened.
+	 * @return A bool indicates whether the file is opened.
+	 */
+	bool is_open() const;
+
+	/**
+	 * Retrieve all textures inside the pack.
+	 * @return A reference of const vector indicates the textures in the order they are written.
+	 */
+	const std::vector<PackedTexture>& get_textures() const;
+
+	/**
+	 * Find the texture of the input name.
+	 * @param texture_name A reference of const string indicates the texture's name.
+	 * @return A pointer of const PackedTexture indicates the texture, nullptr if the pack does not hold it.
+	 */
+	const PackedTexture* find_texture(const std::string& texture_name) const;
+
+	/**
+	 * Find the font of the input name.
+	 * @param font_name A reference of const string indicates the font's name.
+	 * @return A pointer of const PackedFont indicates the font, nullptr if the pack does not hold it.
+	 */
+	const PackedFont* find_font(const std::string& font_name) const;
+
+ private:
+	// The mapped file's memory and size.
+	const std::uint8_t* m_data_ptr{nullptr};
+	std::size_t m_size{0};
+	// The file's bytes on platforms without memory mapping.
+	std::vector<std::uint8_t> m_data_vec;
+	// All textures and fonts inside the pack.
+	std::vector<PackedTexture> m_textures_vec;
+	std::vector<PackedFont> m_fonts_vec;
+};
+
+#endif //ASSETPACK_HPP
@@ -0,0 +1,99 @@
+#pragma once
+#ifndef AUTOSAVER_HPP
+#define AUTOSAVER_HPP
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "CitySnapshot.hpp"
+#include "SaveSlot.hpp"
+
+// Forward declaration.
+class City;
+
+/**
+ * This class saves the city periodically, or when the city's action journal grows too large. A snapshot of the city is
+ * captured on the main thread and then written into disk by a background thread, so the game loop never waits for the
+ * file system. Once written, the background thread also rewrites the journal without the records included by the
+ * snapshot, and the main thread only swaps the journal file.
+ */
+class AutoSaver
+{
+ public:
+	/**
+	 * Two parameters' constructor. Start the background saving thread.
+	 * @param slot A reference of const SaveSlot indicates the save slot to be written.
+	 * @param interval_days A unsigned integer indicates how many game days should elapse between two autosaves.
+	 */
+	AutoSaver(const SaveSlot& slot, unsigned int interval_days);
+
+	/**
+	 * Destructor. Finish the pending autosave(if exists) and stop the background saving thread.
+	 */
+	~AutoSaver();
+
+	/**
+	 * Deleted copy constructor since the background saving thread cannot be copied.
+	 */
+	AutoSaver(const AutoSaver&) = delete;
+	/**
+	 * Deleted copy assignment operator since the background saving thread cannot be copied.
+	 */
+	AutoSaver& operator=(const AutoSaver&) = delete;
+
+	/**
+	 * Check if enough game days have elapsed since last autosave or the city's journal is full. If so, capture a
+	 * snapshot of the city and hand it over to the background saving thread. Also swap in the city's compacted journal
+	 * once a snapshot has been written. Should be called once per frame.
+	 * @param city A reference of City object indicates the city to be saved.
+	 */
+	void update(City& city);
+
+	/**
+	 * Block until the pending autosave(if exists) has been written into disk. A compacted journal which has not been
+	 * swapped in yet is dropped, since the caller is about to save the city itself.
+	 */
+	void wait();
+
+	/**
+	 * Retrieve whether the background saving thread is writing a snapshot or not.
+	 * @return A bool indicates whether an autosave is in progress.
+	 */
+	bool is_busy();
+
+ private:
+	/**
+	 * The background saving thread's main loop. Wait for a captured snapshot and write it into disk.
+	 */
+	void save_loop();
+
+	// The save slot to be written.
+	SaveSlot m_slot;
+	// Amount of game days between two autosaves.
+	unsigned int m_interval_days{0};
+	// The game day of last autosave.
+	unsigned int m_last_saved_day{0};
+	// Whether m_last_saved_day has been initialized with the city's current day or not.
+	bool m_is_started{false};
+
+	/* Snapshot handed over to the background saving thread. It is kept between autosaves, so capturing does not
+	 * allocate once the vector has grown to the map's size and only copies the chunks changed since the last one. */
+	CitySnapshot m_snapshot;
+	// Whether m_snapshot holds a captured snapshot which has not been written yet.
+	bool m_has_pending_snapshot{false};
+	// Whether a snapshot has been written successfully and its compacted journal is not swapped in yet.
+	bool m_has_compacted_journal{false};
+	// The amount of journal bytes read while compacting the journal.
+	std::size_t m_journal_read_size{0};
+	// Whether the background saving thread should exit.
+	bool m_is_stopping{false};
+	// Guard m_snapshot, m_has_pending_snapshot, m_has_compacted_journal, m_journal_read_size and m_is_stopping.
+	std::mutex m_mutex;
+	// Notify the background saving thread about a new snapshot and notify waiters about a finished write.
+	std::condition_variable m_condition;
+	// The background saving thread.
+	std::thread m_save_thread;
+};
+
+#endif //AUTOSAVER_HPP
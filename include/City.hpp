@@ -2,12 +2,22 @@
 #ifndef CITY_HPP
 #define CITY_HPP
 
+#include <atomic>
+#include <memory>
 #include <vector>
 #include <iostream>
+#include <random>
+#include <unordered_map>
+#include <unordered_set>
+#include "ActiveTileSet.hpp"
+#include "LevelUpScheduler.hpp"
 #include "Map.hpp"
 
 // Forward declarations.
 class Tile;
+class CitySnapshot;
+class ActionJournal;
+class SaveSlot;
 
 /**
  * Represents the game city and manages the actual gameplay.
@@ -26,34 +36,84 @@ class City
 			 m_current_day_elapsed_time(0), m_time_per_day(0.f), m_day(0){};
 
 	/**
-	 * Three parameters' constructor of City.
-	 * @param city_name_str A reference of const string indicates the city's name.
+	 * Four parameters' constructor of City.
+	 * @param slot A reference of const SaveSlot indicates the save slot which the city is loaded from.
 	 * @param tile_half_width A unsigned integer indicates each Tile object's half width length.
 	 * @param str_tile_map A reference of an unordered_map indicates mappings of each type Tile object's name and
 	 * related Tile object.
+	 * @param is_journaling A bool indicates whether following actions are journaled(and thus change the save files).
+	 * Default value is true.
+	 * @param load_progress_ptr A pointer of atomic unsigned integer to be set to the loading progress in percent while
+	 * loading on another thread, nullptr if not required.
+	 * @param load_cancel_ptr A pointer of const atomic bool which cancels the loading between its steps once it is set,
+	 * nullptr if the loading cannot be cancelled. A cancelled city is incomplete and must be discarded.
 	 */
-	City(const std::string& city_name_str, unsigned int tile_half_width,
-		std::unordered_map<std::string, Tile>& str_tile_map) : City()
+	City(const SaveSlot& slot, unsigned int tile_half_width,
+		std::unordered_map<std::string, Tile>& str_tile_map, bool is_journaling = true,
+		std::atomic<unsigned int>* load_progress_ptr = nullptr,
+		const std::atomic<bool>* load_cancel_ptr = nullptr) : City()
 	{
-		load(city_name_str, str_tile_map);
-		// Set each tile's half width length and load the tile map.
-		m_map_ptr->set_tile_half_width(tile_half_width);
+		load(slot, str_tile_map, is_journaling, load_progress_ptr, load_cancel_ptr);
+		// Set each tile's half width length unless the loading is cancelled before the map is created.
+		if (m_map_ptr)
+			m_map_ptr->set_tile_half_width(tile_half_width);
 
 	};
 
 	/**
-	 * Load all city contents(include the game map).
-	 * @param city_name_str A reference of const string indicates the city's name.
+	 * Load all city contents(include the game map), then replay the action journal onto them and keep journaling
+	 * following actions if required. A new city is generated if the save slot is empty.
+	 * @param slot A reference of const SaveSlot indicates the save slot to be loaded.
 	 * @param str_tile_map A reference of unordered_map indicates the mappings of each type Tile object's name and
 	 * related Tile object.
+	 * @param is_journaling A bool indicates whether following actions are journaled. If not, the save files are never
+	 * written until start_journaling is called. Default value is true.
+	 * @param load_progress_ptr A pointer of atomic unsigned integer to be set to the loading progress in percent while
+	 * loading on another thread, nullptr if not required.
+	 * @param load_cancel_ptr A pointer of const atomic bool which cancels the loading between its steps once it is set,
+	 * nullptr if the loading cannot be cancelled.
+	 * @return A bool indicates whether the city is completely loaded, false if the loading is cancelled.
 	 */
-	void load(const std::string& city_name_str, std::unordered_map<std::string, Tile>& str_tile_map);
+	bool load(const SaveSlot& slot, std::unordered_map<std::string, Tile>& str_tile_map,
+		bool is_journaling = true, std::atomic<unsigned int>* load_progress_ptr = nullptr,
+		const std::atomic<bool>* load_cancel_ptr = nullptr);
+
+	/**
+	 * Start journaling following actions of a city loaded without journaling, as if it were loaded with journaling.
+	 * A newly generated city or a city loaded from an old version's save is saved into the save slot right away.
+	 * @param slot A reference of const SaveSlot indicates the save slot which the city is loaded from.
+	 */
+	void start_journaling(const SaveSlot& slot);
 
 	/**
 	 * Save all city contents(include the game map).
-	 * @param city_name_str A reference of const string indicates the city's name.
+	 * @param slot A reference of const SaveSlot indicates the save slot to be written.
+	 */
+	void save(const SaveSlot& slot);
+
+	/**
+	 * Copy all city contents(include the game map) which need to be persisted into the input snapshot. The snapshot's
+	 * buffers are reused, so repeated captures do not allocate.
+	 * @param snapshot A reference of CitySnapshot object indicates the snapshot to be filled.
+	 */
+	void take_snapshot(CitySnapshot& snapshot) const;
+
+	/**
+	 * Bring the snapshot last updated by this function up to date. The properties are copied, but only the game map's
+	 * chunks changed since then, so an autosave of a city whose day touches few chunks copies few tiles. Only one
+	 * snapshot can be kept up to date this way, any other snapshot must be taken by take_snapshot.
+	 * @param snapshot A reference of CitySnapshot object indicates the snapshot to be updated.
+	 */
+	void update_snapshot(CitySnapshot& snapshot);
+
+	/**
+	 * Replace all city contents(include the game map) with the input snapshot's, as if the city were loaded from a save
+	 * slot holding it. No save file or journal is touched.
+	 * @param snapshot A reference of const CitySnapshot object indicates the snapshot to be restored.
+	 * @param str_tile_map A reference of unordered_map indicates the mappings of each type Tile object's name and
+	 * related Tile object.
 	 */
-	void save(const std::string& city_name_str);
+	void restore_snapshot(const CitySnapshot& snapshot, std::unordered_map<std::string, Tile>& str_tile_map);
 
 	/**
 	 * Update the city according to elapsed time. For instance, let people move around, calculate new income,
@@ -62,6 +122,41 @@ class City
 	 */
 	void update(float dt);
 
+	/**
+	 * Advance the city by many days at once, with exactly the same result as stepping each day. While the city is in a
+	 * steady state, meaning every zone tile sleeps full at its maximum level so no level-up is pending and industrial
+	 * tiles have nothing left to extract or hand out, only the city-wide sums are carried from day to day: the full
+	 * residential tiles' overflow, the homeless people's growth, the workers and each month's earnings. Until then, and
+	 * always with the parallel residential pass, days are stepped one by one. The result only depends on the city and
+	 * the amount of days, so it is journaled as a single record.
+	 * @param days_num A unsigned integer indicates the amount of days to advance.
+	 */
+	void advanceDays(unsigned int days_num);
+
+	/**
+	 * Replace the selection with all tiles within the bounding rectangle of start_pos and end_pos which can be replaced
+	 * by the specified tile type.
+	 * @param start_pos A reference of sf::Vector2i indicates one corner of the bounding rectangle.
+	 * @param end_pos A reference of sf::Vector2i indicates the opposite corner of the bounding rectangle.
+	 * @param tile_type A TileTypeEnum indicates the tile type which selected tiles will be replaced with.
+	 */
+	void select(sf::Vector2i& start_pos, sf::Vector2i& end_pos, TileTypeEnum tile_type);
+
+	/**
+	 * Calculate the overall cost of replacing all selected tiles with the specified tile.
+	 * @param tile A reference of const Tile indicates the specified Tile object.
+	 * @return A unsigned integer indicates the overall cost.
+	 */
+	unsigned int get_selection_cost(const Tile& tile) const;
+
+	/**
+	 * Replace all selected tiles with the specified tile if the city's fund is enough, then pay for them and update
+	 * roads and regions.
+	 * @param tile A reference of const Tile indicates the specified Tile object.
+	 * @return A bool indicates whether selected tiles are replaced or not.
+	 */
+	bool place_selection(const Tile& tile);
+
 	/**
 	 * Replace mouse selected tiles(if valid) with specified tile type.
 	 * @param tile A reference of const Tile indicates the input specified Tile object. Only residential, commercial or
@@ -79,6 +174,11 @@ class City
 	 */
 	void updateTiles();
 
+	/**
+	 * Same as updateTiles, but only updates roads around the tiles replaced by the last bulldoze.
+	 */
+	void update_bulldozed_tiles();
+
 	/**
 	 * Retrieve amount of homeless people.
 	 * @return A double indicates the number of homeless people.
@@ -97,6 +197,12 @@ class City
 	 */
 	std::shared_ptr<Map> get_map_ptr() const;
 
+	/**
+	 * Retrieve the city's name.
+	 * @return A reference of const std::string indicates the name.
+	 */
+	const std::string& get_name() const;
+
 	/**
 	 * Retrieve the city's current day.
 	 * @return A unsigned integer indicates the current day.
@@ -115,6 +221,60 @@ class City
 	 */
 	void set_fund(double new_fund);
 
+	/**
+	 * Retrieve the city's seed.
+	 * @return A unsigned integer indicates the seed.
+	 */
+	unsigned int get_seed() const;
+
+	/**
+	 * Set city's new seed and regenerate tiles' update order from it. Should not be called on a journaling city since
+	 * its journal is based on the loaded seed.
+	 * @param new_seed A unsigned integer indicates the new seed.
+	 */
+	void set_seed(unsigned int new_seed);
+
+	/**
+	 * Retrieve the sequence number of the last record appended to the action journal.
+	 * @return A std::uint32_t indicates the sequence number.
+	 */
+	std::uint32_t get_journal_seq() const;
+
+	/**
+	 * Check if the action journal has grown large enough to be folded into a new snapshot.
+	 * @return A bool indicates whether the journal should be compacted.
+	 */
+	bool is_journal_full() const;
+
+	/**
+	 * Drop all journal records which have been included by a saved snapshot.
+	 * @param snapshot_seq A std::uint32_t indicates the journal sequence number of the saved snapshot.
+	 */
+	void compact_journal(std::uint32_t snapshot_seq);
+
+	/**
+	 * Finish a journal compaction prepared by ActionJournal::prepare_compaction on another thread, which only copies
+	 * the records appended since and swaps the journal file.
+	 * @param read_size A std::size_t indicates the amount of journal bytes read by the preparation.
+	 */
+	void finish_journal_compaction(std::size_t read_size);
+
+	/**
+	 * Choose how the residential pass of each day runs. The serial pass moves homeless and unemployed people into tiles
+	 * one by one in update order. The parallel pass splits the update order into fixed chunks on the JobSystem, each
+	 * chunk only drawing on its own quota of homeless and unemployed people, so its results differ from the serial
+	 * pass but only depend on the seed. A journaling city must keep the pass it was recorded with.
+	 * @param is_parallel A bool indicates whether the parallel pass is used.
+	 */
+	void set_residential_pass_parallel(bool is_parallel);
+
+	/**
+	 * Retrieve the amount of tiles updated by the last residential pass, which are all tiles for the parallel pass but
+	 * only the awake ones for the serial pass.
+	 * @return A std::size_t indicates the amount of tiles.
+	 */
+	std::size_t get_active_tiles_num() const;
+
 	/**
 	 * Retrieve the city's current population(including homeless people).
 	 * @return A double indicates the city's current population.
@@ -158,12 +318,56 @@ class City
 	float m_current_day_elapsed_time{0.f};
 	// The amount of seconds each game day should last.
  	float m_time_per_day{0.f};
+	// City's name shown inside the main menu.
+	std::string m_name;
 	// Indicates current day is the ith day of the month. We assume that each month has at most 30 days.
 	unsigned int m_day{0};
 
+	/* Seed of the city's random numbers. Each day's random numbers and the tiles' update order only depend on it, so
+	 * replaying the same actions always leads to the same city. */
+	unsigned int m_seed{0};
+	// Random number generator of the city, re-seeded at the beginning of each day.
+	std::mt19937 m_rng;
+
+	// Sequence number of the last record appended to the action journal.
+	std::uint32_t m_journal_seq{0};
+	// A std::shared_ptr<ActionJournal> indicates the journal of actions since last snapshot, nullptr when disabled.
+	std::shared_ptr<ActionJournal> m_journal_ptr;
+	/* Whether the city is newly generated or loaded from an old version's save, and thus has to be saved once
+	 * journaling starts. */
+	bool m_is_generated{false};
+	bool m_is_legacy{false};
+
 	/* Store Tile objects' indexes in ascending update order. Index specifies the order and value indicates the related
 	 * Tile object's index. */
 	std::vector<int> m_update_order_related_tile_index_vec;
+	// Indices of the tiles replaced by the last bulldoze, reused between bulldozes.
+	std::vector<int> m_bulldozed_tile_idx_vec;
+
+	// Whether each day's residential pass runs in parallel chunks instead of serially.
+	bool m_is_residential_pass_parallel{false};
+
+	// Schedules the zone tiles' level-ups, which are never saved since they can be scheduled again after loading.
+	LevelUpScheduler m_level_up_scheduler;
+	// Indices of the tiles whose level-up is newly scheduled by the serial residential pass, reused between days.
+	std::vector<int> m_scheduled_tile_idx_vec;
+	// Indices of the tiles leveled up by the last residential pass, reused between days.
+	std::vector<int> m_leveled_up_tile_idx_vec;
+	// Tiles which the serial residential pass updates, the others cannot change until they are woken.
+	ActiveTileSet m_active_tiles;
+
+	/* Result of the last full scan for a steady city within the current fast-forward. Sleeping zone tiles cannot
+	 * change, so it is kept until a day's residential pass updates any tile. */
+	bool m_is_steady_scan_valid{false};
+	// Whether every zone tile is full at its level without a pending level-up, while the population does not shrink.
+	bool m_are_zone_tiles_steady{false};
+	// Residential population of each region, which is the amount of customers of commercial tiles inside it.
+	std::unordered_map<unsigned int, unsigned int> m_steady_region_customers_map;
+	// Regions which contain any commercial tile.
+	std::unordered_set<unsigned int> m_steady_commercial_region_set;
+	// Indices of all industrial tiles, and of all commercial tiles in update order.
+	std::vector<int> m_steady_industrial_idx_vec;
+	std::vector<int> m_steady_commercial_idx_vec;
 
 	// A std::shared_ptr<Map> object indicates the pointer of game map.
 	std::shared_ptr<Map> m_map_ptr;
@@ -179,6 +383,91 @@ class City
 	 * @return A double indicates this Tile object's updated population.
 	 */
 	static double distributeResidents(double& residents_ref, Tile& tile, double rate = 0.0);
+
+	/**
+	 * Update one tile within the residential pass: zones take people from the input groups, industrial tiles extract
+	 * resource, then the tile's level-up is scheduled or cancelled. Dice rolls use the tile's own random numbers of the
+	 * day, so they do not depend on which other tiles are updated.
+	 * @param tile_index A integer indicates the tile's index.
+	 * @param homeless_ref A reference of double indicates the homeless people group residential tiles take from.
+	 * @param unemployment_ref A reference of double indicates the unemployed people group other zones hire from.
+	 * @param total_population_ref A reference of double to be increased by a residential tile's population.
+	 * @param scheduled_idx_vec A reference of vector to be appended with the tile's index if its level-up is newly
+	 * scheduled.
+	 */
+	void update_zone_tile(int tile_index, double& homeless_ref, double& unemployment_ref, double& total_population_ref,
+		std::vector<int>& scheduled_idx_vec);
+
+	/**
+	 * Put a tile just updated by the serial residential pass to sleep if it cannot change until something else does: a
+	 * residential tile at its limit while the population grows, an employing tile at its limit or without anyone to
+	 * hire and nothing to extract, or a tile which is no zone.
+	 * @param tile_index A integer indicates the tile's index.
+	 */
+	void sleep_idle_tile(int tile_index);
+
+	/**
+	 * Rebuild the serial residential pass's awake tiles from the tiles' current state, for instance after the map or
+	 * the update order is replaced. Zone tiles are woken unless they are idle.
+	 */
+	void reset_active_tiles();
+
+	/**
+	 * Run the residential pass in parallel chunks of the update order. Each chunk takes a quota of the homeless and
+	 * unemployed people in proportion to its residential and employing tiles, and what is left of the quotas is
+	 * returned into the city's groups in chunk order. Within each chunk, residential tiles first take people in update
+	 * order and then grow together through the population kernel before their level-ups are scheduled.
+	 * @return A double indicates the summed population of all residential tiles.
+	 */
+	double run_residential_pass_parallel();
+
+	/**
+	 * Advance the city by the input amount of days without journaling, stepping days until the city is steady and
+	 * skipping the rest.
+	 * @param days_num A unsigned integer indicates the amount of days to advance.
+	 */
+	void fast_forward_days(unsigned int days_num);
+
+	/**
+	 * Skip the input amount of days if the city is in a steady state, without visiting the tiles each day. The
+	 * city-wide sums are updated by the same operations as step_day in the same order, and the commercial tiles' random
+	 * revenue is only drawn on the days whose earnings are kept, the same way as step_day draws it.
+	 * @param days_num A unsigned integer indicates the amount of days to skip.
+	 * @return A bool indicates whether the city is steady and the days are skipped.
+	 */
+	bool skip_steady_days(unsigned int days_num);
+
+	/**
+	 * Scan all tiles once for a steady state of the zone tiles, and keep the result along with the regions' customers
+	 * and the commercial and industrial tiles for skip_steady_days until any tile is updated again.
+	 */
+	void scan_steady_tiles();
+
+	/**
+	 * Copy all city properties(exclude the game map) from the input snapshot.
+	 * @param snapshot A reference of const CitySnapshot object indicates the snapshot to be copied from.
+	 */
+	void restore_properties(const CitySnapshot& snapshot);
+
+	/**
+	 * Copy all city properties(exclude the game map) into the input snapshot.
+	 * @param snapshot A reference of CitySnapshot object indicates the snapshot to be filled.
+	 */
+	void take_properties_snapshot(CitySnapshot& snapshot) const;
+
+	/**
+	 * Advance the city by one day. For instance, let people move around, calculate new income, move goods around tiles
+	 * and so on.
+	 */
+	void step_day();
+
+	/**
+	 * Apply all journal records after the loaded snapshot onto the city.
+	 * @param journal A reference of ActionJournal indicates the journal to be replayed.
+	 * @param str_tile_map A reference of unordered_map indicates the mappings of each type Tile object's name and
+	 * related Tile object.
+	 */
+	void replay_journal(ActionJournal& journal, std::unordered_map<std::string, Tile>& str_tile_map);
 };
 
 #endif //CITY_HPP
\ No newline at end of file
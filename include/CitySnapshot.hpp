@@ -0,0 +1,143 @@
+#pragma once
+#ifndef CITYSNAPSHOT_HPP
+#define CITYSNAPSHOT_HPP
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+#include "TileTypeEnum.hpp"
+
+// Forward declaration.
+class SaveSlot;
+
+/**
+ * A plain copy of one Tile object's persistent data. Copying it does not touch the Tile object's sprite or animation
+ * handler.
+ */
+struct TileSnapshot
+{
+	// Tile object's tile type.
+	TileTypeEnum m_tileType{};
+	// Tile object's current level.
+	unsigned int m_level{0};
+	// Tile object's region id array.
+	unsigned int m_region_arr[1]{0};
+	// Tile object's current population.
+	double m_population{0.0};
+	// Tile object's overall production.
+	float m_total_production{0.f};
+	// Tile object's remaining underground resource.
+	std::uint8_t m_resource{0};
+	// Tile object's production per worker per day, raised by extracting resource and lowered by handing it out.
+	float m_production_per_day{0.f};
+};
+
+/**
+ * A consistent copy of all city and game map data which needs to be persisted. Once captured, it can be written into
+ * disk from any thread without accessing the live City object.
+ */
+class CitySnapshot
+{
+ public:
+	/**
+	 * Write the snapshot into the save slot. The city's record and all tiles are written into the game map file, which
+	 * is written into a temporary file first and then renamed, so a crash during the write never leaves a half written
+	 * save behind. The slot's header file is written last.
+	 * @param slot A reference of const SaveSlot indicates the save slot to be written.
+	 * @return A bool indicates whether the game map file is written successfully or not.
+	 */
+	bool save(const SaveSlot& slot) const;
+
+	/**
+	 * Read the snapshot from the save slot's game map file. Saves written by old versions keep the city's properties
+	 * inside a text city configuration file, which is imported instead.
+	 * @param slot A reference of const SaveSlot indicates the save slot to be read.
+	 * @param is_legacy A reference of bool to be set to whether the city's properties are imported from the text city
+	 * configuration file.
+	 * @return A bool indicates whether the save slot holds a complete city.
+	 */
+	bool load(const SaveSlot& slot, bool& is_legacy);
+
+	/**
+	 * Encode the city's properties into a binary record. The record starts with a field table of each property's id,
+	 * offset and size, so properties can be added later without breaking old saves.
+	 * @param record_vec A reference of vector to be filled with the record.
+	 */
+	void encode_record(std::vector<char>& record_vec) const;
+
+	/**
+	 * Decode the city's properties from a binary record. Properties of unknown ids are skipped.
+	 * @param record_vec A reference of const vector indicates the record.
+	 * @return A bool indicates whether the record is valid.
+	 */
+	bool decode_record(const std::vector<char>& record_vec);
+
+	/**
+	 * Write the snapshot into a stream, which lets other files(for instance an input trace) carry a whole city. The
+	 * city's record is written with its size first, followed by all tiles in the game map file's layout.
+	 * @param output_stream A reference of std::ostream indicates the stream to be written.
+	 */
+	void write(std::ostream& output_stream) const;
+
+	/**
+	 * Read the snapshot written by write from a stream.
+	 * @param input_stream A reference of std::istream indicates the stream to be read.
+	 * @return A bool indicates whether a complete snapshot is read.
+	 */
+	bool read(std::istream& input_stream);
+
+	/**
+	 * Export the city's properties into a human readable text file, one "name=value" line per property. Only used for
+	 * debugging.
+	 * @param cfg_path A reference of const string indicates the text file's path.
+	 * @return A bool indicates whether the file is written successfully or not.
+	 */
+	bool export_text(const std::string& cfg_path) const;
+
+	/**
+	 * Import the city's properties from a text file written by export_text or by old versions.
+	 * @param cfg_path A reference of const string indicates the text file's path.
+	 * @return A bool indicates whether the file exists.
+	 */
+	bool import_text(const std::string& cfg_path);
+
+	/**
+	 * Replace the target file with the temporary file which has already been written completely.
+	 * @param temp_path A reference of const string indicates the temporary file's path.
+	 * @param target_path A reference of const string indicates the target file's path.
+	 * @return A bool indicates whether the replacement succeeds or not.
+	 */
+	static bool commit_file(const std::string& temp_path, const std::string& target_path);
+
+	/**
+	 * Calculate a FNV-1a hash over all persisted data, two snapshots of identical cities always have the same hash.
+	 * @return A std::uint64_t indicates the hash.
+	 */
+	std::uint64_t get_hash() const;
+
+	// City's name.
+	std::string m_name;
+	// Dimension of the game map.
+	unsigned int m_width{0};
+	unsigned int m_height{0};
+	// City's properties, see City class for details.
+	unsigned int m_day{0};
+	double m_homeless_num{0};
+	double m_unemployment_num{0};
+	double m_city_population{0};
+	double m_employable{0};
+	double m_birth_rate_per_day{0};
+	double m_death_rate_per_day{0};
+	double m_residential_tax_rate{0};
+	double m_commercial_tax_rate{0};
+	double m_industrial_tax_rate{0};
+	double m_fund{0};
+	double m_curr_month_earnings{0};
+	unsigned int m_seed{0};
+	std::uint32_t m_journal_seq{0};
+	// All tiles' snapshots in map order.
+	std::vector<TileSnapshot> m_tiles_vec;
+};
+
+#endif //CITYSNAPSHOT_HPP
@@ -2,7 +2,13 @@
 #ifndef GAME_HPP
 #define GAME_HPP
 
+#include <chrono>
+#include <iosfwd>
 #include <stack>
+#include <utility>
+#include <vector>
+#include "AssetPack.hpp"
+#include "MapRenderer.hpp"
 #include "TextureManager.hpp"
 #include "Tile.hpp"
 #include "Utility.hpp"
@@ -63,6 +69,8 @@ class Game
 	constexpr static int m_tile_half_width_pixel{TILE_HALF_WIDTH};
 	// Holds each tile type's string name as key, related tile object as value.
 	std::unordered_map<std::string, Tile> m_str_tile_map;
+	// Draws the game map, holds how each type of tile looks.
+	MapRenderer m_map_renderer;
 
 	/**
 	 * Find the input specified GuiStyle object.
@@ -71,16 +79,60 @@ class Game
 	 */
 	std::shared_ptr<GuiStyle> getGuiStylePtr(const std::string& Gui_style_name) const;
 
- private:
 	/**
-	 * Load all game required textures.
+	 * Set up how all 7 types of tiles look. Their textures must have been loaded into the TextureManager.
+	 * @param map_renderer A reference of MapRenderer to be set up.
+	 * @param asset_pack_ptr A pointer of const AssetPack whose frame rects and animation tables are used instead of
+	 * the built-in ones, nullptr to use the built-in ones.
+	 */
+	static void load_map_renderer(MapRenderer& map_renderer, const AssetPack* asset_pack_ptr = nullptr);
+
+	/**
+	 * Retrieve the built-in animations of a type of tile, which the asset packer bakes into the asset pack.
+	 * @param tile_name A reference of const string indicates the tile type's string name.
+	 * @return A vector of Animation indicates the tile's animations, empty if the name is not a tile type.
 	 */
-	static void load_game_textures();
+	static std::vector<Animation> get_tile_animations(const std::string& tile_name);
 
 	/**
-	 * Create and store all 7 types of tile objects.
+	 * Retrieve the built-in size of each frame of a type of tile.
+	 * @param tile_name A reference of const string indicates the tile type's string name.
+	 * @return A sf::IntRect indicates the frame's size(only width and height are used), empty if the name is not a
+	 * tile type.
 	 */
-	void load_tiles();
+	static sf::IntRect get_tile_frame_rect(const std::string& tile_name);
+
+	/**
+	 * Retrieve the names of all game required textures.
+	 * @return A reference of const vector indicates the textures' names.
+	 */
+	static const std::vector<std::string>& get_game_texture_names();
+
+	/**
+	 * Retrieve the image files' paths of all game required textures, in the same order as their names.
+	 * @return A reference of const vector indicates the image files' paths.
+	 */
+	static const std::vector<std::string>& get_game_texture_paths();
+
+	/**
+	 * Print how long each startup step takes in milliseconds.
+	 * @param output A reference of std::ostream indicates where to print.
+	 */
+	void print_startup_trace(std::ostream& output) const;
+
+	// Path of the input trace file to be recorded while playing, empty if not recording.
+	std::string m_record_trace_path;
+	// Path of the input trace file to be replayed instead of player's input, empty if not replaying.
+	std::string m_replay_trace_path;
+	// Whether the input trace cannot be replayed from its recorded city, which makes the game exit with an error.
+	bool m_is_replay_failed{false};
+
+ private:
+	/**
+	 * Map the prebuilt asset pack file.
+	 * @return A bool indicates whether the pack is opened and holds every game required texture and font.
+	 */
+	bool open_asset_pack();
 
 	/**
 	 * Load all game required GuiStyle objects.
@@ -88,16 +140,27 @@ class Game
 	void load_Gui_styles();
 
 	/**
-	 * load all game required fonts.
+	 * load all game required fonts. Only touches the font map, so it can run in background during startup.
 	 */
 	void load_fonts();
 
+	/**
+	 * Record the time elapsed since the previous startup step.
+	 * @param step_name A reference of const string indicates the finished step's name.
+	 * @param step_time A reference of time point indicates when the step started, reset to now.
+	 */
+	void trace_startup_step(const std::string& step_name, std::chrono::steady_clock::time_point& step_time);
+
+	// The prebuilt asset pack, kept mapped since the font is loaded straight from its memory.
+	std::shared_ptr<AssetPack> m_asset_pack_ptr;
 	// A stack holds all GameState unique pointers.
 	std::stack<std::unique_ptr<GameState>> m_state_stack;
 	// An unordered map which key is a GuiStyle object's string name, value is the related GuiStyle object's pointer.
 	std::unordered_map<std::string, std::shared_ptr<GuiStyle>> m_str_GuiStyle_ptr_map;
 	// An unordered map which key is a sf::font object's string name, value is the related font object's pointer.
 	std::unordered_map<std::string, std::shared_ptr<sf::Font>> m_str_font_ptr_map;
+	// Each startup step's name and the time it takes in milliseconds, in the order they finish.
+	std::vector<std::pair<std::string, double>> m_startup_trace_vec;
 };
 
 #endif // GAME_HPP
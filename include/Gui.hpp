@@ -4,6 +4,7 @@
 
 #include "GuiEntry.hpp"
 #include "GuiStyle.hpp"
+#include <initializer_list>
 #include <vector>
 
 /**
@@ -60,7 +61,9 @@
 	sf::Vector2f get_gui_size() const;
 
 	/**
-	 * If one GuiEntry object is hovered over by mouse, returns its index. Otherwise, return -1.
+	 * If one GuiEntry object is hovered over by mouse, returns its index. Otherwise, return -1. GuiEntry objects are
+	 * laid out in one row or column of the same size, so only the one under the mouse is checked against its bounds
+	 * cached by show.
 	 * @param mouse_pos A reference of const sf::Vector2f object indicates mouse position in the screen coordinates for
 	 * the sf::View object that the Gui is displayed on.
 	 * @return A non-negative integer indicates the index of current hovered GuiEntry object or -1 if no GuiEntry
@@ -75,6 +78,18 @@
 	 */
 	void set_gui_entry_text(int entry_idx, const std::string& entry_text);
 
+	/**
+	 * Bind entry_idxth GuiEntry object's text to the values formatted by a printf style format. The text is only
+	 * formatted again if the format or any value differs from the last call, and it is formatted into the GuiEntry
+	 * object's own buffer. So calling it every frame allocates nothing while the values are unchanged.
+	 * @param entry_idx An integer indicates the specified GuiEntry object's index(may be invalid).
+	 * @param format A pointer of const char indicates the format, which must outlive the Gui object. Each value is
+	 * passed as a double.
+	 * @param value_list A std::initializer_list indicates at most GUI_ENTRY_BOUND_VALUES_NUM values.
+	 * @return A bool indicates whether the text is formatted again.
+	 */
+	bool set_gui_entry_values(int entry_idx, const char* format, std::initializer_list<double> value_list);
+
 	/**
 	 * Modify each GuiEntry object's dimension(width and height).
 	 * @param dimension A reference of sf::Vector2f object indicates each GuiEntry object's dimension.
@@ -82,7 +97,8 @@
 	void set_each_gui_entry_dimension(const sf::Vector2f& dimension);
 
 	/**
-	 * Override function from sf::Drawable. Draw the object to a render target.
+	 * Override function from sf::Drawable. Draw the object to a render target. All GuiEntry objects' shapes are drawn
+	 * with one draw call and all their texts with another one, from vertices cached until any GuiEntry object changes.
 	 * @param render_target A reference of sf::RenderTarget object indicates render target to draw to.
 	 * @param render_states A sf::RenderStates object indicates current render states.
 	 */
@@ -99,11 +115,20 @@
 	void hide();
 
 	/**
-	 * Highlight specified GuiEntry object.
+	 * Highlight specified GuiEntry object. Only the previously and newly highlighted GuiEntry objects are recolored.
 	 * @param entry_idx An integer indicates the index of specified GuiEntry object. -1 means not highlighted.
 	 */
 	void highlight_entry(int entry_idx);
 
+	/**
+	 * Highlight the GuiEntry object hovered over by mouse. Should be called when the mouse moves or the Gui is shown.
+	 * @param mouse_pos A reference of const sf::Vector2f object indicates mouse position in the screen coordinates for
+	 * the sf::View object that the Gui is displayed on.
+	 * @return A non-negative integer indicates the index of current hovered GuiEntry object or -1 if no GuiEntry
+	 * object is hovered over.
+	 */
+	int highlight_hovered_entry(const sf::Vector2f& mouse_pos);
+
 	/**
 	 * Return the activated message of specified GuiEntry object if exist. Otherwise, return "NULL".
 	 * @param entry_idx An integer indicates the index of specified GuiEntry object if exist. -1 means such
@@ -134,6 +159,25 @@
 	unsigned int get_entry_size() const;
 
   private:
+	/**
+	 * Rebuild the cached vertices of all GuiEntry objects' shapes and texts if any of them changed since the last
+	 * build.
+	 */
+	void update_vertices() const;
+
+	/**
+	 * Cache each GuiEntry object's bounds in the screen coordinates for the sf::View object that the Gui is displayed
+	 * on.
+	 */
+	void update_entry_bounds();
+
+	/**
+	 * Color specified GuiEntry object with the highlighted or normal colors, and recolor its cached vertices in place.
+	 * @param entry_idx An integer indicates the index of specified GuiEntry object(may be invalid).
+	 * @param is_highlighted A bool indicates whether to use the highlighted colors.
+	 */
+	void color_entry(int entry_idx, bool is_highlighted);
+
 	// A vector of multiple GuiEntry objects.
 	std::vector<GuiEntry> m_Gui_entry_vec;
 	// A bool indicates if the Gui should be visible or not.
@@ -146,6 +190,20 @@
 	sf::Vector2f m_entry_shape_dimension;
 	// Margin that surrounds the text to stop it from overlapping the edges in pixels.
 	unsigned int m_text_padding{0};
+	// Index of the highlighted GuiEntry object, -1 means not highlighted.
+	int m_highlighted_entry_idx{-1};
+	// Each GuiEntry object's bounds cached by show, used for hit testing.
+	std::vector<sf::FloatRect> m_entry_bounds_vec;
+	// Vertices of all GuiEntry objects' shapes(fill and outline) in GuiEntry objects' order.
+	mutable sf::VertexArray m_shape_vertex_arr{sf::Triangles};
+	// Vertices of all GuiEntry objects' texts' glyphs, textured by the font's glyph texture.
+	mutable sf::VertexArray m_text_vertex_arr{sf::Triangles};
+	/* Index of each GuiEntry object's first shape and text vertex, followed by the total amount of vertices, so a
+	 * single GuiEntry object's vertices can be recolored without rebuilding. */
+	mutable std::vector<std::size_t> m_entry_shape_vertex_idx_vec;
+	mutable std::vector<std::size_t> m_entry_text_vertex_idx_vec;
+	// Whether any GuiEntry object changed since the vertices were built.
+	mutable bool m_is_vertices_dirty{true};
 };
 
 #endif //GUI_HPP
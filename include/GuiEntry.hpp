@@ -5,6 +5,7 @@
 #include "SFML/Graphics.hpp"
 #include <string>
 #include <utility>
+#include "Utility.hpp"
 
 /**
  * This class represents the entry part of the GUI.
@@ -32,5 +33,11 @@ class GuiEntry
 	sf::RectangleShape m_entry_shape;
 	// A sf::Text object indicates each GuiEntry object's content displayed on the Gui entry scene.
  	sf::Text m_text;
+	// The format which the text is bound to, nullptr if the text is not bound to values.
+	const char* m_bound_format{nullptr};
+	// Values which the text is currently formatted from, so that it is only formatted again when they change.
+	double m_bound_value_arr[GUI_ENTRY_BOUND_VALUES_NUM]{};
+	// Buffer which the bound values are formatted into, reused by every format.
+	char m_text_buffer_arr[GUI_ENTRY_TEXT_BUFFER_SIZE]{};
 };
 #endif //GUIENTRY_HPP
@@ -0,0 +1,218 @@
+#pragma once
+#ifndef JOBSYSTEM_HPP
+#define JOBSYSTEM_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Utility.hpp"
+
+/**
+ * Counts the unfinished jobs submitted with it, so that they can be waited for together.
+ */
+class JobGroup
+{
+ public:
+	/**
+	 * Check whether all jobs submitted with this group are finished.
+	 * @return A bool indicates whether they are finished.
+	 */
+	bool is_done() const
+	{
+		return m_pending_num.load(std::memory_order_acquire) == 0;
+	};
+
+ private:
+	friend class JobSystem;
+	// Amount of submitted but unfinished jobs.
+	std::atomic<std::size_t> m_pending_num{0};
+};
+
+/**
+ * A work-stealing thread pool. Each thread has its own job queue: it takes its newest job first, and once its own queue
+ * is empty it steals the oldest job of another queue. Threads which wait for jobs run queued jobs meanwhile, so jobs
+ * may submit and wait for further jobs without any deadlock. Jobs submitted by threads outside the pool share one queue.
+ */
+class JobSystem
+{
+ public:
+	/**
+	 * One parameter constructor. Start the worker threads.
+	 * @param threads_num A unsigned integer indicates the amount of threads running jobs, including the thread which
+	 * waits for them, so threads_num - 1 worker threads are started. Default value is the hardware concurrency.
+	 */
+	explicit JobSystem(unsigned int threads_num = std::thread::hardware_concurrency());
+
+	/**
+	 * Destructor. Finish all queued jobs and join the worker threads.
+	 */
+	~JobSystem();
+
+	/**
+	 * Deleted copy constructor since the worker threads cannot be copied.
+	 */
+	JobSystem(const JobSystem&) = delete;
+	/**
+	 * Deleted copy assignment operator since the worker threads cannot be copied.
+	 */
+	JobSystem& operator=(const JobSystem&) = delete;
+
+	/**
+	 * Retrieve the job system shared by the whole game, which is sized from the hardware concurrency on the first call.
+	 * @return A std::shared_ptr<JobSystem> points to the shared job system.
+	 */
+	static std::shared_ptr<JobSystem> getInstance();
+
+	/**
+	 * Retrieve the amount of threads running jobs, including the waiting thread.
+	 * @return A unsigned integer indicates the amount.
+	 */
+	unsigned int get_threads_num() const;
+
+	/**
+	 * Queue one job.
+	 * @param job_func A std::function indicates the job.
+	 * @param group A reference of JobGroup which counts the job until it is finished.
+	 */
+	void submit(std::function<void()> job_func, JobGroup& group);
+
+	/**
+	 * Run queued jobs until all jobs of the group are finished.
+	 * @param group A reference of JobGroup indicates the jobs to wait for.
+	 */
+	void wait(JobGroup& group);
+
+	/**
+	 * Split the index range into chunks and run the function on each chunk in parallel, then wait for all of them.
+	 * @param begin A std::size_t indicates the first index.
+	 * @param end A std::size_t indicates the index past the last one.
+	 * @param grain_size A std::size_t indicates the minimum amount of indices of each chunk, zero to split the range
+	 * into JOB_SYSTEM_CHUNKS_PER_THREAD chunks per thread.
+	 * @param func A reference of const std::function which processes the indices of [chunk begin, chunk end).
+	 */
+	void parallel_for(std::size_t begin, std::size_t end, std::size_t grain_size,
+		const std::function<void(std::size_t, std::size_t)>& func);
+
+	/**
+	 * Reduce the index range in parallel with a result which does not depend on the amount of threads or on which
+	 * thread runs which chunk. The range is split into chunks of the fixed size, each chunk is mapped into a partial
+	 * result, and the partial results are combined in chunk order on the calling thread.
+	 * @param begin A std::size_t indicates the first index.
+	 * @param end A std::size_t indicates the index past the last one.
+	 * @param chunk_size A std::size_t indicates the amount of indices of each chunk(the last one may be smaller).
+	 * @param identity A T indicates the result of an empty range, which each combination starts from.
+	 * @param map_func A MapFunc which returns the partial result T of the indices of [chunk begin, chunk end).
+	 * @param combine_func A CombineFunc which returns the combination T of two results, earlier chunks first.
+	 * @return A T indicates the combined result.
+	 */
+	template <typename T, typename MapFunc, typename CombineFunc>
+	T parallel_reduce(std::size_t begin, std::size_t end, std::size_t chunk_size, T identity, MapFunc map_func,
+		CombineFunc combine_func)
+	{
+		if (end <= begin)
+			return identity;
+		chunk_size = std::max(chunk_size, static_cast<std::size_t>(1));
+		const std::size_t chunks_num = (end - begin + chunk_size - 1) / chunk_size;
+		std::vector<T> partial_results_vec(chunks_num, identity);
+		this->parallel_for(0, chunks_num, 1, [&](std::size_t chunk_begin, std::size_t chunk_end)
+		{
+			for (std::size_t chunk_idx = chunk_begin; chunk_idx < chunk_end; ++chunk_idx)
+			{
+				const std::size_t idx = begin + chunk_idx * chunk_size;
+				partial_results_vec[chunk_idx] = map_func(idx, std::min(idx + chunk_size, end));
+			}
+		});
+
+		T result(identity);
+		for (const auto& partial_result : partial_results_vec)
+			result = combine_func(result, partial_result);
+		return result;
+	};
+
+ private:
+	/**
+	 * One queued job and the group counting it.
+	 */
+	struct Job
+	{
+		std::function<void()> m_func;
+		JobGroup* m_group_ptr{nullptr};
+	};
+
+	/**
+	 * One thread's job queue.
+	 */
+	struct JobQueue
+	{
+		std::mutex m_mutex;
+		std::deque<Job> m_jobs_deque;
+	};
+
+	// Queue 0 is shared by all threads outside the pool, queue i is owned by worker thread i.
+	std::vector<std::unique_ptr<JobQueue>> m_queues_vec;
+	std::vector<std::thread> m_workers_vec;
+	// Amount of queued jobs which no thread has taken yet.
+	std::atomic<std::size_t> m_queued_jobs_num{0};
+	// Wakes sleeping worker threads when jobs are queued or the pool stops.
+	std::mutex m_wake_mutex;
+	std::condition_variable m_wake_cv;
+	bool m_is_stopping{false};
+
+	/**
+	 * Take one job, from the own queue's newest end first and then from other queues' oldest end, and run it.
+	 * @param queue_idx A unsigned integer indicates the calling thread's own queue.
+	 * @return A bool indicates whether any job was run.
+	 */
+	bool try_run_job(unsigned int queue_idx);
+
+	/**
+	 * Run jobs until the pool stops, sleeping while no job is queued.
+	 * @param queue_idx A unsigned integer indicates the worker thread's own queue.
+	 */
+	void worker_loop(unsigned int queue_idx);
+};
+
+/**
+ * A graph of tasks where each task runs only after all tasks it depends on are finished. Tasks without dependencies
+ * between each other run in parallel.
+ */
+class TaskGraph
+{
+ public:
+	/**
+	 * Add one task. It can only depend on tasks added before it, so the graph never has a cycle.
+	 * @param task_func A std::function indicates the task.
+	 * @param dependency_idx_vec A reference of const vector indicates the indices of the tasks it depends on.
+	 * @return A std::size_t indicates the task's index.
+	 */
+	std::size_t add_task(std::function<void()> task_func, const std::vector<std::size_t>& dependency_idx_vec = {});
+
+	/**
+	 * Run all tasks in dependency order and wait for them. The graph can be run again afterwards.
+	 * @param job_system A reference of JobSystem which runs the tasks.
+	 */
+	void run(JobSystem& job_system);
+
+ private:
+	/**
+	 * One task and the tasks depending on it.
+	 */
+	struct Task
+	{
+		std::function<void()> m_func;
+		std::size_t m_dependencies_num{0};
+		std::vector<std::size_t> m_successor_idx_vec;
+	};
+
+	// All tasks in adding order.
+	std::vector<Task> m_tasks_vec;
+};
+
+#endif //JOBSYSTEM_HPP
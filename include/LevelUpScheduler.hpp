@@ -0,0 +1,104 @@
+#pragma once
+#ifndef LEVELUPSCHEDULER_HPP
+#define LEVELUPSCHEDULER_HPP
+
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <vector>
+#include "Tile.hpp"
+#include "Utility.hpp"
+
+/**
+ * Schedules zone tiles' level-ups as events on the day they happen, instead of rolling a dice for each ready tile each
+ * day. Whether a ready tile levels up on a day is decided by the tile's random number of the day for its level, which
+ * gives the same chance as the dice roll. Once a tile becomes ready, its first successful day is found
+ * right away and queued. Finding it again from any later day gives the same day, so a city loaded from a snapshot
+ * schedules exactly the same level-ups as the city which saved it, although the queued events are never saved.
+ */
+class LevelUpScheduler
+{
+ public:
+	/**
+	 * Drop all events and resize the per-tile state to the map's amount of tiles.
+	 * @param tiles_num A std::size_t indicates the amount of tiles.
+	 */
+	void reset(std::size_t tiles_num);
+
+	/**
+	 * Schedule or cancel the tile's level-up according to whether it is ready on the day. A ready tile which has no
+	 * level-up yet gets its day assigned but not queued, so different tiles can be refreshed from different threads.
+	 * @param tile_index A integer indicates the tile's index.
+	 * @param tile A reference of const Tile indicates the tile.
+	 * @param day A unsigned integer indicates the current day.
+	 * @param seed A unsigned integer indicates the city's seed.
+	 * @return A bool indicates whether a level-up day was newly assigned and has to be queued by push_events.
+	 */
+	bool refresh_tile(int tile_index, const Tile& tile, unsigned int day, unsigned int seed);
+
+	/**
+	 * Cancel the tile's level-up, for instance because the tile is replaced.
+	 * @param tile_index A integer indicates the tile's index.
+	 */
+	void cancel_tile(int tile_index);
+
+	/**
+	 * Queue the level-ups newly assigned by refresh_tile.
+	 * @param tile_idx_vec A reference of const vector indicates the tiles' indices.
+	 */
+	void push_events(const std::vector<int>& tile_idx_vec);
+
+	/**
+	 * Level up all tiles whose level-up is due on or before the day. Only due events are visited, never the whole map.
+	 * @param day A unsigned integer indicates the current day.
+	 * @param tiles_vec A reference of vector indicates the game map's tiles.
+	 * @param fired_idx_vec A reference of vector to be appended with the indices of the tiles leveled up.
+	 * @return A std::size_t indicates the amount of tiles leveled up.
+	 */
+	std::size_t fire_due_events(unsigned int day, std::vector<Tile>& tiles_vec, std::vector<int>& fired_idx_vec);
+
+	/**
+	 * Retrieve the amount of queued events, including cancelled ones which have not been dropped yet.
+	 * @return A std::size_t indicates the amount.
+	 */
+	std::size_t get_events_num() const;
+
+ private:
+	/**
+	 * One queued level-up.
+	 */
+	struct LevelUpEvent
+	{
+		// Day the tile levels up.
+		unsigned int m_day{0};
+		// Index of the tile.
+		int m_tile_index{0};
+
+		/**
+		 * Order events so that the earliest one is on top of the queue, ties broken by the tile's index.
+		 * @param other A reference of const LevelUpEvent indicates the event compared with.
+		 * @return A bool indicates whether this event happens after the other one.
+		 */
+		bool operator>(const LevelUpEvent& other) const
+		{
+			return m_day != other.m_day ? m_day > other.m_day : m_tile_index > other.m_tile_index;
+		};
+	};
+
+	// Queued events, the earliest on top. Cancelled events stay queued until due and are skipped then.
+	std::priority_queue<LevelUpEvent, std::vector<LevelUpEvent>, std::greater<LevelUpEvent>> m_events_queue;
+	// Each tile's level-up day, LEVEL_UP_NO_EVENT_DAY if the tile has none.
+	std::vector<unsigned int> m_due_day_vec;
+
+	/**
+	 * Check if a ready tile levels up on the day.
+	 * @param tile_index A integer indicates the tile's index.
+	 * @param tile A reference of const Tile indicates the tile.
+	 * @param day A unsigned integer indicates the day.
+	 * @param seed A unsigned integer indicates the city's seed.
+	 * @return A bool indicates whether the tile levels up.
+	 */
+	static bool is_level_up_day(int tile_index, const Tile& tile, unsigned int day, unsigned int seed);
+};
+
+#endif //LEVELUPSCHEDULER_HPP
@@ -6,27 +6,26 @@
 #include "GameActionEnum.hpp"
 #include "Map.hpp"
 #include "Gui.hpp"
+#include "ActionTrace.hpp"
+#include "SaveSlot.hpp"
 
 // Forward declaration.
 class City;
+class AutoSaver;
 
 /**
  * This class inherits from the virtual base GameState class and represents the main game state.
  */
 class MainGameState : public GameState
 {
-	/**
- 	* A friend function to transform input TileTypeEnum into related string.
- 	* @param tile_type A TileTypeEnum object indicates the input TileTypeEnum.
- 	* @return A std::string indicates the related string.
- 	*/
-	friend std::string tileTypeToStr(TileTypeEnum tile_type);
  public:
 	/**
 	 * Constructor of MainGameState class.
 	 * @param game_ptr A std::unique_ptr<Game> object indicates the pointer of game object.
+	 * @param city_ptr A std::shared_ptr<City> indicates the pointer of the loaded city.
+	 * @param slot A reference of const SaveSlot indicates the save slot which the city is loaded from and saved into.
 	 */
-	explicit MainGameState(const std::shared_ptr<Game>& game_ptr);
+	MainGameState(const std::shared_ptr<Game>& game_ptr, std::shared_ptr<City> city_ptr, const SaveSlot& slot);
 
 	/**
 	 * Virtual destructor.
@@ -59,6 +58,8 @@ class MainGameState : public GameState
 	GameActionEnum m_action_state;
 	// A std::shared_ptr<City> indicates the pointer of game 's city(which contains a Map object inside).
 	std::shared_ptr<City> m_game_city_ptr;
+	// The save slot which the city is loaded from and saved into.
+	SaveSlot m_slot;
 	/* Keep track of mouse screen position since last camera panning event. When player presses mouse middle button and
 	 * moves mouse at the same time, the world(game view) should also move towards the opposite direction and this
 	 * position should be updated. */
@@ -74,8 +75,40 @@ class MainGameState : public GameState
 	// A pointer of player's current selected tile object.
 	std::shared_ptr<Tile> m_curr_selected_tile_ptr;
 
-	// A std::unordered_map where each Gui object's string name is the key, related Gui object is the value.
-	std::unordered_map<std::string, Gui> m_str_gui_map;
+	// Pointers of the right click menu, the select cost text and the information bar Gui objects.
+	std::shared_ptr<Gui> m_menu_gui_ptr;
+	std::shared_ptr<Gui> m_select_cost_text_gui_ptr;
+	std::shared_ptr<Gui> m_info_bar_gui_ptr;
+	// All Gui objects in drawing order, so rendering each frame does not look them up by name.
+	std::vector<std::shared_ptr<Gui>> m_gui_ptr_vec;
+
+	// A std::shared_ptr<AutoSaver> indicates the pointer of the city's periodic background saver, nullptr when replaying.
+	std::shared_ptr<AutoSaver> m_autosaver_ptr;
+
+	// A std::shared_ptr<TraceRecorder> indicates the pointer of player's input recorder, nullptr when not recording.
+	std::shared_ptr<TraceRecorder> m_trace_recorder_ptr;
+	// A std::shared_ptr<TracePlayer> indicates the pointer of the replayed input trace, nullptr when not replaying.
+	std::shared_ptr<TracePlayer> m_trace_player_ptr;
+	// Zoom and pan records of the replayed frame, reused between frames.
+	std::vector<TraceRecord> m_view_records_vec;
+
+	/**
+	 * Replay the next frame of the input trace instead of player's input. Close the game window once the trace ends.
+	 */
+	void replay_frame();
+
+	/**
+	 * Store the tile object of the specified name as current selected tile and show it inside the information bar.
+	 * @param tile_name A reference of const std::string indicates the tile object's name.
+	 */
+	void set_curr_selected_tile(const std::string& tile_name);
+
+	/**
+	 * Pan the camera or move the selected rectangle according to player's current action, then update the right click
+	 * menu's hovered GuiEntry object. Called at most once per frame with the last mouse position.
+	 * @param mouse_screen_pos A reference of const sf::Vector2i indicates the mouse position relative to the window.
+	 */
+	void apply_mouse_move(const sf::Vector2i& mouse_screen_pos);
 };
 
 #endif //MAINGAMESTATE_HPP
@@ -2,10 +2,14 @@
 #ifndef MAINMENUGAMESTATE_HPP
 #define MAINMENUGAMESTATE_HPP
 
+#include <atomic>
+#include <future>
 #include "GameState.hpp"
+#include "SaveSlot.hpp"
 
 // Forward declaration.
 class Gui;
+class City;
 
 /**
  * This class inherits from the virtual base GameState class and represents the main menu game state.
@@ -14,15 +18,15 @@ class MainMenuGameState : public GameState
 {
  public:
 	/**
-	 * Constructor of MainMenuGameState class.
+	 * Constructor of MainMenuGameState class. List all used save slots by reading their header files only.
 	 * @param game_ptr A std::shared_ptr<Game> object indicates the pointer of game object.
 	 */
 	explicit MainMenuGameState(std::shared_ptr<Game> game_ptr);
 
 	/**
- 	 * Virtual destructor.
+ 	 * Virtual destructor. Cancel the preloading city if it is still loading, so that waiting for it is short.
  	 */
-	virtual ~MainMenuGameState() = default;
+	virtual ~MainMenuGameState();
 
 	/**
 	* Render the related scene according to delta time.
@@ -31,7 +35,7 @@ class MainMenuGameState : public GameState
 	virtual void render(const float dt) override;
 
 	/**
-	 * Update the related scene according to delta time.
+	 * Update the related scene according to delta time. Switch to the main game once the chosen city is loaded.
 	 * @param dt A const float value indicates the delta time.
 	 */
 	virtual void update(const float dt) override;
@@ -43,14 +47,78 @@ class MainMenuGameState : public GameState
 
  private:
 	/**
-	* Load the main game.
+	* Start loading the city of the specified save slot in background. The preloaded city is taken over instead if it is
+	* from the same save slot.
+	* @param slot_idx A unsigned integer indicates the save slot's index.
+	* @param entry_idx An integer indicates the index of clicked GuiEntry object, which shows the loading progress.
 	*/
-	void loadGame();
+	void loadGame(unsigned int slot_idx, int entry_idx);
+
+	/**
+	 * Start preloading the city of the GuiEntry object in background without journaling, so it can be played right
+	 * away once it is chosen.
+	 * @param entry_idx An integer indicates the index of the GuiEntry object.
+	 */
+	void preload_city(int entry_idx);
+
+	/**
+	 * Cancel the preloading city because another city is chosen and hide its progress. The background thread stops at
+	 * its next loading step, and the incomplete city is released once it has stopped.
+	 */
+	void cancel_preload();
+
+	/**
+	 * Show the preloading progress on the preloading Gui object.
+	 */
+	void update_preload_progress();
+
+	/**
+	 * Find the save slot related to the GuiEntry object.
+	 * @param entry_idx An integer indicates the index of the GuiEntry object.
+	 * @param slot_idx A reference of unsigned integer to be filled with the save slot's index.
+	 * @return A bool indicates whether the GuiEntry object loads a save slot or creates a new city.
+	 */
+	bool get_entry_slot_idx(int entry_idx, unsigned int& slot_idx) const;
+
+	/**
+	 * Show the thumbnail of the save slot related to the hovered GuiEntry object.
+	 * @param entry_idx An integer indicates the index of hovered GuiEntry object. -1 means no GuiEntry is hovered.
+	 */
+	void show_thumbnail(int entry_idx);
 
 	// A sf::View object indicates the main menu's view.
 	sf::View m_view;
 
 	// A std::unordered_map that key is each Gui object's string name, value
 	std::unordered_map<std::string, std::shared_ptr<Gui>>m_str_Gui_map;
+
+	// Headers of all used save slots, in the same order as the save slot GuiEntry objects.
+	std::vector<SaveSlotHeader> m_slot_headers_vec;
+	// Index of the GuiEntry object whose thumbnail is shown, -1 if none.
+	int m_thumbnail_entry_idx{-1};
+	// Thumbnail of the hovered save slot.
+	sf::Image m_thumbnail_image;
+	sf::Texture m_thumbnail_texture;
+	sf::Sprite m_thumbnail_sprite;
+	bool m_is_thumbnail_visible{false};
+
+	// The save slot which is being loaded.
+	SaveSlot m_loading_slot;
+	// The city which is being loaded by the background thread, invalid if no city is being loaded.
+	std::future<std::shared_ptr<City>> m_city_future;
+	// Whether the city being loaded is the preloaded one, which starts journaling only once it is chosen.
+	bool m_is_preloaded_city{false};
+
+	// The save slot and name of the preloaded city.
+	SaveSlot m_preload_slot;
+	std::string m_preload_name;
+	// The city which is being preloaded by the background thread, invalid if it is taken over or never preloaded.
+	std::future<std::shared_ptr<City>> m_preload_future;
+	// Loading progress in percent of the preloaded city, set by the background thread.
+	std::shared_ptr<std::atomic<unsigned int>> m_preload_progress_ptr;
+	// Set to cancel preloading the city, checked by the background thread between its loading steps.
+	std::shared_ptr<std::atomic<bool>> m_preload_cancel_ptr;
+	// The progress in percent shown on the preloading Gui object, -1 if nothing is shown yet.
+	int m_shown_preload_progress{-1};
 };
 #endif // MAINMENUGAMESTATE_HPP
@@ -2,10 +2,14 @@
 #ifndef MAP_HPP
 #define MAP_HPP
 
+#include <cstdint>
+#include <SFML/System/Vector2.hpp>
 #include "Tile.hpp"
 #include "Utility.hpp"
+#include "CitySnapshot.hpp"
 #include <unordered_map>
 #include <string>
+#include <vector>
 
 /**
  * This class contains a vector of Tile objects which is responsible for all game map behaviors.
@@ -37,8 +41,21 @@ class Map
 	 * @param height An unsigned integer indicates the height of map.
 	 * @param str_tile_map A reference of unordered_map indicates contains mapping from each tile's name to relater tile
 	 * object.
+	 * @return A bool indicates whether the map is loaded from the file(true) or newly generated(false).
 	 */
-	void load(const std::string& file_name, unsigned int width, unsigned int height,
+	bool load(const std::string& file_name, unsigned int width, unsigned int height,
+		std::unordered_map<std::string, Tile>& str_tile_map);
+
+	/**
+	 * Create the map from tiles' snapshots, or generate a new map if there are not exactly width x height snapshots.
+	 * @param tiles_vec A reference of const vector indicates all tiles' snapshots in map order.
+	 * @param width An unsigned integer indicates the width of map.
+	 * @param height An unsigned integer indicates the height of map.
+	 * @param str_tile_map A reference of unordered_map indicates contains mapping from each tile's name to relater tile
+	 * object.
+	 * @return A bool indicates whether the map is created from the snapshots(true) or newly generated(false).
+	 */
+	bool load(const std::vector<TileSnapshot>& tiles_vec, unsigned int width, unsigned int height,
 		std::unordered_map<std::string, Tile>& str_tile_map);
 
 	/**
@@ -49,18 +66,38 @@ class Map
 	void save(const std::string& file_name);
 
 	/**
-	 * Render the map.
-	 * @param renderWindow A reference of a sf::RenderWindow object indicates the render window.
-	 * @param dt A float indicates the elapsed time since last call.
+	 * Copy each Tile object's persistent data into the input vector in map order. The vector's capacity is reused.
+	 * @param tiles_vec A reference of vector indicates the tile snapshots to be filled.
+	 */
+	void take_snapshot(std::vector<TileSnapshot>& tiles_vec) const;
+
+	/**
+	 * Bring the tile snapshots last updated by this function up to date, copying only the chunks whose tiles changed
+	 * since then. All tiles are copied if the vector does not hold exactly this map's tiles. Only one vector can be
+	 * kept up to date this way, since the changed chunks are forgotten once they are copied.
+	 * @param tiles_vec A reference of vector indicates the tile snapshots to be updated.
+	 */
+	void update_snapshot(std::vector<TileSnapshot>& tiles_vec);
+
+	/**
+	 * Mark the chunk of the tile changed, so the next update_snapshot call copies it. Must be called for each tile
+	 * whose persistent data is changed through get_tile_ref or get_tiles_vec_ref, and never from several threads.
+	 * @param idx An integer indicates the index of the tile.
 	 */
-	void render(sf::RenderWindow& renderWindow, float dt);
+	void mark_tile_changed(int idx);
+
+	/**
+	 * Mark all chunks changed, so the next update_snapshot call copies the whole map.
+	 */
+	void mark_all_tiles_changed();
 
 	/**
 	 * Checks if one position in the map is connected to another by only traversing tiles in the whitelist.
 	 * @param region_tiles_type_vec A reference of const vector contains all different TileTypes that can make up the
 	 * regions(ROAD, RESIDENTIAL, COMMERCIAL, INDUSTRIAL).
 	 * @param region_index An unsigned integer indicates the index of region(also index of Tile class's member
-	 * m_region_arr). Default value is 0. A certain region can have tiles of different tile types.
+	 * m_region_arr). Default value is 0. A certain region can have tiles of different tile types. Regions keep their
+	 * previous ids unless they are split or merged.
 	 */
 	void calculateConnectedRegionsNum(const std::vector<TileTypeEnum>& region_tiles_type_vec, unsigned int region_index
 	= 0);
@@ -72,8 +109,17 @@ class Map
 	void updateDirection(TileTypeEnum tileType);
 
 	/**
-	 * Selects all tiles within the bounding rectangle of start_pos and end_pos and sets all tiles within that rectangle
-	 * which are also in the blacklist to invalid condition.
+	 * Update the direction of directional tiles around the changed tiles only. A tile's direction only depends on its
+	 * adjacent tiles, so the tiles within the changed tiles' bounding rectangle grown by one tile are enough.
+	 * @param tileType A TileTypeEnum object indicates the type of tile object.
+	 * @param changed_idx_vec A reference of const vector indicates the indices of the changed tiles.
+	 */
+	void updateDirection(TileTypeEnum tileType, const std::vector<int>& changed_idx_vec);
+
+	/**
+	 * Replace the selection with all tiles within the bounding rectangle of start_pos and end_pos, where tiles within
+	 * that rectangle which are also in the blacklist are in invalid condition. The selection is only stored as the
+	 * rectangle and the blacklist, so selecting takes constant time however large the rectangle is.
 	 * @param start_pos A reference of sf::Vector2i indicates the smaller position on map indicates the top left corner
 	 * of the bounding rectangle.
 	 * @param end_pos A reference of sf::Vector2i indicates bigger position on map indicates the bottom right corner of
@@ -88,6 +134,29 @@ class Map
 	 */
 	void deselect_tiles();
 
+	/**
+	 * Replace all selected tiles with the input tile in place, visiting only the selected rectangle in map order.
+	 * @param new_tile A reference of const Tile object indicates the tile which all selected tiles are replaced with.
+	 * @param homeless_num A reference of double increased by each replaced residential tile's population.
+	 * @param unemployment_num A reference of double increased by each replaced commercial or industrial tile's
+	 * population.
+	 * @param changed_idx_vec A reference of vector to be filled with the replaced tiles' indices in map order.
+	 */
+	void replace_selected_tiles(const Tile& new_tile, double& homeless_num, double& unemployment_num,
+		std::vector<int>& changed_idx_vec);
+
+	/**
+	 * Retrieve the top left corner of the last selected rectangle(already sorted and clamped).
+	 * @return A sf::Vector2i indicates the top left corner.
+	 */
+	sf::Vector2i get_selected_start_pos() const;
+
+	/**
+	 * Retrieve the bottom right corner of the last selected rectangle(already sorted and clamped).
+	 * @return A sf::Vector2i indicates the bottom right corner.
+	 */
+	sf::Vector2i get_selected_end_pos() const;
+
 	/**
 	 * Retrieve the map's width.
 	 * @return A unsigned integer indicates the map's width.
@@ -135,7 +204,15 @@ class Map
 	Tile& get_tile_ref(int idx);
 
 	/**
-	 * Set specified Tile object to be identical with input Tile object.
+	 * Get specified Tile object's const reference.
+	 * @param idx An integer indicates the index of the tile.
+	 * @return A reference of specified const Tile object.
+	 */
+	const Tile& get_tile_ref(int idx) const;
+
+	/**
+	 * Set specified Tile object to be identical with input Tile object. Tile objects' types must only be changed by
+	 * this function, so that the grass summed-area table of the tile's chunk stays up to date.
 	 * @param idx An integer indicates the index of the tile.
 	 * @param new_tile A reference of const Tile object indicates the input Tile object.
 	 */
@@ -155,7 +232,7 @@ class Map
 	unsigned int get_tile_resource(int idx) const;
 
 	/**
-	 * Decrement related Tile object's resource by one.
+	 * Decrement related Tile object's resource by one if there is still resource left.
 	 * @param idx An integer indicates the index of the tile.
 	 */
 	void decrement_tile_resource(int idx);
@@ -167,7 +244,9 @@ class Map
 	std::vector<Tile>& get_tiles_vec_ref();
 
 	/**
-	 * Retrieve the amount of Tile objects that selected by player.
+	 * Retrieve the amount of Tile objects that selected by player. Building and bulldozing selections are counted from
+	 * the grass summed-area tables, so the time only grows with the amount of chunks along the rectangle's border.
+	 * Selections with any other blacklist are counted tile by tile.
 	 * @return A unsigned integer indicates the amount.
 	 */
 	unsigned int get_selected_tiles_num() const;
@@ -179,17 +258,85 @@ class Map
 	unsigned int m_height{0};
 	// Holds all Tile objects to construct the map.
 	std::vector<Tile> m_tiles_vec;
-	// Contains each tile object's limited production.
-	std::vector<unsigned int> m_resource_vec;
+	/* Contains each tile object's limited production. It never exceeds EACH_TILE_PRODUCTION, so one byte per tile is
+	 * enough. */
+	std::vector<std::uint8_t> m_resource_vec;
 	// Each tile object has 16 pixels' width(thus half width is 8 pixels) and 8 pixels' height.
 	unsigned int m_tile_half_width{TILE_HALF_WIDTH};
 	// An unsigned int array, index indicates the region type, result indicates the related regions' number.
 	unsigned int m_region_num_arr[1]{0};
-	// Indicates number of selected tiles.
-	unsigned int m_selected_tiles_num{0};
-	/* Indicates current map's all selected tiles' conditions. Value 0 means related tile is de-selected, 1 means
-	 * related tile is selected and 2 means related tile is invalid to be selected/de-selected. */
-	std::vector<char> m_selected_tiles_condition_vec{};
+	// Whether any rectangle is selected.
+	bool m_is_selected{false};
+	// Top left and bottom right corners of the last selected rectangle.
+	sf::Vector2i m_selected_start_pos{0, 0};
+	sf::Vector2i m_selected_end_pos{0, 0};
+	// Bit mask of the tile types which are invalid to be selected, the bit of each type is 1 << TileTypeEnum.
+	std::uint32_t m_select_blacklist_mask{0};
+	/* Summed-area tables of grass tiles, the only type which selections are split on: building selects grass tiles
+	 * and bulldozing selects all others. Each MAP_CHUNK_SIZE x MAP_CHUNK_SIZE chunk has its own table, whose count at
+	 * (chunk_idx * MAP_CHUNK_SIZE + local_y) * MAP_CHUNK_SIZE + local_x is the amount of grass tiles from the chunk's
+	 * top left tile to that tile. */
+	mutable std::vector<std::uint16_t> m_grass_sums_vec;
+	/* Summed-area table of each chunk's grass tiles. The count at (chunk_y * (chunks_x_num + 1) + chunk_x) is the
+	 * amount within the chunks from (0, 0) to (chunk_x - 1, chunk_y - 1). */
+	mutable std::vector<std::uint32_t> m_chunk_grass_sums_vec;
+	// Whether each chunk's table is outdated, and the indices of those chunks. Rebuilt lazily once a rect is counted.
+	mutable std::vector<std::uint8_t> m_is_grass_chunk_dirty_vec;
+	mutable std::vector<unsigned int> m_dirty_grass_chunk_idx_vec;
+	/* Whether each chunk's tiles changed since update_snapshot last copied them, and the indices of those chunks. All
+	 * chunks are copied if m_are_all_chunks_changed is set. */
+	std::vector<std::uint8_t> m_is_chunk_changed_vec;
+	std::vector<unsigned int> m_changed_chunk_idx_vec;
+	bool m_are_all_chunks_changed{true};
+
+	/**
+	 * Sort the corners of the rectangle and clamp them into the map.
+	 * @param start_pos A reference of sf::Vector2i indicates one corner, becomes the top left one.
+	 * @param end_pos A reference of sf::Vector2i indicates the opposite corner, becomes the bottom right one.
+	 */
+	void clamp_rect(sf::Vector2i& start_pos, sf::Vector2i& end_pos) const;
+
+	/**
+	 * Update the direction of the directional tile at the position if it is of the input type.
+	 * @param x An integer indicates the tile's x position.
+	 * @param y An integer indicates the tile's y position.
+	 * @param tileType A TileTypeEnum object indicates the type of tile object.
+	 */
+	void update_tile_direction(int x, int y, TileTypeEnum tileType);
+
+	/**
+	 * Copy the tile's persistent data into its snapshot.
+	 * @param idx A std::size_t indicates the index of the tile.
+	 * @param tile_snapshot A reference of TileSnapshot indicates the snapshot to be filled.
+	 */
+	void copy_tile_snapshot(std::size_t idx, TileSnapshot& tile_snapshot) const;
+
+	/**
+	 * Retrieve the amount of MAP_CHUNK_SIZE x MAP_CHUNK_SIZE chunks per row of the map.
+	 * @return A unsigned integer indicates the amount of chunks.
+	 */
+	unsigned int get_chunks_x_num() const;
+
+	/**
+	 * Mark the grass summed-area tables of the chunks overlapping the rectangle outdated.
+	 * @param start_pos A reference of const sf::Vector2i indicates the rectangle's top left corner.
+	 * @param end_pos A reference of const sf::Vector2i indicates the rectangle's bottom right corner.
+	 */
+	void mark_grass_sums_dirty(const sf::Vector2i& start_pos, const sf::Vector2i& end_pos) const;
+
+	/**
+	 * Rebuild the outdated chunks' grass summed-area tables, then the chunks' summed-area table if any chunk changed.
+	 */
+	void update_grass_sums() const;
+
+	/**
+	 * Count the grass tiles within the rectangle. Chunks fully inside it are counted at once from the chunks' table,
+	 * and each chunk on its border from its own table.
+	 * @param start_pos A reference of const sf::Vector2i indicates the rectangle's top left corner.
+	 * @param end_pos A reference of const sf::Vector2i indicates the rectangle's bottom right corner.
+	 * @return A unsigned integer indicates the amount of grass tiles.
+	 */
+	unsigned int count_grass(const sf::Vector2i& start_pos, const sf::Vector2i& end_pos) const;
 
 	/**
 	 * Split the map into different regions and region_idx them according to what region they fall in.
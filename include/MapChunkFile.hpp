@@ -0,0 +1,221 @@
+#pragma once
+#ifndef MAPCHUNKFILE_HPP
+#define MAPCHUNKFILE_HPP
+
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+#include <SFML/System/Vector2.hpp>
+#include "CitySnapshot.hpp"
+
+/**
+ * The summed data of all tiles of one region inside one chunk.
+ */
+struct RegionAggregate
+{
+	// Region id of the tiles.
+	unsigned int m_region_id{0};
+	// Amount of the tiles.
+	std::uint32_t m_tiles_num{0};
+	// The tiles' overall population.
+	double m_population{0.0};
+	// The tiles' overall production.
+	float m_total_production{0.f};
+	// The tiles' overall remaining underground resource.
+	std::uint32_t m_resource{0};
+};
+
+/**
+ * A compact summary of one game map chunk. It is stored inside the chunk table, so it is available without reading
+ * the chunk's tiles.
+ */
+struct ChunkSummary
+{
+	// Amount of tiles of each tile type, indexed by TileTypeEnum.
+	std::uint32_t m_tile_type_num_arr[static_cast<int>(TileTypeEnum::INDUSTRIAL) + 1]{};
+	// Overall population, production and remaining resource of all tiles inside the chunk.
+	double m_population{0.0};
+	float m_total_production{0.f};
+	std::uint32_t m_resource{0};
+	// Aggregates of each region which has tiles inside the chunk, sorted by region id.
+	std::vector<RegionAggregate> m_region_aggregates_vec;
+};
+
+/**
+ * Represents the chunked game map binary file. The map is divided into MAP_CHUNK_SIZE x MAP_CHUNK_SIZE chunks, and a
+ * table of each chunk's file offset and summary follows the file header. So any chunk can be read without reading
+ * the ones before it, and the whole map can be summarized without reading any tile. The file header may also carry
+ * the city's record, so a saved city is a single file.
+ */
+class MapChunkFile
+{
+ public:
+	/**
+	 * Write the chunked game map file from all tiles' snapshots.
+	 * @param map_path A reference of const string indicates the file's path.
+	 * @param width A unsigned integer indicates the map's width.
+	 * @param height A unsigned integer indicates the map's height.
+	 * @param tiles_vec A reference of const vector indicates all tiles' snapshots in map order.
+	 * @param city_record_vec A reference of const vector indicates the city's record, can be empty.
+	 * @return A bool indicates whether the file is written successfully or not.
+	 */
+	static bool write(const std::string& map_path, unsigned int width, unsigned int height,
+		const std::vector<TileSnapshot>& tiles_vec, const std::vector<char>& city_record_vec = std::vector<char>());
+
+	/**
+	 * Write the chunked game map file one chunk at a time, so the whole map never needs to be held in memory.
+	 * @param map_path A reference of const string indicates the file's path.
+	 * @param width A unsigned integer indicates the map's width.
+	 * @param height A unsigned integer indicates the map's height.
+	 * @param fill_chunk_func A reference of const std::function which fills the tiles of the chunk at the input chunk
+	 * coordinate in the chunk's row order. The vector is already resized to the chunk's size.
+	 * @param city_record_vec A reference of const vector indicates the city's record, can be empty.
+	 * @return A bool indicates whether the file is written successfully or not.
+	 */
+	static bool write(const std::string& map_path, unsigned int width, unsigned int height,
+		const std::function<void(unsigned int, unsigned int, std::vector<TileSnapshot>&)>& fill_chunk_func,
+		const std::vector<char>& city_record_vec = std::vector<char>());
+
+	/**
+	 * Read all tiles of the game map file in map order. Map files written by old versions, which store all tiles
+	 * without chunks, can also be read.
+	 * @param map_path A reference of const string indicates the file's path.
+	 * @param width A unsigned integer indicates the map's width.
+	 * @param height A unsigned integer indicates the map's height.
+	 * @param tiles_vec A reference of vector to be filled with all tiles' snapshots.
+	 * @return A bool indicates whether the file exists and matches the map's dimension.
+	 */
+	static bool load(const std::string& map_path, unsigned int width, unsigned int height,
+		std::vector<TileSnapshot>& tiles_vec);
+
+	/**
+	 * Check whether the file is a chunked game map file by its magic number.
+	 * @param map_path A reference of const string indicates the file's path.
+	 * @return A bool indicates whether the file starts with the chunked game map file's magic number.
+	 */
+	static bool is_chunk_file(const std::string& map_path);
+
+	/**
+	 * Calculate the summary of one chunk's tiles.
+	 * @param chunk_tiles_vec A reference of const vector indicates the chunk's tiles.
+	 * @param summary A reference of ChunkSummary to be filled.
+	 */
+	static void summarize(const std::vector<TileSnapshot>& chunk_tiles_vec, ChunkSummary& summary);
+
+	/**
+	 * Write tiles' type, current level, region id array, current population and total production, followed by all of
+	 * their resources as one byte plane and all of their productions per day as another plane.
+	 * @param output_stream A reference of std::ostream indicates the stream to be written.
+	 * @param tiles_vec A reference of const vector indicates the tiles to be written.
+	 */
+	static void write_tiles(std::ostream& output_stream, const std::vector<TileSnapshot>& tiles_vec);
+
+	/**
+	 * Read tiles written by write_tiles.
+	 * @param input_stream A reference of std::istream indicates the stream to be read.
+	 * @param tiles_vec A reference of vector indicates the tiles to be filled, already resized to the tiles' amount.
+	 * @param is_production_saved A bool indicates whether the production plane is written, which files older than
+	 * version 3 lack. Their tiles' productions per day stay zero.
+	 * @return A bool indicates whether the resource plane(and the production plane if saved) is read or not.
+	 */
+	static bool read_tiles(std::istream& input_stream, std::vector<TileSnapshot>& tiles_vec, bool is_production_saved);
+
+	/**
+	 * Open a chunked game map file, read its header and chunk table.
+	 * @param map_path A reference of const string indicates the file's path.
+	 * @return A bool indicates whether the file is a valid chunked game map file.
+	 */
+	bool open(const std::string& map_path);
+
+	/**
+	 * Check whether a chunked game map file is opened.
+	 * @return A bool indicates whether the file is opened.
+	 */
+	bool is_open() const;
+
+	/**
+	 * Retrieve the map's width.
+	 * @return A unsigned integer indicates the map's width.
+	 */
+	unsigned int get_width() const;
+
+	/**
+	 * Retrieve the map's height.
+	 * @return A unsigned integer indicates the map's height.
+	 */
+	unsigned int get_height() const;
+
+	/**
+	 * Retrieve the amount of chunks in each row.
+	 * @return A unsigned integer indicates the amount of chunks.
+	 */
+	unsigned int get_chunks_x_num() const;
+
+	/**
+	 * Retrieve the amount of chunks in each column.
+	 * @return A unsigned integer indicates the amount of chunks.
+	 */
+	unsigned int get_chunks_y_num() const;
+
+	/**
+	 * Retrieve the chunk's width and height in tiles, chunks on the right and bottom edges may be smaller.
+	 * @param chunk_idx A unsigned integer indicates the chunk's index in chunk row order.
+	 * @return A sf::Vector2u indicates the chunk's width and height.
+	 */
+	sf::Vector2u get_chunk_size(unsigned int chunk_idx) const;
+
+	/**
+	 * Retrieve the chunk's summary stored inside the chunk table.
+	 * @param chunk_idx A unsigned integer indicates the chunk's index in chunk row order.
+	 * @return A reference of const ChunkSummary indicates the summary.
+	 */
+	const ChunkSummary& get_summary(unsigned int chunk_idx) const;
+
+	/**
+	 * Retrieve the city's record stored inside the file header.
+	 * @return A reference of const vector indicates the record, empty if the file does not hold one.
+	 */
+	const std::vector<char>& get_city_record() const;
+
+	/**
+	 * Read all chunks' tiles.
+	 * @param tiles_vec A reference of vector to be filled with all tiles' snapshots in map order.
+	 * @return A bool indicates whether all chunks are read successfully or not.
+	 */
+	bool read_all(std::vector<TileSnapshot>& tiles_vec);
+
+	/**
+	 * Read one chunk's tiles. Not thread safe, each thread should open its own MapChunkFile object.
+	 * @param chunk_idx A unsigned integer indicates the chunk's index in chunk row order.
+	 * @param chunk_tiles_vec A reference of vector to be filled with the chunk's tiles in the chunk's row order.
+	 * @return A bool indicates whether the chunk is read successfully or not.
+	 */
+	bool read_chunk(unsigned int chunk_idx, std::vector<TileSnapshot>& chunk_tiles_vec);
+
+ private:
+	// Each chunk's payload position inside the file.
+	struct ChunkEntry
+	{
+		std::uint64_t m_offset{0};
+		std::uint32_t m_size{0};
+	};
+
+	// The opened file and its version.
+	std::ifstream m_input_file;
+	std::uint32_t m_version{0};
+	// Dimension of the game map, each chunk's width and height and the amount of chunks in each row and column.
+	unsigned int m_width{0};
+	unsigned int m_height{0};
+	unsigned int m_chunk_size{0};
+	unsigned int m_chunks_x_num{0};
+	unsigned int m_chunks_y_num{0};
+	// The city's record, empty if the file does not hold one.
+	std::vector<char> m_city_record_vec;
+	// Each chunk's payload position and summary, in chunk row order.
+	std::vector<ChunkEntry> m_entries_vec;
+	std::vector<ChunkSummary> m_summaries_vec;
+};
+
+#endif //MAPCHUNKFILE_HPP
@@ -0,0 +1,53 @@
+#pragma once
+#ifndef MAPRENDERER_HPP
+#define MAPRENDERER_HPP
+
+#include <array>
+#include <vector>
+#include "AnimationHandler.hpp"
+#include "TileTypeEnum.hpp"
+#include "Utility.hpp"
+
+// Forward declarations.
+class Map;
+
+/**
+ * Draws the game map inside the render window. It holds how each type of tile looks(its sprite and animations), so
+ * the Map and Tile objects being drawn never depend on any window or texture.
+ */
+class MapRenderer
+{
+ public:
+	/**
+	 * Default constructor, no tile type can be drawn until it is added.
+	 */
+	MapRenderer() = default;
+
+	/**
+	 * Set up how one type of tile looks.
+	 * @param tile_type A TileTypeEnum indicates the tile type.
+	 * @param tile_half_width_pixel A unsigned integer indicates the half width pixel size of the tile.
+	 * @param tile_height_num A unsigned integer represents the number of half tile width indicates the tile's height.
+	 * @param texture A reference of sf::Texture indicates the texture of all related different levels' tiles.
+	 * @param animation_vec A reference of const vector indicates the tile's animations, one per level.
+	 */
+	void add_tile(TileTypeEnum tile_type, unsigned int tile_half_width_pixel, unsigned int tile_height_num,
+		sf::Texture& texture, const std::vector<Animation>& animation_vec);
+
+	/**
+	 * Draw the tiles of the game map which overlap the render window's view, and play their animations.
+	 * @param render_window A reference of sf::RenderWindow indicates the place to render the map.
+	 * @param map A reference of const Map indicates the game map.
+	 * @param dt A float indicates the elapsed time since last call.
+	 */
+	void render(sf::RenderWindow& render_window, const Map& map, float dt);
+
+ private:
+	/* The sprite of each tile type, in TileTypeEnum order. It is moved onto each tile of its type right before the
+	 * tile is drawn. */
+	std::array<sf::Sprite, TILE_TYPES_NUM> m_sprite_arr;
+	// The animations of each tile type, in TileTypeEnum order.
+	std::array<AnimationHandler, TILE_TYPES_NUM> m_animationHandler_arr;
+};
+
+#endif //MAPRENDERER_HPP
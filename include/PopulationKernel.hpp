@@ -0,0 +1,49 @@
+#pragma once
+#ifndef POPULATIONKERNEL_HPP
+#define POPULATIONKERNEL_HPP
+
+#include <cstddef>
+#include "Utility.hpp"
+
+/**
+ * Indicates the instruction set used by the population kernel.
+ */
+enum class SimdLevelEnum
+{
+	SCALAR,
+	SSE2,
+	AVX2
+};
+
+/**
+ * Retrieve the widest instruction set of the population kernel supported by the running CPU, detected on the first
+ * call. It is always SCALAR on compilers or CPUs without x86 intrinsics.
+ * @return A SimdLevelEnum indicates the instruction set.
+ */
+SimdLevelEnum get_simd_level();
+
+/**
+ * Retrieve the name of an instruction set, for printing.
+ * @param simd_level A SimdLevelEnum indicates the instruction set.
+ * @return A const char pointer indicates the name.
+ */
+const char* simdLevelToStr(SimdLevelEnum simd_level);
+
+/**
+ * Grow each tile's population by the rate and clamp it to its limit, the same way as City::distributeResidents does
+ * after moving people in. The part beyond the limit is added into the overflow and the clamped populations are added
+ * into the total population. Both sums are accumulated in POPULATION_KERNEL_LANES_NUM interleaved lanes combined in a
+ * fixed order, so every instruction set gives bit-identical results.
+ * @param population_arr A pointer of double indicates the tiles' populations, updated in place.
+ * @param limit_arr A pointer of const double indicates the tiles' population limits.
+ * @param tiles_num A std::size_t indicates the amount of tiles.
+ * @param rate A double indicates the growth rate, negative to shrink.
+ * @param overflow_ref A reference of double to be increased by the people beyond the limits.
+ * @param total_population_ref A reference of double to be increased by the clamped populations.
+ * @param simd_level A SimdLevelEnum indicates the instruction set to use, it falls back to a narrower one if the CPU
+ * does not support it. Default value is the widest supported one.
+ */
+void grow_and_clamp_populations(double* population_arr, const double* limit_arr, std::size_t tiles_num, double rate,
+	double& overflow_ref, double& total_population_ref, SimdLevelEnum simd_level = get_simd_level());
+
+#endif //POPULATIONKERNEL_HPP
@@ -0,0 +1,142 @@
+#pragma once
+#ifndef PROFILER_HPP
+#define PROFILER_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/* Scoped profiling macros. Only compiled in with CITYBUILDER_PROFILING defined, otherwise they expand to nothing and
+ * cost nothing. The scope's name must be a string literal since only its pointer is recorded. */
+#ifdef CITYBUILDER_PROFILING
+#define PROFILE_CONCAT_IMPL(lhs, rhs) lhs##rhs
+#define PROFILE_CONCAT(lhs, rhs) PROFILE_CONCAT_IMPL(lhs, rhs)
+// Record the time from here to the end of the enclosing scope.
+#define PROFILE_SCOPE(name) const ProfileScope PROFILE_CONCAT(profile_scope_, __LINE__)(name)
+// Dump all recorded events into a Chrome trace file.
+#define PROFILE_DUMP(path) Profiler::dump(path)
+#else
+#define PROFILE_SCOPE(name) static_cast<void>(0)
+#define PROFILE_DUMP(path) static_cast<void>(0)
+#endif
+
+/**
+ * One finished scope.
+ */
+struct ProfileEvent
+{
+	// Name of the scope, a string literal.
+	const char* m_name{nullptr};
+	// When the scope started and how long it lasted in nanoseconds since the profiler's start.
+	std::uint64_t m_start_ns{0};
+	std::uint64_t m_duration_ns{0};
+};
+
+/**
+ * A fixed size ring buffer of one thread's events. Only the owning thread writes into it, so recording needs neither
+ * locks nor atomic read-modify-write operations. Once full, the oldest events are overwritten.
+ */
+class ProfileRingBuffer
+{
+ public:
+	/**
+	 * One parameter constructor.
+	 * @param thread_idx A unsigned integer indicates the owning thread's index inside the trace.
+	 */
+	explicit ProfileRingBuffer(unsigned int thread_idx);
+
+	/**
+	 * Record one event, only called by the owning thread.
+	 * @param event A reference of const ProfileEvent indicates the event.
+	 */
+	void push(const ProfileEvent& event);
+
+	/**
+	 * Copy the events which are still inside the buffer, oldest first. Events which the owning thread writes while
+	 * copying may be torn, which only affects the newest events.
+	 * @param events_vec A reference of vector to be appended with the events.
+	 */
+	void copy_events(std::vector<ProfileEvent>& events_vec) const;
+
+	/**
+	 * Retrieve the owning thread's index inside the trace.
+	 * @return A unsigned integer indicates the index.
+	 */
+	unsigned int get_thread_idx() const;
+
+ private:
+	// The owning thread's index inside the trace.
+	unsigned int m_thread_idx{0};
+	// The events, written at m_head modulo the buffer's size.
+	std::vector<ProfileEvent> m_events_vec;
+	// The amount of events ever written, published after each event is written.
+	std::atomic<std::uint64_t> m_head{0};
+};
+
+/**
+ * Collects scoped events of all threads and dumps them as Chrome trace JSON, which can be opened by chrome://tracing
+ * or Perfetto.
+ */
+class Profiler
+{
+ public:
+	/**
+	 * Retrieve the current time.
+	 * @return A std::uint64_t indicates the time in nanoseconds since the profiler's start.
+	 */
+	static std::uint64_t now_ns();
+
+	/**
+	 * Record one finished scope into the calling thread's ring buffer, which is created on the thread's first record.
+	 * @param name A pointer of const char indicates the scope's name, a string literal.
+	 * @param start_ns A std::uint64_t indicates when the scope started.
+	 * @param end_ns A std::uint64_t indicates when the scope ended.
+	 */
+	static void record(const char* name, std::uint64_t start_ns, std::uint64_t end_ns);
+
+	/**
+	 * Write all threads' recorded events into a Chrome trace JSON file.
+	 * @param trace_path A reference of const string indicates the file's path.
+	 * @return A bool indicates whether the file is written successfully or not.
+	 */
+	static bool dump(const std::string& trace_path);
+};
+
+/**
+ * Records the time between its construction and destruction as one event.
+ */
+class ProfileScope
+{
+ public:
+	/**
+	 * One parameter constructor. Start timing.
+	 * @param name A pointer of const char indicates the scope's name, a string literal.
+	 */
+	explicit ProfileScope(const char* name) : m_name(name), m_start_ns(Profiler::now_ns()) {};
+
+	/**
+	 * Destructor. Record the event.
+	 */
+	~ProfileScope()
+	{
+		Profiler::record(m_name, m_start_ns, Profiler::now_ns());
+	};
+
+	/**
+	 * Deleted copy constructor since each scope is recorded once.
+	 */
+	ProfileScope(const ProfileScope&) = delete;
+	/**
+	 * Deleted copy assignment operator since each scope is recorded once.
+	 */
+	ProfileScope& operator=(const ProfileScope&) = delete;
+
+ private:
+	// Name of the scope.
+	const char* m_name;
+	// When the scope started.
+	std::uint64_t m_start_ns;
+};
+
+#endif //PROFILER_HPP
@@ -0,0 +1,31 @@
+#pragma once
+#ifndef RENDERUTILITY_HPP
+#define RENDERUTILITY_HPP
+
+#include <SFML/Graphics/Color.hpp>
+#include "Utility.hpp"
+
+/**
+ * This header stores all in-game colors, which are only used for rendering and need sfml-graphics. All other in-game
+ * data is stored inside Utility.hpp.
+ */
+
+// Store button GuiStyle object's colors.
+const sf::Color BUTTON_BACKGROUND_COLOR(sf::Color(0xc6,0xc6,0xc6));
+const sf::Color BUTTON_OUTLINE_COLOR(sf::Color(0x94,0x94,0x94));
+const sf::Color BUTTON_BACKGROUND_HIGHLIGHT_COLOR(sf::Color(0x61,0x61,0x61));
+const sf::Color BUTTON_OUTLINE_HIGHLIGHT_COLOR(sf::Color(0x94,0x94,0x94));
+
+// Store text GuiStyle object's colors.
+const sf::Color TEXT_BACKGROUND_COLOR(sf::Color(0x00,0x00,0x00,0x00));
+const sf::Color TEXT_BACKGROUND_HIGHLIGHT_COLOR(sf::Color(0x00,0x00,0x00,0x00));
+
+// Store each tile type's color inside save slot thumbnails, in TileTypeEnum order.
+const sf::Color SLOT_THUMBNAIL_TILE_COLOR_ARR[]{ sf::Color::Black, sf::Color(0x4c, 0xa0, 0x3c),
+	sf::Color(0x1e, 0x5a, 0x1e), sf::Color(0x2c, 0x6c, 0xc8), sf::Color(0x80, 0x80, 0x80),
+	sf::Color(0x60, 0xd0, 0x60), sf::Color(0x40, 0x90, 0xe0), sf::Color(0xe0, 0xc0, 0x40) };
+
+// Store the Tile object's selected color.
+const sf::Color TILE_SELECTED_COLOR(sf::Color (0x7d, 0x7d, 0x7d));
+
+#endif //RENDERUTILITY_HPP
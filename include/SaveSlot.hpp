@@ -0,0 +1,128 @@
+#pragma once
+#ifndef SAVESLOT_HPP
+#define SAVESLOT_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Forward declaration.
+class CitySnapshot;
+
+/**
+ * A small summary of one saved city, stored inside its save slot's header file. It can be read without loading the
+ * game map.
+ */
+struct SaveSlotHeader
+{
+	// Index of the save slot.
+	unsigned int m_slot_idx{0};
+	// Whether the header file exists(saves written by old versions only have the city configuration and game map).
+	bool m_has_summary{false};
+	// City's name.
+	std::string m_name;
+	// City's current day, population and fund.
+	unsigned int m_day{0};
+	double m_population{0};
+	double m_fund{0};
+	// Dimension of the game map.
+	unsigned int m_width{0};
+	unsigned int m_height{0};
+	/* Tile types of a SAVE_SLOT_THUMBNAIL_SIZE x SAVE_SLOT_THUMBNAIL_SIZE thumbnail of the game map, sampled from the
+	 * nearest tile in row order. */
+	std::vector<std::uint8_t> m_thumbnail_vec;
+};
+
+/**
+ * Represents one save slot inside the save directory. Each slot has its own game map file(which also holds the city's
+ * record), action journal and header file. Saves written by old versions also have a text city configuration file.
+ */
+class SaveSlot
+{
+ public:
+	/**
+	 * One parameter constructor. Slot 0 uses the file names of single-save versions so that old saves are kept.
+	 * @param slot_idx A unsigned integer indicates the save slot's index. Default value is 0.
+	 */
+	explicit SaveSlot(unsigned int slot_idx = 0);
+
+	/**
+	 * Retrieve the save slot's index.
+	 * @return A unsigned integer indicates the index.
+	 */
+	unsigned int get_idx() const;
+
+	/**
+	 * Retrieve the text city configuration file's path, which is only read from saves written by old versions.
+	 * @return A reference of const std::string indicates the path.
+	 */
+	const std::string& get_cfg_path() const;
+
+	/**
+	 * Retrieve the game map binary file's path.
+	 * @return A reference of const std::string indicates the path.
+	 */
+	const std::string& get_map_path() const;
+
+	/**
+	 * Retrieve the action journal file's path.
+	 * @return A reference of const std::string indicates the path.
+	 */
+	const std::string& get_journal_path() const;
+
+	/**
+	 * Retrieve the header file's path.
+	 * @return A reference of const std::string indicates the path.
+	 */
+	const std::string& get_header_path() const;
+
+	/**
+	 * Retrieve the default name of the city inside this slot.
+	 * @return A std::string indicates the default name.
+	 */
+	std::string get_default_name() const;
+
+	/**
+	 * Check whether the slot holds a saved city.
+	 * @return A bool indicates whether the game map file or the text city configuration file exists.
+	 */
+	bool is_used() const;
+
+	/**
+	 * Read the slot's header file only. If the slot is used but has no header file, the header is filled with the
+	 * default name and m_has_summary is false.
+	 * @param header A reference of SaveSlotHeader to be filled.
+	 * @return A bool indicates whether the slot is used.
+	 */
+	bool read_header(SaveSlotHeader& header) const;
+
+	/**
+	 * Write the summary of the snapshot into the slot's header file through a temporary file.
+	 * @param snapshot A reference of const CitySnapshot indicates the saved city.
+	 * @return A bool indicates whether the header file is written successfully or not.
+	 */
+	bool write_header(const CitySnapshot& snapshot) const;
+
+	/**
+	 * Read headers of all used save slots, in slot order.
+	 * @param headers_vec A reference of vector to be filled with the headers.
+	 */
+	static void read_all_headers(std::vector<SaveSlotHeader>& headers_vec);
+
+	/**
+	 * Find the first save slot which does not hold a saved city.
+	 * @return A unsigned integer indicates the slot's index, SAVE_SLOTS_NUM if all slots are used.
+	 */
+	static unsigned int find_free_slot_idx();
+
+ private:
+	// Index of the save slot.
+	unsigned int m_idx{0};
+	// Paths of the slot's files.
+	std::string m_cfg_path;
+	std::string m_map_path;
+	std::string m_journal_path;
+	std::string m_header_path;
+};
+
+#endif //SAVESLOT_HPP
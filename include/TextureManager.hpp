@@ -4,8 +4,13 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 #include <SFML/Graphics.hpp>
 #include <unordered_map>
+#include "Utility.hpp"
+
+// Forward declaration.
+struct PackedTexture;
 
 /**
  * A class manages all textures' load, store and retrieve behaviors by singleton pattern.
@@ -38,6 +43,32 @@ class TextureManager
 	 */
 	static void loadTexture(const std::string& texture_name, const std::string& file_name);
 
+	/**
+	 * Decode image files into sf::Image objects on the shared JobSystem's threads. Decoding needs no OpenGL context, so it can run
+	 * off the main thread and even before the game window is created.
+	 * @param file_name_vec A const reference of vector indicates the image files' names.
+	 * @param image_vec A reference of vector to be filled with the decoded images in the same order as the file names.
+	 * @param decode_sum_ms A reference of double to be filled with the decoding time summed over all images in
+	 * milliseconds, which is what decoding them one by one would take.
+	 */
+	static void decodeImages(const std::vector<std::string>& file_name_vec, std::vector<sf::Image>& image_vec,
+		double& decode_sum_ms);
+
+	/**
+	 * Upload decoded images into textures created in place inside the TextureManager. Must be called on the thread
+	 * which owns the OpenGL context.
+	 * @param texture_name_vec A const reference of vector indicates the textures' names.
+	 * @param image_vec A const reference of vector indicates the decoded images in the same order as the names.
+	 */
+	static void storeImages(const std::vector<std::string>& texture_name_vec, const std::vector<sf::Image>& image_vec);
+
+	/**
+	 * Create textures in place inside the TextureManager straight from the asset pack's RGBA pixels. Must be called
+	 * on the thread which owns the OpenGL context.
+	 * @param packed_textures_vec A const reference of vector indicates the asset pack's textures.
+	 */
+	static void storePackedTextures(const std::vector<PackedTexture>& packed_textures_vec);
+
 	/**
 	 * Retrieve and return the reference of sf::Texture object related to input string.
 	 * @param texture_str A const reference of std::string indicates the name of required sf::Texture object.
@@ -2,11 +2,13 @@
 #ifndef TILE_HPP
 #define TILE_HPP
 
-#include "AnimationHandler.hpp"
+#include <string>
+#include <unordered_map>
 #include "TileTypeEnum.hpp"
 
 /**
- * This class processes all behaviors of one Tile object.
+ * This class processes all simulation behaviors of one Tile object. How a tile looks is up to the MapRenderer, so Tile
+ * objects never depend on any window or texture.
  */
 class Tile
 {
@@ -17,54 +19,30 @@ class Tile
 	 */
 	Tile() = default;
 	/**
-	 * Eight parameters constructor.
-	 * @param tile_half_width_pixel A const unsigned int indicates the half width pixel size of the tile object.
-	 * @param tile_height_num A const unsigned int represents the number of half tile width indicates the tile's height.
-	 * @param texture A reference of sf::Texture indicates the texture of all related different levels' tiles.
-	 * @param animation_vec A std::vector<Animation> indicates the tile object's related animation.
+	 * Four parameters constructor.
 	 * @param tileType A reference of enum TileTypeEnum object indicates the tile type.
 	 * @param cost A const unsigned int indicates the cost to placement the tile object.
 	 * @param curr_level_population_limit A const unsigned int indicates the maximum possible population value for
 	 * current level of the tile.
 	 * @param max_level A const unsigned int indicates the maximum possible level of the tile.
 	 */
-	Tile(const unsigned int tile_half_width_pixel, const unsigned int tile_height_num, sf::Texture& texture,
-		std::vector<Animation> animation_vec, const TileTypeEnum& tileType, const unsigned int cost,
-		const unsigned int curr_level_population_limit, const unsigned int max_level) : m_tileType(tileType),
-		m_cost(cost), m_population_limit_per_level(curr_level_population_limit), m_max_level(max_level),
-		m_animationHandler_ptr(std::make_shared<AnimationHandler>())
-		{
-			/* Since one texture contains at most 4 tiles, we need to set up the top left point of the current
-			 * tile sprite according to the whole texture.*/
-			m_sprite.setOrigin(sf::Vector2f(0.f, (tile_height_num - 1) * tile_half_width_pixel));
-			m_sprite.setTexture(texture);
-
-			// Set up animation handler's m_each_frame_size_rect(we only care about width and height here).
-			m_animationHandler_ptr->SetEachFrameSizeRect((sf::IntRect(0,0,
-				2 * tile_half_width_pixel, tile_half_width_pixel * tile_height_num)));
-
-			// Store all tile related animation.
-			for (auto& each_anim : animation_vec)
-			{
-				m_animationHandler_ptr->addAnim(each_anim);
-			}
-			// Reset animation handler's elapsed time to 0.
-			m_animationHandler_ptr->update(0.f);
-		};
+	Tile(const TileTypeEnum& tileType, const unsigned int cost, const unsigned int curr_level_population_limit,
+		const unsigned int max_level) : m_tileType(tileType), m_cost(cost),
+		m_population_limit_per_level(curr_level_population_limit), m_max_level(max_level) {};
 
 	/**
-	 * Draw the tile sprite within the render window and play the related animation.
-	 * @param render_window A reference of sf::RenderWindow indicates the place to render the tile sprite.
-	 * @param dt A float indicates the elapsed time since last render call(also last AnimationHandler::chanceLevelUp
-	 * call).
+	 * Check if the tile may level up, which is when it is a zone tile whose population is at the maximum value for its
+	 * level and its level is still lower than the maximum level.
+	 * @return A bool indicates whether the tile may level up.
 	 */
-	void render(sf::RenderWindow& render_window, float dt);
+	bool is_level_up_ready() const;
 
 	/**
-	 * If the population is at the maximum value for the tile, there is a small chance that the tile will increase its
-     * building level.
+	 * Retrieve the chance that a tile ready to level up does so within a day, out of RAND_BASE_NUM. It decreases with
+	 * the tile's level.
+	 * @return A unsigned integer indicates the chance.
 	 */
-	void chanceLevelUp();
+	unsigned int get_level_up_chance() const;
 
 	/**
 	 * Return the cost of placing current tile object in string form.
@@ -109,8 +87,6 @@ class Tile
 	double m_population{0.0};
 	// Overall production of the tile.
 	float m_total_production{0.f};
-	// The sprite of the current tile object.
-	sf::Sprite m_sprite;
 
  private:
 	// Placement cost of each tile.
@@ -121,8 +97,20 @@ class Tile
 	unsigned int m_max_level{0};
 	// Current tile's overall production per work and per day.
 	float m_production_per_day{ 0.f};
-	// An AnimationHandler object
-	std::shared_ptr<AnimationHandler> m_animationHandler_ptr;
 };
 
+/**
+ * Transform input TileTypeEnum into related tile texture(and Tile object) name.
+ * @param tile_type A TileTypeEnum object indicates the input TileTypeEnum.
+ * @return A std::string indicates the related string.
+ */
+std::string tileTypeToStr(TileTypeEnum tile_type);
+
+/**
+ * Create all 7 types of tile objects, which are the prototypes every map tile is copied from.
+ * @param str_tile_map A reference of unordered_map to be filled with each tile type's string name and related tile
+ * object.
+ */
+void load_tiles(std::unordered_map<std::string, Tile>& str_tile_map);
+
 #endif //TILE_HPP
@@ -0,0 +1,28 @@
+#pragma once
+#ifndef TILERANDOM_HPP
+#define TILERANDOM_HPP
+
+#include <cstdint>
+#include "Utility.hpp"
+
+/**
+ * Retrieve a random number which only depends on the city's seed, the tile, the day and the stream, unlike numbers
+ * drawn from a generator shared by all tiles. A tile's numbers therefore never change when other tiles are skipped or
+ * updated in another order.
+ * @param seed A unsigned integer indicates the city's seed.
+ * @param tile_index A integer indicates the tile's index.
+ * @param day A unsigned integer indicates the day.
+ * @param stream A std::uint32_t indicates which of the tile's numbers of the day is retrieved.
+ * @return A std::uint64_t indicates the random number.
+ */
+inline std::uint64_t get_tile_random(unsigned int seed, int tile_index, unsigned int day, std::uint32_t stream)
+{
+	// Mix the inputs with SplitMix64's finalizer, which gives well distributed bits for consecutive days.
+	std::uint64_t hash = (static_cast<std::uint64_t>(seed) << 32 | static_cast<std::uint32_t>(tile_index)) ^
+		((static_cast<std::uint64_t>(stream) << 32 | day) * TILE_RANDOM_HASH_FACTOR);
+	hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ull;
+	hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebull;
+	return hash ^ (hash >> 31);
+}
+
+#endif //TILERANDOM_HPP
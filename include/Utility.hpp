@@ -2,11 +2,13 @@
 #ifndef UTILITY_HPP
 #define UTILITY_HPP
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
-#include <SFML/Graphics.hpp>
 
 /**
- * This header stores all in-game data(include number, string, file path and so on).
+ * This header stores all in-game data(include number, string, file path and so on). Colors need sfml-graphics, so
+ * they are stored inside RenderUtility.hpp instead.
  */
 
 // Game title and background texture names.
@@ -37,6 +39,18 @@ const std::string GRASS_TILE_TEXTURE_PATH("../resources/images/grass.png");
 const std::string FONT_PATH("../resources/fonts/font.ttf");
 const std::string FONT_NAME("main_font");
 
+// Store the command line option for printing the time each startup step takes.
+const std::string STARTUP_TRACE_OPTION_STR("--startup-trace");
+// Store the prebuilt asset pack's path, the loose image and font files are used if it is missing.
+const std::string ASSET_PACK_PATH("../resources/binary/assets.pack");
+// Store the magic number("CBAP") and version written at the beginning of the asset pack file.
+constexpr std::uint32_t ASSET_PACK_FILE_MAGIC(0x50414243u);
+constexpr std::uint32_t ASSET_PACK_FILE_VERSION(1);
+// Store the alignment in bytes of each texture's pixels and each font's bytes inside the asset pack file.
+constexpr std::uint64_t ASSET_PACK_ALIGNMENT(16);
+// Store the asset packer's command line option for choosing the output path.
+const std::string PACK_OUTPUT_OPTION_STR("--output");
+
 // Store game window's original width and height.
 constexpr unsigned int GAME_WINDOW_WIDTH(1280);
 constexpr unsigned int GAME_WINDOW_HEIGHT(720);
@@ -93,16 +107,10 @@ constexpr float WATER_ANIM_EACH_FRAME_DURATION(0.5f);
 // Store button GuiStyle object's properties.
 const std::string BUTTON_NAME("button");
 constexpr float BUTTON_OUTLINE_SIZE(1.f);
-const sf::Color BUTTON_BACKGROUND_COLOR(sf::Color(0xc6,0xc6,0xc6));
-const sf::Color BUTTON_OUTLINE_COLOR(sf::Color(0x94,0x94,0x94));
-const sf::Color BUTTON_BACKGROUND_HIGHLIGHT_COLOR(sf::Color(0x61,0x61,0x61));
-const sf::Color BUTTON_OUTLINE_HIGHLIGHT_COLOR(sf::Color(0x94,0x94,0x94));
 
 // Store text GuiStyle object's properties.
 const std::string TEXT_NAME("text");
 constexpr float TEXT_OUTLINE_SIZE(0.f);
-const sf::Color TEXT_BACKGROUND_COLOR(sf::Color(0x00,0x00,0x00,0x00));
-const sf::Color TEXT_BACKGROUND_HIGHLIGHT_COLOR(sf::Color(0x00,0x00,0x00,0x00));
 
 // Define each tile object's production.
 constexpr int EACH_TILE_PRODUCTION(255);
@@ -144,9 +152,33 @@ constexpr unsigned int GUI_TEXT_PADDING(4);
 // Store button GuiStyle object's name.
 const std::string BUTTON_GUI_STYLE_NAME("button");
 
-// Store load game GuiEntry object's name and activated message.
-const std::string LOAD_GAME_GUI_ENTRY_NAME("Load Game");
-const std::string LOAD_GAME_GUI_ENTRY_MSG("message:load_game");
+// Store the dimension of each save slot GuiEntry object's shape inside the main menu.
+constexpr unsigned int SLOT_GUI_ENTRY_WIDTH(480);
+constexpr unsigned int SLOT_GUI_ENTRY_HEIGHT(18);
+
+// Store the activated message prefix of save slot GuiEntry objects, followed by the slot's index.
+const std::string LOAD_SLOT_GUI_ENTRY_MSG_PREFIX("message:load_slot:");
+// Store new city GuiEntry object's name and activated message.
+const std::string NEW_CITY_GUI_ENTRY_NAME("New City");
+const std::string NEW_CITY_GUI_ENTRY_MSG("message:new_city");
+// Store the text shown on the chosen save slot GuiEntry object while the city is loading.
+const std::string LOADING_GUI_ENTRY_TEXT("Loading...");
+
+// Store the name of the main menu's Gui object which shows the progress of the city loaded in background.
+const std::string PRELOAD_GUI_NAME("Preload");
+// Store the text shown while the first listed city is loaded in background and once it is ready.
+const std::string PRELOADING_GUI_ENTRY_PREFIX("Preloading ");
+const std::string PRELOADED_GUI_ENTRY_SUFFIX(" is ready");
+// Store the distance between the save slot list and the preloading progress text in pixels.
+constexpr float PRELOAD_GUI_Y_OFFSET(8.f);
+// Store the loading progress in percent after a city's snapshot is read, after its map is created and at the end.
+constexpr unsigned int CITY_LOAD_SNAPSHOT_PROGRESS(50);
+constexpr unsigned int CITY_LOAD_MAP_PROGRESS(80);
+constexpr unsigned int CITY_LOAD_DONE_PROGRESS(100);
+
+// Store the scale of the hovered save slot's thumbnail and its distance from the save slot list in pixels.
+constexpr float SLOT_THUMBNAIL_SCALE(4.f);
+constexpr float SLOT_THUMBNAIL_X_OFFSET(16.f);
 
 // Store each Tile object's related GuiEntry object's name and activated message.
 const std::string GRASS_GUI_ENTRY_NAME("Grass $" + std::to_string(GRASS_TILE_COST));
@@ -183,20 +215,137 @@ const std::string GUI_NAME("Load Game");
 // Help generate random number.
 constexpr unsigned int RAND_BASE_NUM(1e3);
 constexpr unsigned int LEVEL_BASE_NUM(1e2);
-
-// Store game map's binary file's path.
-const std::string MAP_BINARY_FILE_PATH("../resources/binary/city_map.dat");
-// Store the city's name.
-const std::string CITY_NAME_STR("../resources/binary/city_cfg.dat");
-
-// Store the Tile object's selected color.
-const sf::Color TILE_SELECTED_COLOR(sf::Color (0x7d, 0x7d, 0x7d));
+// Store the level-up day of a tile which has no level-up scheduled.
+constexpr unsigned int LEVEL_UP_NO_EVENT_DAY(0xFFFFFFFFu);
+// Store the maximum amount of days ahead a level-up is searched for, it is practically always found far earlier.
+constexpr unsigned int LEVEL_UP_MAX_SCHEDULED_DAYS(10000);
+// Store the factor mixing the stream and the day into each tile's random numbers.
+constexpr std::uint64_t TILE_RANDOM_HASH_FACTOR(0x9E3779B97F4A7C15ull);
+/* Store the streams of each tile's random numbers of a day: hiring by commercial tiles, extracting resource and hiring
+ * by industrial tiles, and leveling up(one stream per level from the last one on). */
+constexpr std::uint32_t TILE_RANDOM_COMMERCIAL_HIRE_STREAM(0);
+constexpr std::uint32_t TILE_RANDOM_INDUSTRIAL_EXTRACT_STREAM(1);
+constexpr std::uint32_t TILE_RANDOM_INDUSTRIAL_HIRE_STREAM(2);
+constexpr std::uint32_t TILE_RANDOM_LEVEL_UP_STREAM(3);
+
+// Store the save directory's path and the prefix of each save slot's file names.
+const std::string SAVE_DIRECTORY_PATH("../resources/binary/");
+const std::string SAVE_SLOT_FILE_PREFIX("city");
+// Store the suffixes of each save slot's city configuration, game map, action journal and header file names.
+const std::string SAVE_SLOT_CFG_SUFFIX("_cfg.dat");
+const std::string SAVE_SLOT_MAP_SUFFIX("_map.dat");
+const std::string SAVE_SLOT_JOURNAL_SUFFIX("_journal.dat");
+const std::string SAVE_SLOT_HEADER_SUFFIX("_header.dat");
+// Store the maximum amount of save slots.
+constexpr unsigned int SAVE_SLOTS_NUM(32);
+// Store the width and height of each save slot's map thumbnail in pixels.
+constexpr unsigned int SAVE_SLOT_THUMBNAIL_SIZE(32);
+// Store the magic number("CBSH") and version written at the beginning of each save slot's header file.
+constexpr std::uint32_t SAVE_SLOT_HEADER_MAGIC(0x48534243u);
+constexpr std::uint32_t SAVE_SLOT_HEADER_VERSION(1);
+// Store the dimension of a newly generated city's game map.
+constexpr unsigned int CITY_DEFAULT_WIDTH(64);
+constexpr unsigned int CITY_DEFAULT_HEIGHT(64);
+// Store the default name of each city, followed by its save slot's number.
+const std::string SAVE_SLOT_DEFAULT_NAME_STR("City ");
+// Store the suffix of temporary files which are renamed into the save files after being written completely.
+const std::string TEMP_FILE_SUFFIX(".tmp");
+// Store the amount of game days between two autosaves.
+constexpr unsigned int AUTOSAVE_INTERVAL_DAYS(30);
+// Store the journal size in bytes which triggers a compaction(a new snapshot which the journal is folded into).
+constexpr std::size_t JOURNAL_COMPACTION_SIZE(64 * 1024);
+/* Store the magic number("CBTR") and version written at the beginning of each input trace file. Version 2 carries the
+ * whole city when recording starts instead of only its seed and day. */
+constexpr std::uint32_t TRACE_FILE_MAGIC(0x52544243u);
+constexpr std::uint32_t TRACE_FILE_VERSION(2);
+// Store the command line options for recording and replaying input traces.
+const std::string RECORD_TRACE_OPTION_STR("--record");
+const std::string REPLAY_TRACE_OPTION_STR("--replay");
+// Store the headless runner's command line options for simulating days without a trace and overriding the seed.
+const std::string DAYS_OPTION_STR("--days");
+const std::string SEED_OPTION_STR("--seed");
+// Store the headless runner's command line option for choosing the save slot.
+const std::string SLOT_OPTION_STR("--slot");
+// Store the headless runner's command line option for exporting the final city's properties as text for debugging.
+const std::string EXPORT_TEXT_OPTION_STR("--export-text");
+/* Store the headless runner's command line option choosing the residential pass of each day, and its values. The
+ * serial pass is used by default. */
+const std::string RESIDENTIAL_PASS_OPTION_STR("--residential-pass");
+const std::string RESIDENTIAL_PASS_SERIAL_STR("serial");
+const std::string RESIDENTIAL_PASS_PARALLEL_STR("parallel");
+// Store the headless runner's command line option for writing the amount of awake tiles of each day as CSV.
+const std::string ACTIVE_REPORT_OPTION_STR("--active-report");
+// Store the headless runner's command line option for advancing the city by many days at once after the other days.
+const std::string FAST_FORWARD_OPTION_STR("--fast-forward");
+/* Store the magic number("CBMC") and version written at the beginning of each chunked game map file. Version 2 adds
+ * the city's record and version 3 adds each tile's production per day. */
+constexpr std::uint32_t MAP_CHUNK_FILE_MAGIC(0x434d4243u);
+constexpr std::uint32_t MAP_CHUNK_FILE_VERSION(3);
+// Store the width and height of each game map chunk in tiles.
+constexpr unsigned int MAP_CHUNK_SIZE(32);
+// Store the benchmark runner's command line options.
+const std::string BENCH_SIZES_OPTION_STR("--sizes");
+const std::string BENCH_DENSITY_OPTION_STR("--density");
+const std::string BENCH_FORMAT_OPTION_STR("--format");
+const std::string BENCH_OUTPUT_OPTION_STR("--output");
+const std::string BENCH_MIN_TIME_OPTION_STR("--min-time");
+const std::string BENCH_UPDATE_MAX_SIZE_OPTION_STR("--update-max-size");
+const std::string BENCH_COMPARE_OPTION_STR("--compare");
+const std::string BENCH_THRESHOLD_OPTION_STR("--threshold");
+// Store the benchmark runner's default map sizes, each one doubles the previous one.
+constexpr unsigned int BENCH_MIN_MAP_SIZE(64);
+constexpr unsigned int BENCH_MAX_MAP_SIZE(2048);
+// Store the default proportion of non-road tiles which are zones on the benchmark runner's synthetic maps.
+constexpr double BENCH_DEFAULT_ZONE_DENSITY(0.5);
+// Store the default time in milliseconds each benchmark keeps iterating for, and its maximum amount of iterations.
+constexpr double BENCH_DEFAULT_MIN_TIME_MS(200.0);
+constexpr std::size_t BENCH_MAX_ITERATIONS_NUM(1000);
+/* Store the default largest map size simulated by the city update benchmark, since a day takes quadratic time in the
+ * amount of zones. */
+constexpr unsigned int BENCH_DEFAULT_UPDATE_MAX_SIZE(256);
+// Store the default slowdown in percent beyond which a benchmark is reported as a regression.
+constexpr double BENCH_DEFAULT_REGRESSION_THRESHOLD(10.0);
+// Store the width and height of the rectangles selected and bulldozed by the benchmark runner.
+constexpr unsigned int BENCH_SELECT_RECT_SIZE(64);
+constexpr unsigned int BENCH_BULLDOZE_RECT_SIZE(16);
+// Store the amount of tiles the job system benchmark's synthetic kernel reads per tile.
+constexpr unsigned int BENCH_TILE_KERNEL_ROUNDS_NUM(64);
+/* Store the amount of threads from which the benchmark runner checks the job system's speedup, and the parallel
+ * efficiency the speedup on that amount of threads must reach. */
+constexpr unsigned int BENCH_SCALING_THREADS_NUM(8);
+constexpr double BENCH_MIN_PARALLEL_EFFICIENCY(0.75);
+// Store the growth rate applied by the population kernel benchmark, large enough for many tiles to overflow.
+constexpr double BENCH_POPULATION_GROWTH_RATE(0.25);
+/* Store the benchmark runner's fast-forward check: the synthetic city's size, the day it is stepped to first and the
+ * amounts of days which are then advanced at once and stepped one by one. */
+constexpr unsigned int BENCH_FAST_FORWARD_MAP_SIZE(32);
+constexpr unsigned int BENCH_FAST_FORWARD_START_DAY(3000);
+constexpr unsigned int BENCH_FAST_FORWARD_SHORT_DAYS_NUM(29);
+constexpr unsigned int BENCH_FAST_FORWARD_LONG_DAYS_NUM(720);
+// Store the total production which each industrial tile of the stocked fast-forward city starts with.
+constexpr float BENCH_FAST_FORWARD_STOCK_PRODUCTION(1e12f);
+// Store the path of the game map file which the benchmark runner loads and saves.
+const std::string BENCH_MAP_PATH("citybuilder_bench_map.dat");
+// Store the amount of events each thread's profiling ring buffer holds before the oldest are overwritten.
+constexpr std::size_t PROFILE_RING_BUFFER_EVENTS_NUM(1 << 16);
+// Store the path of the Chrome trace file which profiling events are dumped into on F12 and at exit.
+const std::string PROFILE_TRACE_PATH("citybuilder_profile.json");
+// Store the amount of chunks per thread a parallel for splits its range into, so idle threads have chunks to steal.
+constexpr std::size_t JOB_SYSTEM_CHUNKS_PER_THREAD(4);
+// Store the minimum amount of tiles one job of a whole map pass handles, below which queuing costs more than it saves.
+constexpr std::size_t JOB_SYSTEM_MIN_TILES_PER_JOB(4096);
+// Store the FNV-1a hash's offset basis and prime used to compare city states.
+constexpr std::uint64_t FNV_OFFSET_BASIS(0xcbf29ce484222325ull);
+constexpr std::uint64_t FNV_PRIME(0x100000001b3ull);
 
 // Store flags about whether a tile is selected or valid.
 constexpr unsigned int TILE_NOT_SELECTED_FLAG(0);
 constexpr unsigned int TILE_SELECTED_FLAG(1);
 constexpr unsigned int TILE_INVALID_FLAG(2);
 
+// Store the amount of tile types inside TileTypeEnum.
+constexpr unsigned int TILE_TYPES_NUM(8);
+
 // Define each tile object's half width in pixels.
 constexpr unsigned int TILE_HALF_WIDTH = 8;
 
@@ -216,6 +365,7 @@ constexpr double CITY_COMMERCIAL_TAX_RATE(0.05);
 constexpr double CITY_INDUSTRIAL_TAX_RATE(0.05);
 
 // Store all City class's property names' strings.
+const std::string CITY_NAME_STR("m_name");
 const std::string CITY_WIDTH_STR("city_width");
 const std::string CITY_HEIGHT_STR("city_height");
 const std::string CITY_DAY_STR("m_day");
@@ -230,10 +380,21 @@ const std::string CITY_COMMERCIAL_TAX_RATE_STR("m_commercial_tax_rate");
 const std::string CITY_INDUSTRIAL_TAX_RATE_STR("m_industrial_tax_rate");
 const std::string CITY_FUND_STR("m_fund");
 const std::string CITY_CURR_MONTH_EARNINGS_STR("m_curr_month_earnings");
+const std::string CITY_SEED_STR("m_seed");
+const std::string CITY_JOURNAL_SEQ_STR("m_journal_seq");
 
 // Store each month's days' amount(assume each month has exactly 30 days).
 constexpr unsigned int DAYS_NUM_PER_MONTH(30);
 
+// Store the factor mixing the day into the city's seed at the beginning of each day.
+constexpr unsigned int CITY_DAY_SEED_FACTOR(0x9E3779B9u);
+
+// Store the amount of tiles(in update order) each chunk of the parallel residential pass handles.
+constexpr std::size_t CITY_PARALLEL_CHUNK_TILES_NUM(1024);
+
+// Store the amount of interleaved lanes the population kernel sums in, which is the width of an AVX2 register.
+constexpr std::size_t POPULATION_KERNEL_LANES_NUM(4);
+
 // Store a base number for random number generation inside City::update function.
 constexpr unsigned int CITY_RANDOM_BASE(100);
 // Store a factor for tax rate comparison inside City::update function.
@@ -251,9 +412,6 @@ constexpr unsigned int RESIDENTIAL_RANDOM_BASE(20);
 // Store the factor used to count city's current month's residential earnings.
 constexpr unsigned int RESIDENTIAL_EARNING_FACTOR(15);
 
-// Store the name of menu Gui object.
-const std::string MENU_GUI_STR("rightClickMenu");
-
 // Store the dimension of menu Gui object's entry shape.
 constexpr unsigned int MENU_GUI_ENTRY_SHAPE_WIDTH(196);
 constexpr unsigned int MENU_GUI_ENTRY_SHAPE_HEIGHT(16);
@@ -261,9 +419,6 @@ constexpr unsigned int MENU_GUI_ENTRY_SHAPE_HEIGHT(16);
 // Store menu Gui object's text padding.
 constexpr unsigned int MENU_GUI_TEXT_PADDING(2);
 
-// Store the name of select tile cost text Gui object.
-const std::string SELECT_TILE_COST_TEXT_GUI_STR("selectCostText");
-
 // Store the dimension of select tile cost text Gui object's entry shape.
 constexpr unsigned int SELECT_TILE_COST_TEXT_GUI_ENTRY_SHAPE_WIDTH(196);
 constexpr unsigned int SELECT_TILE_COST_TEXT_GUI_ENTRY_SHAPE_HEIGHT(16);
@@ -272,9 +427,6 @@ constexpr unsigned int SELECT_TILE_COST_TEXT_GUI_ENTRY_SHAPE_HEIGHT(16);
 constexpr unsigned int SELECT_TILE_COST_TEXT_GUI_X_OFFSET(16);
 constexpr unsigned int SELECT_TILE_COST_TEXT_GUI_Y_OFFSET(-16);
 
-// Store the name of information bar Gui object.
-const std::string INFO_BAR_GUI_STR("infoBar");
-
 // Store the dimension of information bar Gui object's entry shape.
 constexpr unsigned int INFO_BAR_GUI_ENTRY_SHAPE_WIDTH(GAME_WINDOW_WIDTH/5);
 constexpr unsigned int INFO_BAR_GUI_ENTRY_SHAPE_HEIGHT(16);
@@ -282,5 +434,23 @@ constexpr unsigned int INFO_BAR_GUI_ENTRY_SHAPE_HEIGHT(16);
 // Store Info bar Gui object's text padding.
 constexpr unsigned int INFO_BAR_GUI_TEXT_PADDING(2);
 
+// Store the amount of values a GuiEntry object's text can be bound to and the size of its formatting buffer.
+constexpr unsigned int GUI_ENTRY_BOUND_VALUES_NUM(2);
+constexpr unsigned int GUI_ENTRY_TEXT_BUFFER_SIZE(128);
+
+// Store the padding around each glyph quad of Gui texts in pixels, the same as sf::Text uses.
+constexpr float GUI_GLYPH_PADDING(1.f);
+
+// Store the amount of vertices of each rectangle inside a Gui's vertex arrays.
+constexpr unsigned int GUI_RECT_VERTICES_NUM(6);
+
+// Store the formats of information bar's day, fund, population and employment GuiEntry objects.
+constexpr char DAY_GUI_ENTRY_FORMAT[] = "Day: %.0f";
+constexpr char FUND_GUI_ENTRY_FORMAT[] = "Fund: $%f";
+constexpr char POPULATION_GUI_ENTRY_FORMAT[] = "Population:%f(Homeless:%f)";
+constexpr char EMPLOYMENT_GUI_ENTRY_FORMAT[] = "(Employee:%f(Unemployed:%f)";
+// Store the prefix of information bar's selected tile GuiEntry object.
+const std::string CURR_TILE_GUI_ENTRY_PREFIX("Selected Tile:");
+
 #endif //UTILITY_HPP
 
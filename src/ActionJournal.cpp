@@ -0,0 +1,204 @@
+#include <iostream>
+#include "ActionJournal.hpp"
+#include "CitySnapshot.hpp"
+#include "Utility.hpp"
+
+ActionJournal::ActionJournal(std::string journal_path) : m_journal_path(std::move(journal_path))
+{
+	// Store the existing journal's size and open it for appending.
+	std::ifstream input_file(m_journal_path, std::ios::in | std::ios::binary | std::ios::ate);
+	if (input_file.is_open())
+		m_size = static_cast<std::size_t>(input_file.tellg());
+	input_file.close();
+	m_output_file.open(m_journal_path, std::ios::out | std::ios::binary | std::ios::app);
+}
+
+void ActionJournal::append_bulldoze(std::uint32_t seq, const sf::Vector2i& start_pos, const sf::Vector2i& end_pos,
+	TileTypeEnum tile_type)
+{
+	JournalRecord record;
+	record.m_type = JournalRecordEnum::BULLDOZE;
+	record.m_seq = seq;
+	record.m_start_pos = start_pos;
+	record.m_end_pos = end_pos;
+	record.m_tile_type = tile_type;
+	this->append(record);
+}
+
+void ActionJournal::append_fund(std::uint32_t seq, double fund)
+{
+	JournalRecord record;
+	record.m_type = JournalRecordEnum::FUND;
+	record.m_seq = seq;
+	record.m_fund = fund;
+	this->append(record);
+}
+
+void ActionJournal::append_day(std::uint32_t seq, unsigned int day)
+{
+	JournalRecord record;
+	record.m_type = JournalRecordEnum::DAY;
+	record.m_seq = seq;
+	record.m_day = day;
+	this->append(record);
+}
+
+void ActionJournal::append_advance(std::uint32_t seq, unsigned int day)
+{
+	JournalRecord record;
+	record.m_type = JournalRecordEnum::ADVANCE;
+	record.m_seq = seq;
+	record.m_day = day;
+	this->append(record);
+}
+
+void ActionJournal::append(const JournalRecord& record)
+{
+	// Flush each record so that it survives a crash of the game.
+	m_size += write_record(m_output_file, record);
+	m_output_file.flush();
+}
+
+std::size_t ActionJournal::write_record(std::ostream& output_stream, const JournalRecord& record)
+{
+	// Each record starts with its type and sequence number.
+	output_stream.write(reinterpret_cast<const char*>(&(record.m_type)), sizeof(std::uint8_t));
+	output_stream.write(reinterpret_cast<const char*>(&(record.m_seq)), sizeof(std::uint32_t));
+	std::size_t record_size = sizeof(std::uint8_t) + sizeof(std::uint32_t);
+
+	// Then the payload related to the record's type follows.
+	switch (record.m_type)
+	{
+	case JournalRecordEnum::BULLDOZE:
+	{
+		std::int32_t rect_arr[4]{ record.m_start_pos.x, record.m_start_pos.y, record.m_end_pos.x,
+								  record.m_end_pos.y };
+		std::uint8_t tile_type = static_cast<std::uint8_t>(record.m_tile_type);
+		output_stream.write(reinterpret_cast<const char*>(rect_arr), sizeof(rect_arr));
+		output_stream.write(reinterpret_cast<const char*>(&tile_type), sizeof(std::uint8_t));
+		record_size += sizeof(rect_arr) + sizeof(std::uint8_t);
+		break;
+	}
+	case JournalRecordEnum::FUND:
+		output_stream.write(reinterpret_cast<const char*>(&(record.m_fund)), sizeof(double));
+		record_size += sizeof(double);
+		break;
+	case JournalRecordEnum::DAY:
+	case JournalRecordEnum::ADVANCE:
+		output_stream.write(reinterpret_cast<const char*>(&(record.m_day)), sizeof(std::uint32_t));
+		record_size += sizeof(std::uint32_t);
+		break;
+	}
+
+	return record_size;
+}
+
+void ActionJournal::read(std::uint32_t after_seq, std::vector<JournalRecord>& records_vec) const
+{
+	read_records(m_journal_path, after_seq, records_vec);
+}
+
+std::size_t ActionJournal::read_records(const std::string& journal_path, std::uint32_t after_seq,
+	std::vector<JournalRecord>& records_vec)
+{
+	records_vec.clear();
+	std::ifstream input_file(journal_path, std::ios::in | std::ios::binary);
+	std::size_t read_size{0};
+
+	JournalRecord record;
+	// Read each record's type and sequence number first.
+	while (input_file.read(reinterpret_cast<char*>(&(record.m_type)), sizeof(std::uint8_t)) &&
+		input_file.read(reinterpret_cast<char*>(&(record.m_seq)), sizeof(std::uint32_t)))
+	{
+		// Then read the payload according to the record's type.
+		switch (record.m_type)
+		{
+		case JournalRecordEnum::BULLDOZE:
+		{
+			std::int32_t rect_arr[4]{ 0, 0, 0, 0 };
+			std::uint8_t tile_type{0};
+			input_file.read(reinterpret_cast<char*>(rect_arr), sizeof(rect_arr));
+			input_file.read(reinterpret_cast<char*>(&tile_type), sizeof(std::uint8_t));
+			record.m_start_pos = sf::Vector2i(rect_arr[0], rect_arr[1]);
+			record.m_end_pos = sf::Vector2i(rect_arr[2], rect_arr[3]);
+			record.m_tile_type = static_cast<TileTypeEnum>(tile_type);
+			break;
+		}
+		case JournalRecordEnum::FUND:
+			input_file.read(reinterpret_cast<char*>(&(record.m_fund)), sizeof(double));
+			break;
+		case JournalRecordEnum::DAY:
+		case JournalRecordEnum::ADVANCE:
+			input_file.read(reinterpret_cast<char*>(&(record.m_day)), sizeof(std::uint32_t));
+			break;
+		default:
+			std::cerr << "Error, unknown record type inside journal " << journal_path << '\n';
+			return read_size;
+		}
+
+		/* A truncated record means the game crashed while appending it(or it is being appended right now), ignore it
+		 * and everything after. */
+		if (!input_file)
+			return read_size;
+		read_size = static_cast<std::size_t>(input_file.tellg());
+		if (record.m_seq > after_seq)
+			records_vec.emplace_back(record);
+	}
+	return read_size;
+}
+
+void ActionJournal::compact(std::uint32_t snapshot_seq)
+{
+	std::size_t read_size{0};
+	if (prepare_compaction(m_journal_path, snapshot_seq, read_size))
+		this->finish_compaction(read_size);
+}
+
+bool ActionJournal::prepare_compaction(const std::string& journal_path, std::uint32_t snapshot_seq,
+	std::size_t& read_size_ref)
+{
+	// Nothing to compact for a city which is not journaling.
+	if (!std::ifstream(journal_path, std::ios::in | std::ios::binary).is_open())
+		return false;
+
+	// Keep only records which are not included by the snapshot yet.
+	std::vector<JournalRecord> records_vec;
+	read_size_ref = read_records(journal_path, snapshot_seq, records_vec);
+
+	// Rewrite them into a temporary file, the journal file itself is still appended meanwhile.
+	const std::string temp_journal_path(journal_path + TEMP_FILE_SUFFIX);
+	std::ofstream temp_file(temp_journal_path, std::ios::out | std::ios::binary | std::ios::trunc);
+	for (const auto& record : records_vec)
+		write_record(temp_file, record);
+	temp_file.close();
+	return !temp_file.fail();
+}
+
+void ActionJournal::finish_compaction(std::size_t read_size)
+{
+	// Every record is flushed once appended, so the bytes after read_size are whole records.
+	m_output_file.close();
+	std::vector<char> tail_vec(m_size > read_size ? m_size - read_size : 0);
+	std::ifstream input_file(m_journal_path, std::ios::in | std::ios::binary);
+	input_file.seekg(static_cast<std::streamoff>(read_size));
+	input_file.read(tail_vec.data(), static_cast<std::streamsize>(tail_vec.size()));
+	input_file.close();
+
+	// Append them to the compacted records and replace the journal file.
+	const std::string temp_journal_path(m_journal_path + TEMP_FILE_SUFFIX);
+	std::ofstream temp_file(temp_journal_path, std::ios::out | std::ios::binary | std::ios::app);
+	temp_file.write(tail_vec.data(), static_cast<std::streamsize>(tail_vec.size()));
+	temp_file.seekp(0, std::ios::end);
+	const std::size_t new_size = static_cast<std::size_t>(temp_file.tellp());
+	temp_file.close();
+	if (input_file && !temp_file.fail() && CitySnapshot::commit_file(temp_journal_path, m_journal_path))
+		m_size = new_size;
+
+	// Continue appending to the compacted journal.
+	m_output_file.open(m_journal_path, std::ios::out | std::ios::binary | std::ios::app);
+}
+
+std::size_t ActionJournal::get_size() const
+{
+	return m_size;
+}
@@ -0,0 +1,218 @@
+#include <iostream>
+#include "ActionTrace.hpp"
+#include "City.hpp"
+#include "Tile.hpp"
+#include "Utility.hpp"
+
+TraceRecorder::TraceRecorder(const std::string& trace_path, const CitySnapshot& start_snapshot)
+{
+	m_output_file.open(trace_path, std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!m_output_file.is_open())
+	{
+		std::cerr << "Error, cannot create trace file " << trace_path << '\n';
+		return;
+	}
+
+	/* The header stores the trace's version and the whole city when recording starts, followed by the city's hash to
+	 * detect a damaged header. */
+	std::uint32_t header_arr[2]{ TRACE_FILE_MAGIC, TRACE_FILE_VERSION };
+	m_output_file.write(reinterpret_cast<const char*>(header_arr), sizeof(header_arr));
+	start_snapshot.write(m_output_file);
+	const std::uint64_t start_hash = start_snapshot.get_hash();
+	m_output_file.write(reinterpret_cast<const char*>(&start_hash), sizeof(std::uint64_t));
+}
+
+void TraceRecorder::record_frame(float dt)
+{
+	const std::uint8_t type = static_cast<std::uint8_t>(TraceRecordEnum::FRAME);
+	m_output_file.write(reinterpret_cast<const char*>(&type), sizeof(std::uint8_t));
+	m_output_file.write(reinterpret_cast<const char*>(&dt), sizeof(float));
+}
+
+void TraceRecorder::record_select(const sf::Vector2i& start_pos, const sf::Vector2i& end_pos)
+{
+	// Tile coordinates fit into 16 bits, which keeps select records(the most frequent ones) small.
+	const std::uint8_t type = static_cast<std::uint8_t>(TraceRecordEnum::SELECT);
+	std::int16_t rect_arr[4]{ static_cast<std::int16_t>(start_pos.x), static_cast<std::int16_t>(start_pos.y),
+							  static_cast<std::int16_t>(end_pos.x), static_cast<std::int16_t>(end_pos.y) };
+	m_output_file.write(reinterpret_cast<const char*>(&type), sizeof(std::uint8_t));
+	m_output_file.write(reinterpret_cast<const char*>(rect_arr), sizeof(rect_arr));
+}
+
+void TraceRecorder::record_place()
+{
+	const std::uint8_t type = static_cast<std::uint8_t>(TraceRecordEnum::PLACE);
+	m_output_file.write(reinterpret_cast<const char*>(&type), sizeof(std::uint8_t));
+}
+
+void TraceRecorder::record_cancel()
+{
+	const std::uint8_t type = static_cast<std::uint8_t>(TraceRecordEnum::CANCEL);
+	m_output_file.write(reinterpret_cast<const char*>(&type), sizeof(std::uint8_t));
+}
+
+void TraceRecorder::record_tile(TileTypeEnum tile_type)
+{
+	const std::uint8_t type_arr[2]{ static_cast<std::uint8_t>(TraceRecordEnum::TILE),
+									static_cast<std::uint8_t>(tile_type) };
+	m_output_file.write(reinterpret_cast<const char*>(type_arr), sizeof(type_arr));
+}
+
+void TraceRecorder::record_zoom(float zoom_factor)
+{
+	const std::uint8_t type = static_cast<std::uint8_t>(TraceRecordEnum::ZOOM);
+	m_output_file.write(reinterpret_cast<const char*>(&type), sizeof(std::uint8_t));
+	m_output_file.write(reinterpret_cast<const char*>(&zoom_factor), sizeof(float));
+}
+
+void TraceRecorder::record_pan(const sf::Vector2f& pan_offset)
+{
+	const std::uint8_t type = static_cast<std::uint8_t>(TraceRecordEnum::PAN);
+	float offset_arr[2]{ pan_offset.x, pan_offset.y };
+	m_output_file.write(reinterpret_cast<const char*>(&type), sizeof(std::uint8_t));
+	m_output_file.write(reinterpret_cast<const char*>(offset_arr), sizeof(offset_arr));
+}
+
+TracePlayer::TracePlayer(const std::string& trace_path)
+{
+	std::ifstream input_file(trace_path, std::ios::in | std::ios::binary);
+	std::uint32_t header_arr[2]{ 0, 0 };
+	std::uint64_t start_hash{0};
+	if (!input_file.read(reinterpret_cast<char*>(header_arr), sizeof(header_arr)) ||
+		header_arr[0] != TRACE_FILE_MAGIC || header_arr[1] != TRACE_FILE_VERSION ||
+		!m_start_snapshot.read(input_file) ||
+		!input_file.read(reinterpret_cast<char*>(&start_hash), sizeof(std::uint64_t)) ||
+		start_hash != m_start_snapshot.get_hash())
+	{
+		std::cerr << "Error, " << trace_path << " is not a valid trace file\n";
+		return;
+	}
+
+	TraceRecord record;
+	std::uint8_t type{0};
+	// Read each record's type first and then its payload.
+	while (input_file.read(reinterpret_cast<char*>(&type), sizeof(std::uint8_t)))
+	{
+		record.m_type = static_cast<TraceRecordEnum>(type);
+		switch (record.m_type)
+		{
+		case TraceRecordEnum::FRAME:
+			input_file.read(reinterpret_cast<char*>(&(record.m_dt)), sizeof(float));
+			break;
+		case TraceRecordEnum::SELECT:
+		{
+			std::int16_t rect_arr[4]{ 0, 0, 0, 0 };
+			input_file.read(reinterpret_cast<char*>(rect_arr), sizeof(rect_arr));
+			record.m_start_pos = sf::Vector2i(rect_arr[0], rect_arr[1]);
+			record.m_end_pos = sf::Vector2i(rect_arr[2], rect_arr[3]);
+			break;
+		}
+		case TraceRecordEnum::PLACE:
+		case TraceRecordEnum::CANCEL:
+			break;
+		case TraceRecordEnum::TILE:
+		{
+			std::uint8_t tile_type{0};
+			input_file.read(reinterpret_cast<char*>(&tile_type), sizeof(std::uint8_t));
+			record.m_tile_type = static_cast<TileTypeEnum>(tile_type);
+			break;
+		}
+		case TraceRecordEnum::ZOOM:
+			input_file.read(reinterpret_cast<char*>(&(record.m_zoom_factor)), sizeof(float));
+			break;
+		case TraceRecordEnum::PAN:
+		{
+			float offset_arr[2]{ 0.f, 0.f };
+			input_file.read(reinterpret_cast<char*>(offset_arr), sizeof(offset_arr));
+			record.m_pan_offset = sf::Vector2f(offset_arr[0], offset_arr[1]);
+			break;
+		}
+		default:
+			// Keep records read so far, the rest of the trace cannot be interpreted.
+			std::cerr << "Error, unknown record type inside trace " << trace_path << '\n';
+			m_is_valid = true;
+			return;
+		}
+
+		// A truncated record means the game was killed while recording, ignore it.
+		if (!input_file)
+			break;
+		if (record.m_type == TraceRecordEnum::FRAME)
+			++m_frames_num;
+		m_records_vec.emplace_back(record);
+	}
+	m_is_valid = true;
+}
+
+bool TracePlayer::is_valid() const
+{
+	return m_is_valid;
+}
+
+const CitySnapshot& TracePlayer::get_start_snapshot() const
+{
+	return m_start_snapshot;
+}
+
+bool TracePlayer::restore_start(City& city, std::unordered_map<std::string, Tile>& str_tile_map) const
+{
+	city.restore_snapshot(m_start_snapshot, str_tile_map);
+	CitySnapshot snapshot;
+	city.take_snapshot(snapshot);
+	if (snapshot.get_hash() == m_start_snapshot.get_hash())
+		return true;
+	std::cerr << "Error, the city restored from the trace has state hash " << std::hex << snapshot.get_hash() <<
+	" but the trace is recorded from state hash " << m_start_snapshot.get_hash() << std::dec << '\n';
+	return false;
+}
+
+std::size_t TracePlayer::get_frames_num() const
+{
+	return m_frames_num;
+}
+
+TileTypeEnum TracePlayer::get_tile_type() const
+{
+	return m_tile_type;
+}
+
+bool TracePlayer::play_frame(City& city, std::unordered_map<std::string, Tile>& str_tile_map,
+	std::vector<TraceRecord>* view_records_vec)
+{
+	while (m_next_record_idx < m_records_vec.size())
+	{
+		TraceRecord& record = m_records_vec[m_next_record_idx++];
+		// Apply each record in the same way as the main game state applies the related player input.
+		switch (record.m_type)
+		{
+		case TraceRecordEnum::SELECT:
+		{
+			sf::Vector2i start_pos(record.m_start_pos);
+			sf::Vector2i end_pos(record.m_end_pos);
+			city.select(start_pos, end_pos, m_tile_type);
+			break;
+		}
+		case TraceRecordEnum::PLACE:
+			city.place_selection(str_tile_map.at(tileTypeToStr(m_tile_type)));
+			city.get_map_ptr()->deselect_tiles();
+			break;
+		case TraceRecordEnum::CANCEL:
+			city.get_map_ptr()->deselect_tiles();
+			break;
+		case TraceRecordEnum::TILE:
+			m_tile_type = record.m_tile_type;
+			break;
+		case TraceRecordEnum::ZOOM:
+		case TraceRecordEnum::PAN:
+			// The city is not affected by the game view.
+			if (view_records_vec)
+				view_records_vec->emplace_back(record);
+			break;
+		case TraceRecordEnum::FRAME:
+			// The frame ends with the city's update.
+			city.update(record.m_dt);
+			return true;
+		}
+	}
+	return false;
+}
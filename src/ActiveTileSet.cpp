@@ -0,0 +1,127 @@
+#include <algorithm>
+#include "ActiveTileSet.hpp"
+
+void ActiveTileSet::reset(const std::vector<int>& update_order_vec, const std::vector<bool>& is_zone_vec)
+{
+	m_sleep_type_vec.assign(is_zone_vec.size(), TileSleepEnum::INERT);
+	m_is_listed_vec.assign(is_zone_vec.size(), 0);
+	m_update_position_vec.assign(is_zone_vec.size(), 0);
+	m_residential_limit_vec.assign(is_zone_vec.size(), 0);
+	m_active_idx_vec.clear();
+	m_woken_idx_vec.clear();
+	m_starved_idx_vec.clear();
+	m_full_residential_num_map.clear();
+
+	for (std::size_t i = 0; i < update_order_vec.size(); ++i)
+	{
+		const int tile_index = update_order_vec[i];
+		m_update_position_vec[tile_index] = static_cast<int>(i);
+		if (!is_zone_vec[tile_index])
+			continue;
+		m_sleep_type_vec[tile_index] = TileSleepEnum::ACTIVE;
+		m_is_listed_vec[tile_index] = 1;
+		m_active_idx_vec.push_back(tile_index);
+	}
+}
+
+void ActiveTileSet::begin_day(bool is_unemployment_available)
+{
+	// Starved tiles can hire again. Tiles woken otherwise since they starved are skipped.
+	if (is_unemployment_available)
+	{
+		for (const auto tile_index : m_starved_idx_vec)
+			if (m_sleep_type_vec[tile_index] == TileSleepEnum::STARVED)
+				this->wake_tile(tile_index);
+		m_starved_idx_vec.clear();
+	}
+	// Otherwise only drop the tiles woken otherwise, once they make up most of the starved tiles.
+	else if (m_starved_idx_vec.size() > m_sleep_type_vec.size())
+		m_starved_idx_vec.erase(std::remove_if(m_starved_idx_vec.begin(), m_starved_idx_vec.end(),
+			[this](int tile_index) { return m_sleep_type_vec[tile_index] != TileSleepEnum::STARVED; }),
+			m_starved_idx_vec.end());
+
+	// Drop the tiles put to sleep by the last pass.
+	m_active_idx_vec.erase(std::remove_if(m_active_idx_vec.begin(), m_active_idx_vec.end(), [this](int tile_index)
+	{
+		if (m_sleep_type_vec[tile_index] == TileSleepEnum::ACTIVE)
+			return false;
+		m_is_listed_vec[tile_index] = 0;
+		return true;
+	}), m_active_idx_vec.end());
+
+	// Merge the woken tiles in, keeping the update order.
+	if (m_woken_idx_vec.empty())
+		return;
+	const auto is_earlier = [this](int lhs_index, int rhs_index)
+	{
+		return m_update_position_vec[lhs_index] < m_update_position_vec[rhs_index];
+	};
+	std::sort(m_woken_idx_vec.begin(), m_woken_idx_vec.end(), is_earlier);
+	const std::size_t active_tiles_num = m_active_idx_vec.size();
+	m_active_idx_vec.insert(m_active_idx_vec.end(), m_woken_idx_vec.begin(), m_woken_idx_vec.end());
+	std::inplace_merge(m_active_idx_vec.begin(), m_active_idx_vec.begin() + active_tiles_num, m_active_idx_vec.end(),
+		is_earlier);
+	m_woken_idx_vec.clear();
+}
+
+const std::vector<int>& ActiveTileSet::get_active_idx_vec() const
+{
+	return m_active_idx_vec;
+}
+
+std::size_t ActiveTileSet::get_active_tiles_num() const
+{
+	return m_active_idx_vec.size();
+}
+
+bool ActiveTileSet::is_all_asleep() const
+{
+	// Tiles put to sleep since the last begin_day are still listed.
+	return m_woken_idx_vec.empty() && std::none_of(m_active_idx_vec.begin(), m_active_idx_vec.end(),
+		[this](int tile_index) { return m_sleep_type_vec[tile_index] == TileSleepEnum::ACTIVE; });
+}
+
+void ActiveTileSet::put_to_sleep(int tile_index, TileSleepEnum sleep_type, unsigned int residential_limit)
+{
+	m_sleep_type_vec[tile_index] = sleep_type;
+	if (sleep_type == TileSleepEnum::FULL && residential_limit > 0)
+	{
+		m_residential_limit_vec[tile_index] = residential_limit;
+		++m_full_residential_num_map[residential_limit];
+	}
+	else if (sleep_type == TileSleepEnum::STARVED)
+		m_starved_idx_vec.push_back(tile_index);
+}
+
+void ActiveTileSet::wake_tile(int tile_index)
+{
+	// A full residential tile no longer grows as a whole.
+	unsigned int& residential_limit = m_residential_limit_vec[tile_index];
+	if (residential_limit > 0)
+	{
+		const auto num_it = m_full_residential_num_map.find(residential_limit);
+		if (--num_it->second == 0)
+			m_full_residential_num_map.erase(num_it);
+		residential_limit = 0;
+	}
+
+	m_sleep_type_vec[tile_index] = TileSleepEnum::ACTIVE;
+	if (m_is_listed_vec[tile_index] == 0)
+	{
+		m_is_listed_vec[tile_index] = 1;
+		m_woken_idx_vec.push_back(tile_index);
+	}
+}
+
+void ActiveTileSet::add_full_residential(double rate, double& homeless_ref, double& total_population_ref) const
+{
+	for (const auto& each_pair : m_full_residential_num_map)
+	{
+		// Grow one tile the same way as City::distributeResidents does, then count it as many times as needed.
+		const double limit = each_pair.first;
+		const double population = limit + limit * rate;
+		if (population > limit)
+			homeless_ref += (population - limit) * each_pair.second;
+		total_population_ref += limit * each_pair.second;
+	}
+}
@@ -5,6 +5,16 @@ unsigned int Animation::getTotalFrame() const
 	return (m_end_frame - m_start_frame + 1);
 }
 
+unsigned int Animation::getStartFrame() const
+{
+	return m_start_frame;
+}
+
+unsigned int Animation::getEndFrame() const
+{
+	return m_end_frame;
+}
+
 float Animation::getDuration() const
 {
 	return m_duration;
@@ -0,0 +1,323 @@
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include "AssetPack.hpp"
+#include "CitySnapshot.hpp"
+#include "Utility.hpp"
+
+namespace
+{
+	/**
+	 * Write the input value's bytes into the stream.
+	 * @param output_stream A reference of std::ostream indicates the stream to be written.
+	 * @param value A reference of const T indicates the value to be written.
+	 */
+	template<typename T>
+	void write_value(std::ostream& output_stream, const T& value)
+	{
+		output_stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+
+	/**
+	 * Round the input size up to the alignment of data blocks inside the pack.
+	 * @param size A std::uint64_t indicates the size in bytes.
+	 * @return A std::uint64_t indicates the aligned size in bytes.
+	 */
+	std::uint64_t align_size(std::uint64_t size)
+	{
+		return (size + ASSET_PACK_ALIGNMENT - 1) / ASSET_PACK_ALIGNMENT * ASSET_PACK_ALIGNMENT;
+	}
+
+	/**
+	 * Calculate the size of a name inside the pack's tables, which is its length followed by its padded characters.
+	 * @param name A reference of const string indicates the name.
+	 * @return A std::uint64_t indicates the size in bytes.
+	 */
+	std::uint64_t get_name_size(const std::string& name)
+	{
+		return sizeof(std::uint32_t) + (name.size() + 3) / 4 * 4;
+	}
+
+	/**
+	 * Write a name as its length followed by its characters padded to 4 bytes.
+	 * @param output_stream A reference of std::ostream indicates the stream to be written.
+	 * @param name A reference of const string indicates the name.
+	 */
+	void write_name(std::ostream& output_stream, const std::string& name)
+	{
+		write_value(output_stream, static_cast<std::uint32_t>(name.size()));
+		output_stream.write(name.data(), static_cast<std::streamsize>(name.size()));
+		for (std::size_t i = name.size(); i % 4 != 0; ++i)
+			output_stream.put('\0');
+	}
+
+	/**
+	 * Reads values out of the mapped pack file's memory, every read is checked against the file's size.
+	 */
+	struct PackReader
+	{
+		const std::uint8_t* m_data_ptr;
+		std::size_t m_size;
+		std::size_t m_pos;
+
+		/**
+		 * Read the input value's bytes.
+		 * @param value A reference of T indicates the value to be filled.
+		 * @return A bool indicates whether the file holds enough bytes.
+		 */
+		template<typename T>
+		bool read_value(T& value)
+		{
+			if (m_size - m_pos < sizeof(T))
+				return false;
+			std::memcpy(&value, m_data_ptr + m_pos, sizeof(T));
+			m_pos += sizeof(T);
+			return true;
+		}
+
+		/**
+		 * Read a name written by write_name.
+		 * @param name A reference of string to be filled.
+		 * @return A bool indicates whether the file holds enough bytes.
+		 */
+		bool read_name(std::string& name)
+		{
+			std::uint32_t name_size{0};
+			if (!this->read_value(name_size) || m_size - m_pos < (name_size + 3ull) / 4 * 4)
+				return false;
+			name.assign(reinterpret_cast<const char*>(m_data_ptr + m_pos), name_size);
+			m_pos += (name_size + 3ull) / 4 * 4;
+			return true;
+		}
+
+		/**
+		 * Check whether a data block lies inside the file.
+		 * @param offset A std::uint64_t indicates the block's offset.
+		 * @param size A std::uint64_t indicates the block's size.
+		 * @return A bool indicates whether the block lies inside the file.
+		 */
+		bool contains(std::uint64_t offset, std::uint64_t size) const
+		{
+			return offset <= m_size && size <= m_size - offset;
+		}
+	};
+}
+
+AssetPack::~AssetPack()
+{
+	this->close();
+}
+
+bool AssetPack::write(const std::string& pack_path, const std::vector<PackedTexture>& textures_vec,
+	const std::vector<PackedFont>& fonts_vec)
+{
+	// Calculate the tables' size so each data block's offset is known before writing.
+	std::uint64_t tables_size = 4 * sizeof(std::uint32_t);
+	for (const auto& each_texture : textures_vec)
+		tables_size += get_name_size(each_texture.m_name) + 7 * sizeof(std::uint32_t) +
+			each_texture.m_animations_vec.size() * 3 * sizeof(std::uint32_t) + sizeof(std::uint64_t);
+	for (const auto& each_font : fonts_vec)
+		tables_size += get_name_size(each_font.m_name) + 2 * sizeof(std::uint64_t);
+
+	std::vector<std::uint64_t> texture_offsets_vec;
+	std::vector<std::uint64_t> font_offsets_vec;
+	std::uint64_t data_offset = align_size(tables_size);
+	for (const auto& each_texture : textures_vec)
+	{
+		texture_offsets_vec.push_back(data_offset);
+		data_offset = align_size(data_offset + 4ull * each_texture.m_width * each_texture.m_height);
+	}
+	for (const auto& each_font : fonts_vec)
+	{
+		font_offsets_vec.push_back(data_offset);
+		data_offset = align_size(data_offset + each_font.m_size);
+	}
+
+	// Write into a temporary file first, so a failed write never damages the existing pack.
+	const std::string temp_pack_path(pack_path + TEMP_FILE_SUFFIX);
+	std::ofstream output_file(temp_pack_path, std::ios::out | std::ios::binary | std::ios::trunc);
+	write_value(output_file, ASSET_PACK_FILE_MAGIC);
+	write_value(output_file, ASSET_PACK_FILE_VERSION);
+	write_value(output_file, static_cast<std::uint32_t>(textures_vec.size()));
+	write_value(output_file, static_cast<std::uint32_t>(fonts_vec.size()));
+	for (std::size_t i = 0; i < textures_vec.size(); ++i)
+	{
+		const PackedTexture& texture = textures_vec[i];
+		write_name(output_file, texture.m_name);
+		write_value(output_file, texture.m_width);
+		write_value(output_file, texture.m_height);
+		write_value(output_file, static_cast<std::int32_t>(texture.m_frame_rect.left));
+		write_value(output_file, static_cast<std::int32_t>(texture.m_frame_rect.top));
+		write_value(output_file, static_cast<std::int32_t>(texture.m_frame_rect.width));
+		write_value(output_file, static_cast<std::int32_t>(texture.m_frame_rect.height));
+		write_value(output_file, static_cast<std::uint32_t>(texture.m_animations_vec.size()));
+		for (const auto& each_anim : texture.m_animations_vec)
+		{
+			write_value(output_file, each_anim.m_start_frame);
+			write_value(output_file, each_anim.m_end_frame);
+			write_value(output_file, each_anim.m_duration);
+		}
+		write_value(output_file, texture_offsets_vec[i]);
+	}
+	for (std::size_t i = 0; i < fonts_vec.size(); ++i)
+	{
+		write_name(output_file, fonts_vec[i].m_name);
+		write_value(output_file, font_offsets_vec[i]);
+		write_value(output_file, static_cast<std::uint64_t>(fonts_vec[i].m_size));
+	}
+
+	// Write each data block at its aligned offset.
+	const auto write_block = [&output_file](std::uint64_t offset, const void* data_ptr, std::size_t size)
+	{
+		while (static_cast<std::uint64_t>(output_file.tellp()) < offset)
+			output_file.put('\0');
+		output_file.write(static_cast<const char*>(data_ptr), static_cast<std::streamsize>(size));
+	};
+	for (std::size_t i = 0; i < textures_vec.size(); ++i)
+		write_block(texture_offsets_vec[i], textures_vec[i].m_pixels_ptr,
+			4ull * textures_vec[i].m_width * textures_vec[i].m_height);
+	for (std::size_t i = 0; i < fonts_vec.size(); ++i)
+		write_block(font_offsets_vec[i], fonts_vec[i].m_data_ptr, fonts_vec[i].m_size);
+
+	// Close the file and check if everything has been written.
+	output_file.close();
+	if (output_file.fail())
+	{
+		std::cerr << "Error, failed to write asset pack file " << temp_pack_path << '\n';
+		return false;
+	}
+	return CitySnapshot::commit_file(temp_pack_path, pack_path);
+}
+
+bool AssetPack::open(const std::string& pack_path)
+{
+	this->close();
+
+	// Map the whole file, or read it on platforms without memory mapping.
+#ifdef _WIN32
+	std::ifstream input_file(pack_path, std::ios::in | std::ios::binary | std::ios::ate);
+	if (input_file.fail())
+		return false;
+	m_data_vec.resize(static_cast<std::size_t>(input_file.tellg()));
+	input_file.seekg(0);
+	input_file.read(reinterpret_cast<char*>(m_data_vec.data()), static_cast<std::streamsize>(m_data_vec.size()));
+	m_data_ptr = m_data_vec.data();
+	m_size = m_data_vec.size();
+#else
+	const int file_descriptor = ::open(pack_path.c_str(), O_RDONLY);
+	if (file_descriptor < 0)
+		return false;
+	struct stat file_stat{};
+	if (::fstat(file_descriptor, &file_stat) == 0 && file_stat.st_size > 0)
+	{
+		void* mapping_ptr = ::mmap(nullptr, static_cast<std::size_t>(file_stat.st_size), PROT_READ, MAP_PRIVATE,
+			file_descriptor, 0);
+		if (mapping_ptr != MAP_FAILED)
+		{
+			m_data_ptr = static_cast<const std::uint8_t*>(mapping_ptr);
+			m_size = static_cast<std::size_t>(file_stat.st_size);
+		}
+	}
+	// The mapping stays valid after the file is closed.
+	::close(file_descriptor);
+#endif
+
+	// Check the header and read the tables.
+	PackReader reader{m_data_ptr, m_size, 0};
+	std::uint32_t header_arr[4]{};
+	bool is_valid = m_data_ptr != nullptr && reader.read_value(header_arr) && header_arr[0] == ASSET_PACK_FILE_MAGIC &&
+		header_arr[1] == ASSET_PACK_FILE_VERSION;
+	if (is_valid)
+	{
+		m_textures_vec.resize(header_arr[2]);
+		m_fonts_vec.resize(header_arr[3]);
+	}
+	for (std::size_t i = 0; is_valid && i < m_textures_vec.size(); ++i)
+	{
+		PackedTexture& texture = m_textures_vec[i];
+		std::int32_t frame_rect_arr[4]{};
+		std::uint32_t animations_num{0};
+		std::uint64_t pixels_offset{0};
+		is_valid = reader.read_name(texture.m_name) && reader.read_value(texture.m_width) &&
+			reader.read_value(texture.m_height) && reader.read_value(frame_rect_arr) &&
+			reader.read_value(animations_num) && animations_num <= reader.m_size / (3 * sizeof(std::uint32_t));
+		if (!is_valid)
+			break;
+		texture.m_frame_rect = sf::IntRect(frame_rect_arr[0], frame_rect_arr[1], frame_rect_arr[2], frame_rect_arr[3]);
+		texture.m_animations_vec.resize(animations_num);
+		for (auto& each_anim : texture.m_animations_vec)
+			is_valid = is_valid && reader.read_value(each_anim.m_start_frame) &&
+				reader.read_value(each_anim.m_end_frame) && reader.read_value(each_anim.m_duration);
+		is_valid = is_valid && reader.read_value(pixels_offset) &&
+			reader.contains(pixels_offset, 4ull * texture.m_width * texture.m_height);
+		texture.m_pixels_ptr = is_valid ? m_data_ptr + pixels_offset : nullptr;
+	}
+	for (std::size_t i = 0; is_valid && i < m_fonts_vec.size(); ++i)
+	{
+		PackedFont& font = m_fonts_vec[i];
+		std::uint64_t data_offset{0};
+		std::uint64_t data_size{0};
+		is_valid = reader.read_name(font.m_name) && reader.read_value(data_offset) && reader.read_value(data_size) &&
+			reader.contains(data_offset, data_size);
+		font.m_data_ptr = is_valid ? m_data_ptr + data_offset : nullptr;
+		font.m_size = static_cast<std::size_t>(data_size);
+	}
+
+	if (!is_valid)
+	{
+		std::cerr << "Error, invalid asset pack file " << pack_path << ", loose asset files are used instead\n";
+		this->close();
+		return false;
+	}
+	return true;
+}
+
+void AssetPack::close()
+{
+#ifndef _WIN32
+	if (m_data_ptr != nullptr)
+		::munmap(const_cast<std::uint8_t*>(m_data_ptr), m_size);
+#endif
+	m_data_ptr = nullptr;
+	m_size = 0;
+	m_data_vec.clear();
+	m_data_vec.shrink_to_fit();
+	m_textures_vec.clear();
+	m_fonts_vec.clear();
+}
+
+bool AssetPack::is_open() const
+{
+	return m_data_ptr != nullptr;
+}
+
+const std::vector<PackedTexture>& AssetPack::get_textures() const
+{
+	return m_textures_vec;
+}
+
+const PackedTexture* AssetPack::find_texture(const std::string& texture_name) const
+{
+	for (const auto& each_texture : m_textures_vec)
+	{
+		if (each_texture.m_name == texture_name)
+			return &each_texture;
+	}
+	return nullptr;
+}
+
+const PackedFont* AssetPack::find_font(const std::string& font_name) const
+{
+	for (const auto& each_font : m_fonts_vec)
+	{
+		if (each_font.m_name == font_name)
+			return &each_font;
+	}
+	return nullptr;
+}
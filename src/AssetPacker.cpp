@@ -0,0 +1,73 @@
+// The offline asset packer, which bakes all game textures and the font into one asset pack file without any window.
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include "AssetPack.hpp"
+#include "Game.hpp"
+
+int main(int argc, char* argv[])
+{
+	// Write the pack where the game looks for it unless another path is chosen(--output <path>).
+	std::string pack_path(ASSET_PACK_PATH);
+	for (int i = 1; i < argc; ++i)
+	{
+		if (argv[i] == PACK_OUTPUT_OPTION_STR && i + 1 < argc)
+			pack_path = argv[++i];
+		else
+		{
+			std::cerr << "Usage: citybuilder_packer [" << PACK_OUTPUT_OPTION_STR << " <pack path>]\n";
+			return 1;
+		}
+	}
+
+	// Decode all game images, decoding needs no OpenGL context.
+	std::vector<sf::Image> image_vec;
+	double decode_sum_ms{0.0};
+	TextureManager::decodeImages(Game::get_game_texture_paths(), image_vec, decode_sum_ms);
+
+	// Pack each image's pixels with the frame rect and animations of the tile which uses it.
+	std::vector<PackedTexture> textures_vec;
+	const std::vector<std::string>& texture_name_vec = Game::get_game_texture_names();
+	for (std::size_t i = 0; i < texture_name_vec.size(); ++i)
+	{
+		const sf::Vector2u image_size = image_vec[i].getSize();
+		if (image_vec[i].getPixelsPtr() == nullptr)
+		{
+			std::cerr << "Error, cannot load image " << Game::get_game_texture_paths()[i] << '\n';
+			return 1;
+		}
+
+		PackedTexture texture;
+		texture.m_name = texture_name_vec[i];
+		texture.m_width = image_size.x;
+		texture.m_height = image_size.y;
+		texture.m_pixels_ptr = image_vec[i].getPixelsPtr();
+		// Textures which are not tiles, like the background, are one whole frame without animations.
+		texture.m_frame_rect = Game::get_tile_frame_rect(texture.m_name);
+		if (texture.m_frame_rect.width == 0)
+			texture.m_frame_rect = sf::IntRect(0, 0, static_cast<int>(image_size.x), static_cast<int>(image_size.y));
+		for (const auto& each_anim : Game::get_tile_animations(texture.m_name))
+			texture.m_animations_vec.push_back({ each_anim.getStartFrame(), each_anim.getEndFrame(),
+												 each_anim.getDuration() });
+		textures_vec.push_back(std::move(texture));
+	}
+
+	// Pack the font file as it is.
+	std::ifstream font_file(FONT_PATH, std::ios::in | std::ios::binary);
+	if (font_file.fail())
+	{
+		std::cerr << "Error, cannot load font " << FONT_PATH << '\n';
+		return 1;
+	}
+	const std::vector<char> font_data_vec((std::istreambuf_iterator<char>(font_file)),
+		std::istreambuf_iterator<char>());
+	PackedFont font;
+	font.m_name = FONT_NAME;
+	font.m_data_ptr = font_data_vec.data();
+	font.m_size = font_data_vec.size();
+
+	if (!AssetPack::write(pack_path, textures_vec, { font }))
+		return 1;
+	std::cout << "Packed " << textures_vec.size() << " textures and 1 font into " << pack_path << '\n';
+	return 0;
+}
@@ -0,0 +1,104 @@
+#include <cstdio>
+#include "ActionJournal.hpp"
+#include "AutoSaver.hpp"
+#include "City.hpp"
+#include "Utility.hpp"
+
+AutoSaver::AutoSaver(const SaveSlot& slot, unsigned int interval_days) : m_slot(slot), m_interval_days(interval_days)
+{
+	m_save_thread = std::thread(&AutoSaver::save_loop, this);
+}
+
+AutoSaver::~AutoSaver()
+{
+	// Let the background saving thread finish the pending snapshot and then exit.
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_is_stopping = true;
+	}
+	m_condition.notify_all();
+	m_save_thread.join();
+}
+
+void AutoSaver::update(City& city)
+{
+	// Start counting from the day the city was loaded.
+	if (!m_is_started)
+	{
+		m_last_saved_day = city.get_day();
+		m_is_started = true;
+		return;
+	}
+
+	/* Skip this frame if the background saving thread holds the lock, the snapshot buffer is owned by it until the
+	 * write finishes. */
+	std::unique_lock<std::mutex> lock(m_mutex, std::try_to_lock);
+	if (!lock.owns_lock())
+		return;
+
+	/* Swap in the journal compacted by the background saving thread. Only this is done here since the main thread
+	 * appends to the journal. */
+	if (m_has_compacted_journal)
+	{
+		city.finish_journal_compaction(m_journal_read_size);
+		m_has_compacted_journal = false;
+	}
+
+	// Do nothing until enough game days have elapsed or the journal is full, or if previous snapshot is not written.
+	if ((city.get_day() < m_last_saved_day + m_interval_days && !city.is_journal_full()) || m_has_pending_snapshot)
+		return;
+
+	/* Capture the snapshot on the main thread so that it is consistent with the current frame. The buffer still holds
+	 * the last autosave, so only the chunks changed since then are copied. */
+	city.update_snapshot(m_snapshot);
+	m_has_pending_snapshot = true;
+	m_last_saved_day = city.get_day();
+	lock.unlock();
+	m_condition.notify_all();
+}
+
+void AutoSaver::wait()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_condition.wait(lock, [this] { return !m_has_pending_snapshot; });
+	if (m_has_compacted_journal)
+	{
+		std::remove((m_slot.get_journal_path() + TEMP_FILE_SUFFIX).c_str());
+		m_has_compacted_journal = false;
+	}
+}
+
+bool AutoSaver::is_busy()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_has_pending_snapshot;
+}
+
+void AutoSaver::save_loop()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while (true)
+	{
+		// Wait until there is a snapshot to write or the AutoSaver is destroyed.
+		m_condition.wait(lock, [this] { return m_has_pending_snapshot || m_is_stopping; });
+		if (!m_has_pending_snapshot)
+			return;
+
+		/* Write the snapshot and then rewrite the journal without the records it includes, all without holding the
+		 * lock. Main thread only checks m_has_pending_snapshot and never touches m_snapshot while it is set. */
+		lock.unlock();
+		std::size_t journal_read_size{0};
+		const bool is_compacted = m_snapshot.save(m_slot) && ActionJournal::prepare_compaction(
+			m_slot.get_journal_path(), m_snapshot.m_journal_seq, journal_read_size);
+		lock.lock();
+
+		// Mark the snapshot as written and wake up waiters.
+		if (is_compacted)
+		{
+			m_has_compacted_journal = true;
+			m_journal_read_size = journal_read_size;
+		}
+		m_has_pending_snapshot = false;
+		m_condition.notify_all();
+	}
+}
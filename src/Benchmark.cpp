@@ -0,0 +1,776 @@
+// The entrance of the benchmark runner, which times map and city operations on synthetic maps of several sizes.
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+#include "City.hpp"
+#include "CitySnapshot.hpp"
+#include "JobSystem.hpp"
+#include "MapChunkFile.hpp"
+#include "PopulationKernel.hpp"
+#include "Utility.hpp"
+
+/**
+ * The timing of one benchmark on one map size.
+ */
+struct BenchResult
+{
+	// Name of the benchmark.
+	std::string m_name;
+	// Width and height of the synthetic map.
+	unsigned int m_size{0};
+	// Proportion of non-road tiles which are zones.
+	double m_density{0.0};
+	// Amount of timed iterations.
+	std::size_t m_iterations_num{0};
+	// Mean, median and minimum time of one iteration in milliseconds.
+	double m_mean_ms{0.0};
+	double m_median_ms{0.0};
+	double m_min_ms{0.0};
+};
+
+/**
+ * Generate a synthetic city: a road grid every 8 tiles, and each other tile is a zone by the input density or a random
+ * natural tile otherwise. Zones get random population and industrial zones random production.
+ * @param size A unsigned integer indicates the map's width and height.
+ * @param density A double indicates the proportion of non-road tiles which are zones.
+ * @param seed A unsigned integer indicates the random number generator's seed, also used as the city's seed.
+ * @param snapshot A reference of CitySnapshot to be filled with the city.
+ */
+static void make_city(unsigned int size, double density, unsigned int seed, CitySnapshot& snapshot)
+{
+	std::mt19937 rng(seed);
+	std::uniform_real_distribution<double> density_dist(0.0, 1.0);
+	snapshot.m_name = "Benchmark";
+	snapshot.m_width = size;
+	snapshot.m_height = size;
+	snapshot.m_birth_rate_per_day = CITY_BIRTH_RATE_PER_DAY;
+	snapshot.m_death_rate_per_day = CITY_DEATH_RATE_PER_DAY;
+	snapshot.m_residential_tax_rate = CITY_RESIDENTIAL_TAX_RATE;
+	snapshot.m_commercial_tax_rate = CITY_COMMERCIAL_TAX_RATE;
+	snapshot.m_industrial_tax_rate = CITY_INDUSTRIAL_TAX_RATE;
+	snapshot.m_seed = seed;
+	snapshot.m_tiles_vec.assign(static_cast<std::size_t>(size) * size, TileSnapshot());
+	for (std::size_t i = 0; i < snapshot.m_tiles_vec.size(); ++i)
+	{
+		const unsigned int x = static_cast<unsigned int>(i % size);
+		const unsigned int y = static_cast<unsigned int>(i / size);
+		TileSnapshot& tile = snapshot.m_tiles_vec[i];
+		tile.m_resource = EACH_TILE_PRODUCTION;
+		if (x % 8 == 0 || y % 8 == 0)
+			tile.m_tileType = TileTypeEnum::ROAD;
+		else if (density_dist(rng) < density)
+		{
+			const TileTypeEnum zone_type_arr[3]{ TileTypeEnum::RESIDENTIAL, TileTypeEnum::COMMERCIAL,
+												 TileTypeEnum::INDUSTRIAL };
+			tile.m_tileType = zone_type_arr[rng() % 3];
+			tile.m_population = rng() % (RESIDENTIAL_CURR_LEVEL_POPULATION_LIMIT + 1);
+			if (tile.m_tileType == TileTypeEnum::INDUSTRIAL)
+				tile.m_total_production = static_cast<float>(rng() % (INDUSTRIAL_CURR_LEVEL_POPULATION_LIMIT + 1));
+		}
+		else
+		{
+			// The same natural tile ratio as newly generated maps.
+			const unsigned int random_num = rng() % 10;
+			tile.m_tileType = random_num < 2 ? TileTypeEnum::FOREST : (random_num < 4 ? TileTypeEnum::WATER :
+				TileTypeEnum::GRASS);
+		}
+	}
+}
+
+/**
+ * Saturate a synthetic city: every zone tile is full at its maximum level and nothing is left to extract, so every tile
+ * falls asleep. Industrial tiles have no production, and every other one keeps losing production each day, so the city
+ * is steady from the start. Stocked industrial tiles keep a large total production instead, which commercial tiles
+ * take every day, so the city never becomes steady although all of its tiles sleep.
+ * @param snapshot A reference of CitySnapshot indicates the city to be saturated.
+ * @param is_stocked A bool indicates whether industrial tiles start with a large total production.
+ */
+static void saturate_city(CitySnapshot& snapshot, bool is_stocked)
+{
+	bool is_production_lost{false};
+	for (auto& tile : snapshot.m_tiles_vec)
+	{
+		tile.m_resource = 0;
+		if (tile.m_tileType == TileTypeEnum::RESIDENTIAL)
+		{
+			tile.m_level = RESIDENTIAL_TILE_MAX_LEVEL;
+			tile.m_population = RESIDENTIAL_CURR_LEVEL_POPULATION_LIMIT * (tile.m_level + 1);
+		}
+		else if (tile.m_tileType == TileTypeEnum::COMMERCIAL)
+		{
+			tile.m_level = COMMERCIAL_TILE_MAX_LEVEL;
+			tile.m_population = COMMERCIAL_CURR_LEVEL_POPULATION_LIMIT * (tile.m_level + 1);
+		}
+		else if (tile.m_tileType == TileTypeEnum::INDUSTRIAL)
+		{
+			tile.m_level = INDUSTRIAL_TILE_MAX_LEVEL;
+			tile.m_population = INDUSTRIAL_CURR_LEVEL_POPULATION_LIMIT * (tile.m_level + 1);
+			tile.m_total_production = is_stocked ? BENCH_FAST_FORWARD_STOCK_PRODUCTION : 0.f;
+			tile.m_production_per_day = is_production_lost ? -1.f : 0.f;
+			is_production_lost = !is_production_lost;
+		}
+	}
+}
+
+/**
+ * Check that advancing a synthetic city by many days at once gives the same city as stepping each of those days, with
+ * both residential passes. The city is first stepped to BENCH_FAST_FORWARD_START_DAY, either saturated so the serial
+ * pass skips the steady days, saturated and stocked so every day is stepped while all tiles sleep, or as generated so
+ * it is stepped until it becomes steady if ever.
+ * @param seed A unsigned integer indicates the seed of the synthetic city.
+ * @param str_tile_map A reference of unordered_map indicates the mappings of each type Tile object's name and related
+ * Tile object.
+ * @return A bool indicates whether every advanced city has the same state hash as the stepped one.
+ */
+static bool check_fast_forward(unsigned int seed, std::unordered_map<std::string, Tile>& str_tile_map)
+{
+	bool is_equivalent{true};
+	for (const std::string city_kind : { "saturated", "stocked", "generated" })
+	{
+		CitySnapshot start_snapshot;
+		make_city(BENCH_FAST_FORWARD_MAP_SIZE, 1.0, seed, start_snapshot);
+		if (city_kind != "generated")
+			saturate_city(start_snapshot, city_kind == "stocked");
+		City city;
+		city.restore_snapshot(start_snapshot, str_tile_map);
+		city.updateTiles();
+		while (city.get_day() < BENCH_FAST_FORWARD_START_DAY)
+			city.update(0.f);
+		city.take_snapshot(start_snapshot);
+
+		for (const bool is_parallel : { false, true })
+			for (const auto days_num : { BENCH_FAST_FORWARD_SHORT_DAYS_NUM, BENCH_FAST_FORWARD_LONG_DAYS_NUM })
+			{
+				CitySnapshot advanced_snapshot;
+				city.restore_snapshot(start_snapshot, str_tile_map);
+				city.set_residential_pass_parallel(is_parallel);
+				const auto start_time = std::chrono::steady_clock::now();
+				city.advanceDays(days_num);
+				const double advance_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() -
+					start_time).count();
+				city.take_snapshot(advanced_snapshot);
+
+				CitySnapshot stepped_snapshot;
+				city.restore_snapshot(start_snapshot, str_tile_map);
+				city.set_residential_pass_parallel(is_parallel);
+				for (unsigned int i = 0; i < days_num; ++i)
+					city.update(0.f);
+				city.take_snapshot(stepped_snapshot);
+
+				const bool is_matched = advanced_snapshot.get_hash() == stepped_snapshot.get_hash();
+				is_equivalent = is_equivalent && is_matched;
+				std::cerr << "fast_forward " << city_kind << " " <<
+				(is_parallel ? RESIDENTIAL_PASS_PARALLEL_STR : RESIDENTIAL_PASS_SERIAL_STR) << " " << days_num <<
+				" days: " << advance_ms << " ms" << (is_matched ? ", matches stepping" : ", MISMATCHES STEPPING") <<
+				"\n";
+			}
+	}
+	return is_equivalent;
+}
+
+/**
+ * Time one benchmark. It is iterated until the timed iterations add up to the minimum time, or until the maximum amount
+ * of iterations, but at least once.
+ * @param name A reference of const string indicates the benchmark's name.
+ * @param size A unsigned integer indicates the map's width and height.
+ * @param density A double indicates the proportion of non-road tiles which are zones.
+ * @param min_time_ms A double indicates the minimum time in milliseconds.
+ * @param reset_func A reference of const function called before each iteration without being timed, may be empty.
+ * @param iteration_func A reference of const function which runs the iteration of the input index.
+ * @return A BenchResult indicates the timing.
+ */
+static BenchResult run_benchmark(const std::string& name, unsigned int size, double density, double min_time_ms,
+	const std::function<void()>& reset_func, const std::function<void(std::size_t)>& iteration_func)
+{
+	std::vector<double> times_vec;
+	double total_ms{0.0};
+	while (times_vec.empty() || (total_ms < min_time_ms && times_vec.size() < BENCH_MAX_ITERATIONS_NUM))
+	{
+		if (reset_func)
+			reset_func();
+		const auto start_time = std::chrono::steady_clock::now();
+		iteration_func(times_vec.size());
+		times_vec.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() -
+			start_time).count());
+		total_ms += times_vec.back();
+	}
+
+	BenchResult result;
+	result.m_name = name;
+	result.m_size = size;
+	result.m_density = density;
+	result.m_iterations_num = times_vec.size();
+	result.m_mean_ms = total_ms / times_vec.size();
+	std::sort(times_vec.begin(), times_vec.end());
+	result.m_median_ms = times_vec[times_vec.size() / 2];
+	result.m_min_ms = times_vec.front();
+	std::cerr << name << " " << size << "x" << size << ": median " << result.m_median_ms << " ms over " <<
+	result.m_iterations_num << " iterations\n";
+	return result;
+}
+
+/**
+ * Run all benchmarks on one synthetic map size.
+ * @param size A unsigned integer indicates the map's width and height.
+ * @param density A double indicates the proportion of non-road tiles which are zones.
+ * @param seed A unsigned integer indicates the seed of the synthetic city.
+ * @param min_time_ms A double indicates the minimum time in milliseconds of each benchmark.
+ * @param is_update_timed A bool indicates whether the city update benchmark runs on this size.
+ * @param str_tile_map A reference of unordered_map indicates the mappings of each type Tile object's name and related
+ * Tile object.
+ * @param results_vec A reference of vector to be appended with the results.
+ * @param is_scaled A reference of bool to be cleared if the job system's speedup is checked on this size and falls
+ * below the required parallel efficiency.
+ * @return A bool indicates whether no parallel, SIMD or updated result differs from its serial, scalar or full
+ * reference.
+ */
+static bool run_size(unsigned int size, double density, unsigned int seed, double min_time_ms, bool is_update_timed,
+	std::unordered_map<std::string, Tile>& str_tile_map, std::vector<BenchResult>& results_vec, bool& is_scaled)
+{
+	// Create the synthetic city with up to date road directions and regions, and write its game map file.
+	CitySnapshot snapshot;
+	make_city(size, density, seed, snapshot);
+	City city;
+	city.restore_snapshot(snapshot, str_tile_map);
+	city.updateTiles();
+	city.take_snapshot(snapshot);
+	if (!MapChunkFile::write(BENCH_MAP_PATH, size, size, snapshot.m_tiles_vec))
+		return true;
+	std::shared_ptr<Map> map_ptr = city.get_map_ptr();
+
+	// Each load creates a new map, the previous one is destroyed without being timed.
+	std::shared_ptr<Map> loaded_map_ptr;
+	results_vec.push_back(run_benchmark("map_load", size, density, min_time_ms, [&loaded_map_ptr]()
+	{
+		loaded_map_ptr = std::make_shared<Map>();
+	}, [&loaded_map_ptr, &str_tile_map, size](std::size_t)
+	{
+		loaded_map_ptr->load(BENCH_MAP_PATH, size, size, str_tile_map);
+	}));
+	loaded_map_ptr.reset();
+	results_vec.push_back(run_benchmark("map_save", size, density, min_time_ms, nullptr, [&map_ptr](std::size_t)
+	{
+		map_ptr->save(BENCH_MAP_PATH);
+	}));
+	// Capture the whole city into a reused snapshot, as saving and tracing do.
+	CitySnapshot captured_snapshot;
+	results_vec.push_back(run_benchmark("take_snapshot", size, density, min_time_ms, nullptr,
+		[&city, &captured_snapshot](std::size_t)
+	{
+		city.take_snapshot(captured_snapshot);
+	}));
+	// The autosave's snapshot starts with the whole city, later updates only copy the changed chunks.
+	CitySnapshot autosave_snapshot;
+	city.update_snapshot(autosave_snapshot);
+	results_vec.push_back(run_benchmark("calculate_connected_regions_num", size, density, min_time_ms, nullptr,
+		[&map_ptr](std::size_t)
+	{
+		map_ptr->calculateConnectedRegionsNum({ TileTypeEnum::ROAD, TileTypeEnum::RESIDENTIAL,
+												TileTypeEnum::COMMERCIAL, TileTypeEnum::INDUSTRIAL }, 0);
+	}));
+	results_vec.push_back(run_benchmark("update_direction", size, density, min_time_ms, nullptr,
+		[&map_ptr](std::size_t)
+	{
+		map_ptr->updateDirection(TileTypeEnum::ROAD);
+	}));
+
+	/* Reduce a per-tile kernel over the whole map on one thread and on all of the shared job system's threads, which
+	 * shows the job system's speedup. The fixed chunk size makes both sums equal regardless of the amount of
+	 * threads. */
+	const auto tile_kernel = [&snapshot, size](std::size_t begin, std::size_t end)
+	{
+		std::uint64_t hash{0};
+		for (std::size_t idx = begin; idx < end; ++idx)
+		{
+			std::uint64_t tile_hash = FNV_OFFSET_BASIS;
+			for (unsigned int i = 0; i < BENCH_TILE_KERNEL_ROUNDS_NUM; ++i)
+			{
+				const std::size_t neighbor_idx = (idx + i * size) % snapshot.m_tiles_vec.size();
+				tile_hash = (tile_hash ^ static_cast<std::uint64_t>(snapshot.m_tiles_vec[neighbor_idx].m_tileType)) *
+					FNV_PRIME;
+			}
+			hash += tile_hash;
+		}
+		return hash;
+	};
+	const auto combine_hashes = [](std::uint64_t lhs, std::uint64_t rhs) { return lhs + rhs; };
+	JobSystem serial_job_system(1);
+	std::shared_ptr<JobSystem> job_system_ptr = JobSystem::getInstance();
+	std::uint64_t serial_hash{0};
+	std::uint64_t parallel_hash{0};
+	results_vec.push_back(run_benchmark("tile_kernel_serial", size, density, min_time_ms, nullptr,
+		[&](std::size_t)
+	{
+		serial_hash = serial_job_system.parallel_reduce(0, snapshot.m_tiles_vec.size(), JOB_SYSTEM_MIN_TILES_PER_JOB,
+			std::uint64_t(0), tile_kernel, combine_hashes);
+	}));
+	results_vec.push_back(run_benchmark("tile_kernel_parallel", size, density, min_time_ms, nullptr,
+		[&](std::size_t)
+	{
+		parallel_hash = job_system_ptr->parallel_reduce(0, snapshot.m_tiles_vec.size(), JOB_SYSTEM_MIN_TILES_PER_JOB,
+			std::uint64_t(0), tile_kernel, combine_hashes);
+	}));
+	const BenchResult& serial_result = results_vec[results_vec.size() - 2];
+	const double speedup = serial_result.m_median_ms / std::max(results_vec.back().m_median_ms, 1e-9);
+	const unsigned int threads_num = job_system_ptr->get_threads_num();
+	std::cerr << "tile_kernel " << size << "x" << size << ": speedup " << speedup << "x on " << threads_num <<
+	" threads" << (serial_hash == parallel_hash ? "" : ", MISMATCHED REDUCTION");
+	/* With enough threads, and enough tiles for each of them to steal from, the speedup must be near-linear in the
+	 * checked amount of threads. */
+	if (threads_num >= BENCH_SCALING_THREADS_NUM && snapshot.m_tiles_vec.size() >= threads_num *
+		JOB_SYSTEM_CHUNKS_PER_THREAD * JOB_SYSTEM_MIN_TILES_PER_JOB)
+	{
+		const double min_speedup = BENCH_SCALING_THREADS_NUM * BENCH_MIN_PARALLEL_EFFICIENCY;
+		const bool is_size_scaled = speedup >= min_speedup;
+		is_scaled = is_scaled && is_size_scaled;
+		std::cerr << (is_size_scaled ? ", at least " : ", BELOW ") << min_speedup << "x";
+	}
+	std::cerr << "\n";
+
+	// Grow and clamp one population per tile, at most up to its limit.
+	std::vector<double> limit_vec(snapshot.m_tiles_vec.size());
+	std::vector<double> population_vec(snapshot.m_tiles_vec.size());
+	for (std::size_t i = 0; i < snapshot.m_tiles_vec.size(); ++i)
+	{
+		limit_vec[i] = RESIDENTIAL_CURR_LEVEL_POPULATION_LIMIT * (i % (RESIDENTIAL_TILE_MAX_LEVEL + 1) + 1);
+		population_vec[i] = std::min(static_cast<double>(snapshot.m_tiles_vec[i].m_population), limit_vec[i]);
+	}
+
+	/* Check that every supported instruction set gives bit-identical populations, overflow and total population to the
+	 * scalar kernel. Populations start at, just below and far below their limits, the rate both grows and shrinks them,
+	 * and an odd amount of tiles leaves a tail which no lane group covers completely. */
+	std::vector<double> check_population_vec(population_vec);
+	for (std::size_t i = 0; i < check_population_vec.size(); i += 3)
+	{
+		check_population_vec[i] = limit_vec[i];
+		if (i + 1 < check_population_vec.size())
+			check_population_vec[i + 1] = limit_vec[i + 1] * (1 - BENCH_POPULATION_GROWTH_RATE / 2);
+	}
+	const std::size_t checked_tiles_num = check_population_vec.size() - (check_population_vec.size() % 2 == 0 ? 1 : 0);
+	std::string mismatched_levels_str;
+	for (const double rate : { BENCH_POPULATION_GROWTH_RATE, -BENCH_POPULATION_GROWTH_RATE })
+	{
+		std::vector<double> scalar_population_vec(check_population_vec);
+		double scalar_sums_arr[2]{};
+		grow_and_clamp_populations(scalar_population_vec.data(), limit_vec.data(), checked_tiles_num, rate,
+			scalar_sums_arr[0], scalar_sums_arr[1], SimdLevelEnum::SCALAR);
+		for (int level = static_cast<int>(SimdLevelEnum::SSE2); level <= static_cast<int>(get_simd_level()); ++level)
+		{
+			const SimdLevelEnum simd_level = static_cast<SimdLevelEnum>(level);
+			std::vector<double> simd_population_vec(check_population_vec);
+			double simd_sums_arr[2]{};
+			grow_and_clamp_populations(simd_population_vec.data(), limit_vec.data(), checked_tiles_num, rate,
+				simd_sums_arr[0], simd_sums_arr[1], simd_level);
+			if (simd_population_vec != scalar_population_vec || simd_sums_arr[0] != scalar_sums_arr[0] ||
+				simd_sums_arr[1] != scalar_sums_arr[1])
+				mismatched_levels_str += std::string(" ") + simdLevelToStr(simd_level) + "(rate " +
+					std::to_string(rate) + ")";
+		}
+	}
+
+	// Time the scalar kernel and the widest supported instruction set.
+	std::vector<double> simd_population_vec;
+	for (const auto simd_level : { SimdLevelEnum::SCALAR, get_simd_level() })
+	{
+		simd_population_vec = population_vec;
+		results_vec.push_back(run_benchmark(std::string("population_kernel_") + simdLevelToStr(simd_level), size,
+			density, min_time_ms, nullptr, [&](std::size_t)
+		{
+			double overflow{0};
+			double total_population{0};
+			grow_and_clamp_populations(simd_population_vec.data(), limit_vec.data(), limit_vec.size(),
+				BENCH_POPULATION_GROWTH_RATE, overflow, total_population, simd_level);
+		}));
+	}
+	std::cerr << "population_kernel " << size << "x" << size << ": " << (mismatched_levels_str.empty() ?
+		std::string("every instruction set up to ") + simdLevelToStr(get_simd_level()) + " matches scalar" :
+		"MISMATCHES SCALAR on" + mismatched_levels_str) << "\n";
+
+	// Select rectangles across the map and count the selected tiles, as the selection cost does while dragging.
+	const unsigned int select_rect_size = std::min(BENCH_SELECT_RECT_SIZE, size);
+	results_vec.push_back(run_benchmark("select", size, density, min_time_ms, nullptr,
+		[&city, &map_ptr, select_rect_size, size](std::size_t iteration_idx)
+	{
+		const int pos = static_cast<int>(iteration_idx * select_rect_size % (size - select_rect_size + 1));
+		sf::Vector2i start_pos(pos, pos);
+		sf::Vector2i end_pos(pos + static_cast<int>(select_rect_size) - 1, pos + static_cast<int>(select_rect_size)
+			- 1);
+		city.select(start_pos, end_pos, TileTypeEnum::GRASS);
+		map_ptr->get_selected_tiles_num();
+	}));
+	/* Change one tile's type before each selection as placing does, so each count first rebuilds the changed chunk's
+	 * table. The tile is restored afterwards. */
+	const int placed_tile_idx = static_cast<int>(size / 2 * size + size / 2);
+	const Tile placed_tile = map_ptr->get_tile(placed_tile_idx);
+	results_vec.push_back(run_benchmark("select_after_place", size, density, min_time_ms, nullptr,
+		[&city, &map_ptr, &str_tile_map, placed_tile_idx, select_rect_size, size](std::size_t iteration_idx)
+	{
+		map_ptr->set_tile(placed_tile_idx, str_tile_map.at(tileTypeToStr(iteration_idx % 2 == 0 ? TileTypeEnum::ROAD :
+			TileTypeEnum::GRASS)));
+		const int pos = static_cast<int>(iteration_idx * select_rect_size % (size - select_rect_size + 1));
+		sf::Vector2i start_pos(pos, pos);
+		sf::Vector2i end_pos(pos + static_cast<int>(select_rect_size) - 1, pos + static_cast<int>(select_rect_size)
+			- 1);
+		city.select(start_pos, end_pos, TileTypeEnum::GRASS);
+		map_ptr->get_selected_tiles_num();
+	}));
+	map_ptr->set_tile(placed_tile_idx, placed_tile);
+	map_ptr->deselect_tiles();
+
+	/* Bulldoze rectangles across the map the same way as the player does, then build roads onto the cleared tiles, so
+	 * each iteration replaces tiles. */
+	const unsigned int bulldoze_rect_size = std::min(BENCH_BULLDOZE_RECT_SIZE, size);
+	const unsigned int rects_per_row = size / bulldoze_rect_size;
+	results_vec.push_back(run_benchmark("bulldoze", size, density, min_time_ms, nullptr,
+		[&city, &map_ptr, &str_tile_map, bulldoze_rect_size, rects_per_row](std::size_t iteration_idx)
+	{
+		const std::size_t rect_idx = iteration_idx / 2 % (rects_per_row * rects_per_row);
+		sf::Vector2i start_pos(static_cast<int>(rect_idx % rects_per_row * bulldoze_rect_size),
+			static_cast<int>(rect_idx / rects_per_row * bulldoze_rect_size));
+		sf::Vector2i end_pos(start_pos + sf::Vector2i(bulldoze_rect_size - 1, bulldoze_rect_size - 1));
+		const TileTypeEnum tile_type = iteration_idx % 2 == 0 ? TileTypeEnum::GRASS : TileTypeEnum::ROAD;
+		city.select(start_pos, end_pos, tile_type);
+		city.bulldoze(str_tile_map.at(tileTypeToStr(tile_type)));
+		city.update_bulldozed_tiles();
+		map_ptr->deselect_tiles();
+	}));
+	/* Bulldoze one more rectangle before each autosave's capture without being timed, so each capture copies the
+	 * chunks changed by one placement. */
+	std::size_t bulldozed_num{0};
+	results_vec.push_back(run_benchmark("update_snapshot_after_bulldoze", size, density, min_time_ms,
+		[&city, &map_ptr, &str_tile_map, &bulldozed_num, bulldoze_rect_size, rects_per_row]()
+	{
+		const std::size_t rect_idx = bulldozed_num / 2 % (rects_per_row * rects_per_row);
+		sf::Vector2i start_pos(static_cast<int>(rect_idx % rects_per_row * bulldoze_rect_size),
+			static_cast<int>(rect_idx / rects_per_row * bulldoze_rect_size));
+		sf::Vector2i end_pos(start_pos + sf::Vector2i(bulldoze_rect_size - 1, bulldoze_rect_size - 1));
+		const TileTypeEnum tile_type = bulldozed_num++ % 2 == 0 ? TileTypeEnum::GRASS : TileTypeEnum::ROAD;
+		city.select(start_pos, end_pos, tile_type);
+		city.bulldoze(str_tile_map.at(tileTypeToStr(tile_type)));
+		city.update_bulldozed_tiles();
+		map_ptr->deselect_tiles();
+	}, [&city, &autosave_snapshot](std::size_t)
+	{
+		city.update_snapshot(autosave_snapshot);
+	}));
+	city.take_snapshot(captured_snapshot);
+	bool is_snapshot_updated = autosave_snapshot.get_hash() == captured_snapshot.get_hash();
+
+	// Simulate days on a fresh copy of the synthetic city, each update call processes one day.
+	if (is_update_timed)
+	{
+		city.restore_snapshot(snapshot, str_tile_map);
+		results_vec.push_back(run_benchmark("city_update", size, density, min_time_ms, nullptr, [&city](std::size_t)
+		{
+			city.update(0.f);
+		}));
+		// Simulate the same days again with the parallel residential pass.
+		city.restore_snapshot(snapshot, str_tile_map);
+		city.set_residential_pass_parallel(true);
+		results_vec.push_back(run_benchmark("city_update_parallel", size, density, min_time_ms, nullptr,
+			[&city](std::size_t)
+		{
+			city.update(0.f);
+		}));
+		/* Capture the changes of one more day into the autosave's snapshot, as an autosave right after a day does. A
+		 * day is far slower than the capture, so only one is timed. */
+		city.update_snapshot(autosave_snapshot);
+		results_vec.push_back(run_benchmark("update_snapshot_after_day", size, density, 0.0, [&city]()
+		{
+			city.update(0.f);
+		}, [&city, &autosave_snapshot](std::size_t)
+		{
+			city.update_snapshot(autosave_snapshot);
+		}));
+		city.take_snapshot(captured_snapshot);
+		is_snapshot_updated = is_snapshot_updated && autosave_snapshot.get_hash() == captured_snapshot.get_hash();
+	}
+	std::cerr << "update_snapshot " << size << "x" << size << ": " << (is_snapshot_updated ? "matches take_snapshot" :
+		"MISMATCHES take_snapshot") << "\n";
+	std::remove(BENCH_MAP_PATH.c_str());
+	return serial_hash == parallel_hash && mismatched_levels_str.empty() && is_snapshot_updated;
+}
+
+/**
+ * Write the results as JSON, one result object per line.
+ * @param output_stream A reference of std::ostream indicates the stream to be written.
+ * @param results_vec A reference of const vector indicates the results.
+ */
+static void write_json(std::ostream& output_stream, const std::vector<BenchResult>& results_vec)
+{
+	output_stream << "{\"benchmarks\":[";
+	for (std::size_t i = 0; i < results_vec.size(); ++i)
+	{
+		const BenchResult& result = results_vec[i];
+		output_stream << (i == 0 ? "\n" : ",\n") << "{\"name\":\"" << result.m_name << "\",\"size\":" <<
+		result.m_size << ",\"density\":" << result.m_density << ",\"iterations\":" << result.m_iterations_num <<
+		",\"mean_ms\":" << result.m_mean_ms << ",\"median_ms\":" << result.m_median_ms << ",\"min_ms\":" <<
+		result.m_min_ms << '}';
+	}
+	output_stream << "\n]}\n";
+}
+
+/**
+ * Write the results as CSV with a header line.
+ * @param output_stream A reference of std::ostream indicates the stream to be written.
+ * @param results_vec A reference of const vector indicates the results.
+ */
+static void write_csv(std::ostream& output_stream, const std::vector<BenchResult>& results_vec)
+{
+	output_stream << "name,size,density,iterations,mean_ms,median_ms,min_ms\n";
+	for (const auto& result : results_vec)
+		output_stream << result.m_name << ',' << result.m_size << ',' << result.m_density << ',' <<
+		result.m_iterations_num << ',' << result.m_mean_ms << ',' << result.m_median_ms << ',' << result.m_min_ms <<
+		'\n';
+}
+
+/**
+ * Retrieve the value of a field inside one line of the JSON written by write_json.
+ * @param line A reference of const string indicates the line.
+ * @param key A pointer of const char indicates the field's name.
+ * @return A std::string indicates the value without quotes, empty if the line has no such field.
+ */
+static std::string get_json_field(const std::string& line, const char* key)
+{
+	const std::string key_str(std::string("\"") + key + "\":");
+	const std::size_t key_pos = line.find(key_str);
+	if (key_pos == std::string::npos)
+		return std::string();
+	std::size_t value_pos = key_pos + key_str.size();
+	if (value_pos < line.size() && line[value_pos] == '"')
+		return line.substr(value_pos + 1, line.find('"', value_pos + 1) - value_pos - 1);
+	return line.substr(value_pos, line.find_first_of(",}", value_pos) - value_pos);
+}
+
+/**
+ * Read the results written by a previous run, either as JSON or as CSV.
+ * @param results_path A reference of const string indicates the results file's path.
+ * @param results_vec A reference of vector to be filled with the results.
+ * @return A bool indicates whether the file exists and holds valid results.
+ */
+static bool read_results(const std::string& results_path, std::vector<BenchResult>& results_vec)
+{
+	std::ifstream input_file(results_path);
+	if (input_file.fail())
+	{
+		std::cerr << "Error, cannot open benchmark results " << results_path << '\n';
+		return false;
+	}
+
+	std::string line;
+	bool is_json{false};
+	bool is_first_line{true};
+	try
+	{
+		while (std::getline(input_file, line))
+		{
+			if (is_first_line)
+			{
+				// JSON results start with the results array, CSV results with the header line.
+				is_json = !line.empty() && line[0] == '{';
+				is_first_line = false;
+				continue;
+			}
+
+			BenchResult result;
+			if (is_json)
+			{
+				result.m_name = get_json_field(line, "name");
+				if (result.m_name.empty())
+					continue;
+				result.m_size = static_cast<unsigned int>(std::stoul(get_json_field(line, "size")));
+				result.m_density = std::stod(get_json_field(line, "density"));
+				result.m_iterations_num = std::stoul(get_json_field(line, "iterations"));
+				result.m_mean_ms = std::stod(get_json_field(line, "mean_ms"));
+				result.m_median_ms = std::stod(get_json_field(line, "median_ms"));
+				result.m_min_ms = std::stod(get_json_field(line, "min_ms"));
+			}
+			else
+			{
+				std::istringstream line_stream(line);
+				std::vector<std::string> fields_vec;
+				for (std::string field; std::getline(line_stream, field, ',');)
+					fields_vec.push_back(field);
+				if (fields_vec.size() != 7)
+					continue;
+				result.m_name = fields_vec[0];
+				result.m_size = static_cast<unsigned int>(std::stoul(fields_vec[1]));
+				result.m_density = std::stod(fields_vec[2]);
+				result.m_iterations_num = std::stoul(fields_vec[3]);
+				result.m_mean_ms = std::stod(fields_vec[4]);
+				result.m_median_ms = std::stod(fields_vec[5]);
+				result.m_min_ms = std::stod(fields_vec[6]);
+			}
+			results_vec.push_back(result);
+		}
+	}
+	catch (const std::exception&)
+	{
+		std::cerr << "Error, invalid benchmark results " << results_path << '\n';
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Compare each result's median time with the previous run's result of the same benchmark and map size, and print
+ * the change of each one.
+ * @param results_vec A reference of const vector indicates the current results.
+ * @param prev_results_vec A reference of const vector indicates the previous results.
+ * @param threshold A double indicates the slowdown in percent beyond which a benchmark is a regression.
+ * @return A unsigned integer indicates the amount of regressions.
+ */
+static unsigned int compare_results(const std::vector<BenchResult>& results_vec,
+	const std::vector<BenchResult>& prev_results_vec, double threshold)
+{
+	std::map<std::pair<std::string, unsigned int>, const BenchResult*> prev_results_map;
+	for (const auto& prev_result : prev_results_vec)
+		prev_results_map[std::make_pair(prev_result.m_name, prev_result.m_size)] = &prev_result;
+
+	unsigned int regressions_num{0};
+	for (const auto& result : results_vec)
+	{
+		const auto prev_result_it = prev_results_map.find(std::make_pair(result.m_name, result.m_size));
+		if (prev_result_it == prev_results_map.end())
+			continue;
+		const BenchResult& prev_result = *prev_result_it->second;
+		const double change = prev_result.m_median_ms > 0.0 ? (result.m_median_ms / prev_result.m_median_ms - 1.0) *
+			100.0 : 0.0;
+		const bool is_regression = change > threshold;
+		regressions_num += is_regression;
+		std::cerr << (is_regression ? "REGRESSION " : "ok         ") << result.m_name << " " << result.m_size << "x" <<
+		result.m_size << ": " << prev_result.m_median_ms << " ms -> " << result.m_median_ms << " ms (" <<
+		std::showpos << change << std::noshowpos << "%)";
+		if (prev_result.m_density != result.m_density)
+			std::cerr << " [density " << prev_result.m_density << " -> " << result.m_density << "]";
+		std::cerr << '\n';
+	}
+	std::cerr << regressions_num << " regression(s) beyond " << threshold << "%\n";
+	return regressions_num;
+}
+
+/**
+ * Run all benchmarks on synthetic maps of each size(--sizes <n,n,...>, 64 to 2048 by default) whose non-road tiles
+ * are zones by the chosen density(--density <0..1>), and write the results as JSON or CSV(--format <json|csv>) into
+ * the standard output or a file(--output <path>). Each benchmark iterates for at least --min-time <ms>, and the city
+ * update benchmark only runs on sizes up to --update-max-size <n>.
+ * With --compare <previous results path>, each result is compared with the previous run's and the process exits with
+ * code 2 if any benchmark becomes slower than --threshold <percent>. It exits with code 3 if a fast-forward, parallel
+ * or SIMD result differs from its reference, and with code 4 if the job system's speedup on at least
+ * BENCH_SCALING_THREADS_NUM threads falls below BENCH_MIN_PARALLEL_EFFICIENCY of that amount.
+ */
+int main(int argc, char* argv[])
+{
+	std::vector<unsigned int> sizes_vec;
+	double density{BENCH_DEFAULT_ZONE_DENSITY};
+	unsigned long seed{0};
+	std::string format_str("json");
+	std::string output_path;
+	double min_time_ms{BENCH_DEFAULT_MIN_TIME_MS};
+	unsigned long update_max_size{BENCH_DEFAULT_UPDATE_MAX_SIZE};
+	std::string compare_path;
+	double threshold{BENCH_DEFAULT_REGRESSION_THRESHOLD};
+	bool is_usage_valid{true};
+	try
+	{
+		for (int i = 1; i < argc; ++i)
+		{
+			if (i + 1 == argc)
+				is_usage_valid = false;
+			else if (argv[i] == BENCH_SIZES_OPTION_STR)
+			{
+				std::istringstream sizes_stream(argv[++i]);
+				for (std::string size_str; std::getline(sizes_stream, size_str, ',');)
+					sizes_vec.push_back(static_cast<unsigned int>(std::stoul(size_str)));
+			}
+			else if (argv[i] == BENCH_DENSITY_OPTION_STR)
+				density = std::stod(argv[++i]);
+			else if (argv[i] == SEED_OPTION_STR)
+				seed = std::stoul(argv[++i]);
+			else if (argv[i] == BENCH_FORMAT_OPTION_STR)
+				format_str = argv[++i];
+			else if (argv[i] == BENCH_OUTPUT_OPTION_STR)
+				output_path = argv[++i];
+			else if (argv[i] == BENCH_MIN_TIME_OPTION_STR)
+				min_time_ms = std::stod(argv[++i]);
+			else if (argv[i] == BENCH_UPDATE_MAX_SIZE_OPTION_STR)
+				update_max_size = std::stoul(argv[++i]);
+			else if (argv[i] == BENCH_COMPARE_OPTION_STR)
+				compare_path = argv[++i];
+			else if (argv[i] == BENCH_THRESHOLD_OPTION_STR)
+				threshold = std::stod(argv[++i]);
+			else
+				is_usage_valid = false;
+		}
+	}
+	catch (const std::exception&)
+	{
+		is_usage_valid = false;
+	}
+	if (sizes_vec.empty())
+		for (unsigned int size = BENCH_MIN_MAP_SIZE; size <= BENCH_MAX_MAP_SIZE; size *= 2)
+			sizes_vec.push_back(size);
+	if (!is_usage_valid || density < 0.0 || density > 1.0 || (format_str != "json" && format_str != "csv") ||
+		std::find(sizes_vec.begin(), sizes_vec.end(), 0u) != sizes_vec.end())
+	{
+		std::cerr << "Usage: citybuilder_bench [" << BENCH_SIZES_OPTION_STR << " <n,n,...>] [" <<
+		BENCH_DENSITY_OPTION_STR << " <0..1>] [" << SEED_OPTION_STR << " <seed>] [" << BENCH_FORMAT_OPTION_STR <<
+		" <json|csv>] [" << BENCH_OUTPUT_OPTION_STR << " <results path>] [" << BENCH_MIN_TIME_OPTION_STR <<
+		" <ms>] [" << BENCH_UPDATE_MAX_SIZE_OPTION_STR << " <n>] [" << BENCH_COMPARE_OPTION_STR <<
+		" <previous results path>] [" << BENCH_THRESHOLD_OPTION_STR << " <percent>]\n";
+		return 1;
+	}
+
+	// Read the previous results first, so a missing file fails before running anything.
+	std::vector<BenchResult> prev_results_vec;
+	if (!compare_path.empty() && !read_results(compare_path, prev_results_vec))
+		return 1;
+
+	std::unordered_map<std::string, Tile> str_tile_map;
+	load_tiles(str_tile_map);
+
+	// Check that fast-forwarding reproduces stepping before timing anything.
+	bool is_equivalent = check_fast_forward(static_cast<unsigned int>(seed), str_tile_map);
+
+	std::vector<BenchResult> results_vec;
+	bool is_scaled{true};
+	for (const auto size : sizes_vec)
+		is_equivalent = run_size(size, density, static_cast<unsigned int>(seed), min_time_ms, size <= update_max_size,
+			str_tile_map, results_vec, is_scaled) && is_equivalent;
+
+	// Write the results into the standard output unless a file is chosen.
+	std::ofstream output_file;
+	if (!output_path.empty())
+	{
+		output_file.open(output_path, std::ios::out | std::ios::trunc);
+		if (output_file.fail())
+		{
+			std::cerr << "Error, cannot create benchmark results " << output_path << '\n';
+			return 1;
+		}
+	}
+	std::ostream& output_stream = output_path.empty() ? std::cout : output_file;
+	output_stream << std::setprecision(6);
+	if (format_str == "json")
+		write_json(output_stream, results_vec);
+	else
+		write_csv(output_stream, results_vec);
+
+	if (!compare_path.empty() && compare_results(results_vec, prev_results_vec, threshold) != 0)
+		return 2;
+	/* A fast-forward which differs from stepping, or a parallel or SIMD result which differs from its serial or scalar
+	 * reference, is a bug rather than a slowdown. */
+	if (!is_equivalent)
+		return 3;
+	// A job system which does not scale on enough threads misses its goal regardless of previous results.
+	if (!is_scaled)
+		return 4;
+	return 0;
+}
@@ -1,11 +1,62 @@
+#include <algorithm>
+#include <limits>
 #include <numeric>
-#include <fstream>
+#include <unordered_set>
 #include "City.hpp"
+#include "CitySnapshot.hpp"
+#include "JobSystem.hpp"
+#include "PopulationKernel.hpp"
+#include "Profiler.hpp"
+#include "ActionJournal.hpp"
+#include "SaveSlot.hpp"
 #include "Tile.hpp"
+#include "TileRandom.hpp"
 #include <random>
-#include <sstream>
 #include "Utility.hpp"
 
+namespace
+{
+	/**
+	 * Retrieve the tile types which cannot be replaced by the specified tile type.
+	 * @param tile_type A TileTypeEnum indicates the tile type which selected tiles will be replaced with.
+	 * @return A reference of const vector indicates the blacklist passed to Map's selection.
+	 */
+	const std::vector<TileTypeEnum>& get_select_blacklist(TileTypeEnum tile_type)
+	{
+		/* If tile_type is grass, then current player action is considered to destroy all exist tiles rather than grass
+		 * tiles. Therefore, grass tiles are considered as black list and all other tiles should be selected. */
+		static const std::vector<TileTypeEnum> bulldoze_blacklist_vec{ TileTypeEnum::GRASS };
+		/* Else current player action is considered to build related new tile. And new tile can only be built on the
+		 * grass tiles. Therefore, all other 7 type of tiles are considered as black list. */
+		static const std::vector<TileTypeEnum> build_blacklist_vec{ TileTypeEnum::VOID, TileTypeEnum::WATER,
+			TileTypeEnum::ROAD, TileTypeEnum::FOREST, TileTypeEnum::RESIDENTIAL, TileTypeEnum::COMMERCIAL,
+			TileTypeEnum::INDUSTRIAL };
+		return tile_type == TileTypeEnum::GRASS ? bulldoze_blacklist_vec : build_blacklist_vec;
+	}
+
+	/**
+	 * One chunk of the parallel residential pass.
+	 */
+	struct ResidentialChunk
+	{
+		// Amount of residential tiles and of tiles hiring people(commercial and industrial) within the chunk.
+		std::size_t m_residential_tiles_num{0};
+		std::size_t m_employing_tiles_num{0};
+		// The chunk's quota of homeless and unemployed people, what is left after the pass goes back to the city.
+		double m_homeless_num{0};
+		double m_unemployment_num{0};
+		// Summed population of the chunk's residential tiles.
+		double m_population{0};
+		/* Indices, populations and population limits of the chunk's residential tiles in update order, gathered so
+		 * that their growth runs through the population kernel. */
+		std::vector<int> m_residential_idx_vec;
+		std::vector<double> m_population_vec;
+		std::vector<double> m_limit_vec;
+		// Indices of the chunk's tiles whose level-up is newly scheduled, queued after all chunks are done.
+		std::vector<int> m_scheduled_idx_vec;
+	};
+}
+
 double City::getHomelessNum() const
 {
 	return m_homeless_num;
@@ -54,24 +105,46 @@ double City::distributeResidents(double& residents_ref, Tile& tile, double rate)
 	return tile.m_population;
 }
 
+void City::select(sf::Vector2i& start_pos, sf::Vector2i& end_pos, TileTypeEnum tile_type)
+{
+	m_map_ptr->select(start_pos, end_pos, get_select_blacklist(tile_type));
+}
+
+unsigned int City::get_selection_cost(const Tile& tile) const
+{
+	return tile.getCost() * m_map_ptr->get_selected_tiles_num();
+}
+
+bool City::place_selection(const Tile& tile)
+{
+	// Nothing to do if no tile is selected or the city's fund is not enough.
+	const unsigned int selected_tiles_cost = this->get_selection_cost(tile);
+	if (m_map_ptr->get_selected_tiles_num() == 0 || m_fund < selected_tiles_cost)
+		return false;
+
+	// Replace all selected tiles.
+	this->bulldoze(tile);
+	// Update city's fund.
+	this->set_fund(m_fund - selected_tiles_cost);
+	// Update road tiles around the replaced tiles and re-calculate connected regions.
+	this->update_bulldozed_tiles();
+	return true;
+}
+
 void City::bulldoze(const Tile& tile)
 {
-	for (size_t i = 0; i < (m_map_ptr->get_width() * m_map_ptr->get_height()); ++i)
+	// Record the selected rectangle and the new tile type, which are enough to repeat this bulldoze.
+	if (m_journal_ptr)
+		m_journal_ptr->append_bulldoze(++m_journal_seq, m_map_ptr->get_selected_start_pos(),
+			m_map_ptr->get_selected_end_pos(), tile.m_tileType);
+
+	// Replace the selected tiles in place, their population become homeless or unemployed.
+	m_map_ptr->replace_selected_tiles(tile, m_homeless_num, m_unemployment_num, m_bulldozed_tile_idx_vec);
+	// Replaced tiles never level up as their previous tiles would have.
+	for (const auto tile_index : m_bulldozed_tile_idx_vec)
 	{
-		// Check if this tile is selected.
-		if (m_map_ptr->get_selected_tile_condition(i) == 1)
-		{
-			// If this tile is Residential tile, then increase homeless number by tile's population.
-			if (m_map_ptr->get_tile(i).m_tileType == TileTypeEnum::RESIDENTIAL)
-				m_homeless_num += m_map_ptr->get_tile(i).m_population;
-			// If this tile is Industrial/Commercial tile, then increase unemployment number by tile's population.
-			else if ( (m_map_ptr->get_tile(i).m_tileType == TileTypeEnum::INDUSTRIAL) ||
-			(m_map_ptr->get_tile(i).m_tileType == TileTypeEnum::COMMERCIAL))
-				m_unemployment_num += m_map_ptr->get_tile(i).m_population;
-
-			// Replace the related original Tile with the new one.
-			m_map_ptr->set_tile(i, tile);
-		}
+		m_level_up_scheduler.cancel_tile(tile_index);
+		m_active_tiles.wake_tile(tile_index);
 	}
 }
 
@@ -83,9 +156,9 @@ void City::shuffleTiles()
 
 	// Assigns every element of m_update_order_related_tile_index_vec successive values starting from 0.
 	std::iota(m_update_order_related_tile_index_vec.begin(), m_update_order_related_tile_index_vec.end(), 0);
-	// Shuffle the m_update_order_related_tile_index_vec in random order.
+	// Shuffle the m_update_order_related_tile_index_vec in random order, which only depends on the city's seed.
 	std::shuffle(m_update_order_related_tile_index_vec.begin(), m_update_order_related_tile_index_vec.end(),
-		std::mt19937(std::random_device()()));
+		std::mt19937(m_seed));
 }
 
 void City::updateTiles()
@@ -97,98 +170,383 @@ void City::updateTiles()
 											 TileTypeEnum::COMMERCIAL, TileTypeEnum::INDUSTRIAL }, 0);
 }
 
-void City::load(const std::string& city_name_str, std::unordered_map<std::string, Tile>& str_tile_map)
+void City::update_bulldozed_tiles()
+{
+	// Update Road Tile objects' direction around the bulldozed tiles only.
+	m_map_ptr->updateDirection(TileTypeEnum::ROAD, m_bulldozed_tile_idx_vec);
+	// Calculate and store the region amount.
+	m_map_ptr->calculateConnectedRegionsNum({ TileTypeEnum::ROAD, TileTypeEnum::RESIDENTIAL,
+											 TileTypeEnum::COMMERCIAL, TileTypeEnum::INDUSTRIAL }, 0);
+}
+
+bool City::load(const SaveSlot& slot, std::unordered_map<std::string, Tile>& str_tile_map,
+	bool is_journaling, std::atomic<unsigned int>* load_progress_ptr, const std::atomic<bool>* load_cancel_ptr)
+{
+	PROFILE_SCOPE("City::load");
+	// Report each finished loading step's progress if required.
+	const auto report_progress = [load_progress_ptr](unsigned int progress)
+	{
+		if (load_progress_ptr != nullptr)
+			load_progress_ptr->store(progress);
+	};
+	// Check between loading steps whether the loading is cancelled.
+	const auto is_cancelled = [load_cancel_ptr]()
+	{
+		return load_cancel_ptr != nullptr && load_cancel_ptr->load();
+	};
+
+	// A new city inside an empty save slot has the default dimension.
+	unsigned int city_width{CITY_DEFAULT_WIDTH};
+	unsigned int city_height{CITY_DEFAULT_HEIGHT};
+	m_name = slot.get_default_name();
+
+	// Read the city's record and all tiles from the game map file.
+	CitySnapshot snapshot;
+	bool is_legacy{false};
+	const bool is_snapshot_loaded = snapshot.load(slot, is_legacy);
+	if (is_snapshot_loaded)
+	{
+		city_width = snapshot.m_width;
+		city_height = snapshot.m_height;
+		this->restore_properties(snapshot);
+	}
+	else
+	{
+		snapshot.m_tiles_vec.clear();
+		m_seed = std::random_device()();
+	}
+	m_is_generated = !is_snapshot_loaded;
+	m_is_legacy = is_legacy;
+	report_progress(CITY_LOAD_SNAPSHOT_PROGRESS);
+	if (is_cancelled())
+		return false;
+
+	// Create the game map from the loaded tiles, or generate a new one.
+	m_map_ptr = std::make_shared<Map>();
+	m_map_ptr->load(snapshot.m_tiles_vec, city_width, city_height, str_tile_map);
+	// Generate the update order and clear the level-ups before replaying any day.
+	this->shuffleTiles();
+	m_level_up_scheduler.reset(m_map_ptr->get_tiles_amount());
+	this->reset_active_tiles();
+	report_progress(CITY_LOAD_MAP_PROGRESS);
+	if (is_cancelled())
+		return false;
+
+	// Bring the loaded snapshot up to date with actions recorded after it.
+	if (is_snapshot_loaded)
+	{
+		ActionJournal journal(slot.get_journal_path());
+		this->replay_journal(journal, str_tile_map);
+	}
+	// A city which does not journal must not touch the save files either.
+	if (is_journaling)
+		this->start_journaling(slot);
+	report_progress(CITY_LOAD_DONE_PROGRESS);
+	return true;
+}
+
+void City::start_journaling(const SaveSlot& slot)
 {
-	unsigned int city_width{0};
-	unsigned int city_height{0};
+	m_journal_ptr = std::make_shared<ActionJournal>(slot.get_journal_path());
+	/* A newly generated city does not match any existing journal. Drop the journal and save the city as the snapshot
+	 * that following records are based on. */
+	if (m_is_generated)
+		m_journal_ptr->compact(std::numeric_limits<std::uint32_t>::max());
+	// Convert saves written by old versions into a single game map file right away.
+	if (m_is_generated || m_is_legacy)
+		this->save(slot);
+	m_is_generated = false;
+	m_is_legacy = false;
+}
 
-	// Create the loaded file.
-	std::ifstream input_file(city_name_str, std::ios::in|std::ios::binary);
+void City::replay_journal(ActionJournal& journal, std::unordered_map<std::string, Tile>& str_tile_map)
+{
+	std::vector<JournalRecord> records_vec;
+	journal.read(m_journal_seq, records_vec);
 
-	std::string each_line_str;
-	// Process each line of the input file.
-	while (std::getline(input_file, each_line_str))
+	// Apply each record in the same way as it was applied when recorded.
+	for (auto& record : records_vec)
 	{
-		std::istringstream input_line_stream(each_line_str);
-		std::string each_property_name;
-		// Store each property name, delimited by '='.
-		if (std::getline(input_line_stream, each_property_name, '='))
+		switch (record.m_type)
 		{
-			std::string each_property_value;
-			// Store each property's value.
-			if (std::getline(input_line_stream, each_property_value))
-			{
-				if(each_property_name == CITY_WIDTH_STR)
-					city_width = std::stoi(each_property_value);
-				else if(each_property_name == CITY_HEIGHT_STR)
-					city_height = std::stoi(each_property_value);
-				else if(each_property_name == CITY_DAY_STR)
-					m_day = std::stoi(each_property_value);
-				else if(each_property_name == CITY_HOMELESS_NUM_STR)
-					m_homeless_num = std::stod(each_property_value);
-				else if(each_property_name == CITY_UNEMPLOYMENT_NUM_STR)
-					m_unemployment_num = std::stod(each_property_value);
-				else if(each_property_name == CITY_POPULATION_STR)
-					m_city_population = std::stod(each_property_value);
-				else if(each_property_name == CITY_EMPLOYABLE_STR)
-					m_employable = std::stod(each_property_value);
-				else if(each_property_name == CITY_BIRTH_RATE_PER_DAY_STR)
-					m_birth_rate_per_day = std::stod(each_property_value);
-				else if(each_property_name == CITY_DEATH_RATE_PER_DAY_STR)
-					m_death_rate_per_day = std::stod(each_property_value);
-				else if(each_property_name == CITY_RESIDENTIAL_TAX_RATE_STR)
-					m_residential_tax_rate = std::stod(each_property_value);
-				else if(each_property_name == CITY_COMMERCIAL_TAX_RATE_STR)
-					m_commercial_tax_rate = std::stod(each_property_value);
-				else if(each_property_name == CITY_INDUSTRIAL_TAX_RATE_STR)
-					m_industrial_tax_rate = std::stod(each_property_value);
-				else if(each_property_name == CITY_FUND_STR)
-					m_fund = std::stod(each_property_value);
-				else if(each_property_name == CITY_CURR_MONTH_EARNINGS_STR)
-					m_curr_month_earnings = std::stod(each_property_value);
-			}
+		case JournalRecordEnum::BULLDOZE:
+			this->select(record.m_start_pos, record.m_end_pos, record.m_tile_type);
+			this->bulldoze(str_tile_map.at(tileTypeToStr(record.m_tile_type)));
+			this->update_bulldozed_tiles();
+			m_map_ptr->deselect_tiles();
+			break;
+		case JournalRecordEnum::FUND:
+			m_fund = record.m_fund;
+			break;
+		case JournalRecordEnum::DAY:
+			this->step_day();
+			if (m_day != record.m_day)
+				std::cerr << "Error, journal replay reached day " << m_day << " instead of " << record.m_day << '\n';
+			break;
+		case JournalRecordEnum::ADVANCE:
+			if (record.m_day >= m_day)
+				this->fast_forward_days(record.m_day - m_day);
 			else
-			{
-				std::cerr << "Error, no property value related with specified property name " << each_property_name
-				<< '\n';
-			}
+				std::cerr << "Error, journal replay cannot advance from day " << m_day << " to " << record.m_day <<
+				'\n';
+			break;
 		}
+		m_journal_seq = record.m_seq;
 	}
+}
 
-	// Close the file and load the game map.
-	input_file.close();
-	m_map_ptr = std::make_shared<Map>();
-	m_map_ptr->load(MAP_BINARY_FILE_PATH, city_width, city_height, str_tile_map);
+void City::save(const SaveSlot& slot)
+{
+	PROFILE_SCOPE("City::save");
+	// Capture the current city and save it into disk.
+	CitySnapshot snapshot;
+	this->take_snapshot(snapshot);
+	// The saved snapshot includes every journal record so far.
+	if (snapshot.save(slot))
+		this->compact_journal(snapshot.m_journal_seq);
 }
 
-void City::save(const std::string& city_name_str)
+void City::take_snapshot(CitySnapshot& snapshot) const
 {
-	// Create the saved file.
-	std::ofstream output_file(CITY_NAME_STR, std::ios::out);
+	this->take_properties_snapshot(snapshot);
+	// Copy the game map.
+	m_map_ptr->take_snapshot(snapshot.m_tiles_vec);
+}
 
-	// Save each property name and value.
-	output_file << CITY_WIDTH_STR << '=' << m_map_ptr->get_width() << '\n';
-	output_file << CITY_HEIGHT_STR << '=' << m_map_ptr->get_height() << '\n';
-	output_file << CITY_DAY_STR << '=' << m_day << '\n';
-	output_file << CITY_HOMELESS_NUM_STR << '=' << m_homeless_num << '\n';
-	output_file << CITY_UNEMPLOYMENT_NUM_STR << '=' << m_unemployment_num << '\n';
-	output_file << CITY_POPULATION_STR << '=' << m_city_population << '\n';
-	output_file << CITY_EMPLOYABLE_STR << '=' << m_employable << '\n';
-	output_file << CITY_BIRTH_RATE_PER_DAY_STR << '=' << m_birth_rate_per_day << '\n';
-	output_file << CITY_DEATH_RATE_PER_DAY_STR << '=' << m_death_rate_per_day << '\n';
-	output_file << CITY_RESIDENTIAL_TAX_RATE_STR << '=' << m_residential_tax_rate << '\n';
-	output_file << CITY_COMMERCIAL_TAX_RATE_STR << '=' << m_commercial_tax_rate << '\n';
-	output_file << CITY_INDUSTRIAL_TAX_RATE_STR << '=' << m_industrial_tax_rate << '\n';
-	output_file << CITY_FUND_STR << '=' << m_fund << '\n';
-	output_file << CITY_CURR_MONTH_EARNINGS_STR << '=' << m_curr_month_earnings << '\n';
+void City::update_snapshot(CitySnapshot& snapshot)
+{
+	this->take_properties_snapshot(snapshot);
+	// Copy only the game map's chunks changed since the snapshot was last updated.
+	m_map_ptr->update_snapshot(snapshot.m_tiles_vec);
+}
+
+void City::take_properties_snapshot(CitySnapshot& snapshot) const
+{
+	// Copy each property.
+	snapshot.m_name = m_name;
+	snapshot.m_width = m_map_ptr->get_width();
+	snapshot.m_height = m_map_ptr->get_height();
+	snapshot.m_day = m_day;
+	snapshot.m_homeless_num = m_homeless_num;
+	snapshot.m_unemployment_num = m_unemployment_num;
+	snapshot.m_city_population = m_city_population;
+	snapshot.m_employable = m_employable;
+	snapshot.m_birth_rate_per_day = m_birth_rate_per_day;
+	snapshot.m_death_rate_per_day = m_death_rate_per_day;
+	snapshot.m_residential_tax_rate = m_residential_tax_rate;
+	snapshot.m_commercial_tax_rate = m_commercial_tax_rate;
+	snapshot.m_industrial_tax_rate = m_industrial_tax_rate;
+	snapshot.m_fund = m_fund;
+	snapshot.m_curr_month_earnings = m_curr_month_earnings;
+	snapshot.m_seed = m_seed;
+	snapshot.m_journal_seq = m_journal_seq;
+}
+
+void City::restore_snapshot(const CitySnapshot& snapshot, std::unordered_map<std::string, Tile>& str_tile_map)
+{
+	this->restore_properties(snapshot);
+	// Create the game map from the snapshot's tiles and generate the update order.
+	m_map_ptr = std::make_shared<Map>();
+	m_map_ptr->load(snapshot.m_tiles_vec, snapshot.m_width, snapshot.m_height, str_tile_map);
+	this->shuffleTiles();
+	m_level_up_scheduler.reset(m_map_ptr->get_tiles_amount());
+	this->reset_active_tiles();
+}
 
-	// Close the file and save the game map.
-	output_file.close();
-	m_map_ptr->save(MAP_BINARY_FILE_PATH);
+void City::restore_properties(const CitySnapshot& snapshot)
+{
+	// Copy each property.
+	m_name = snapshot.m_name;
+	m_day = snapshot.m_day;
+	m_homeless_num = snapshot.m_homeless_num;
+	m_unemployment_num = snapshot.m_unemployment_num;
+	m_city_population = snapshot.m_city_population;
+	m_employable = snapshot.m_employable;
+	m_birth_rate_per_day = snapshot.m_birth_rate_per_day;
+	m_death_rate_per_day = snapshot.m_death_rate_per_day;
+	m_residential_tax_rate = snapshot.m_residential_tax_rate;
+	m_commercial_tax_rate = snapshot.m_commercial_tax_rate;
+	m_industrial_tax_rate = snapshot.m_industrial_tax_rate;
+	m_fund = snapshot.m_fund;
+	m_curr_month_earnings = snapshot.m_curr_month_earnings;
+	m_seed = snapshot.m_seed;
+	m_journal_seq = snapshot.m_journal_seq;
 }
 
 void City::update(const float dt)
 {
+	PROFILE_SCOPE("City::update");
+	// Update the game time.
+	m_current_day_elapsed_time += dt;
+	// Do nothing if it's still the same day.
+	if (m_current_day_elapsed_time < m_time_per_day)
+		return;
+	// Reset current day's elapsed time and process the next day.
+	m_current_day_elapsed_time = 0;
+	this->step_day();
+
+	// Record the day tick.
+	if (m_journal_ptr)
+		m_journal_ptr->append_day(++m_journal_seq, m_day);
+}
+
+void City::advanceDays(unsigned int days_num)
+{
+	PROFILE_SCOPE("City::advanceDays");
+	this->fast_forward_days(days_num);
+
+	// Record all advanced days at once, replaying the record advances the same way.
+	if (m_journal_ptr)
+		m_journal_ptr->append_advance(++m_journal_seq, m_day);
+}
+
+void City::fast_forward_days(unsigned int days_num)
+{
+	const unsigned int target_day = m_day + days_num;
+	// Tiles may have been changed by any action since the last fast-forward.
+	m_is_steady_scan_valid = false;
+	// A city which is not steady yet may become steady after any day.
+	while (m_day != target_day && !this->skip_steady_days(target_day - m_day))
+	{
+		this->step_day();
+		// Tiles updated by the day's residential pass may have changed, even if they are asleep again.
+		if (m_active_tiles.get_active_tiles_num() > 0)
+			m_is_steady_scan_valid = false;
+	}
+}
+
+void City::scan_steady_tiles()
+{
+	const double rate = m_birth_rate_per_day - m_death_rate_per_day;
+	m_is_steady_scan_valid = true;
+	m_are_zone_tiles_steady = false;
+	m_steady_region_customers_map.clear();
+	m_steady_commercial_region_set.clear();
+	m_steady_industrial_idx_vec.clear();
+	m_steady_commercial_idx_vec.clear();
+
+	// Check that no zone tile can change anymore except by growing beyond its limit.
+	for (std::size_t i = 0; i < m_map_ptr->get_tiles_amount(); ++i)
+	{
+		const Tile& curr_tile = m_map_ptr->get_tile_ref(static_cast<int>(i));
+		const unsigned int max_tile_population = curr_tile.get_population_limit_per_level() * (curr_tile.m_level + 1);
+		if (curr_tile.m_tileType == TileTypeEnum::RESIDENTIAL)
+		{
+			// A full residential tile shrinks if the population does.
+			if (rate < 0 || curr_tile.m_population != max_tile_population || curr_tile.is_level_up_ready())
+				return;
+			m_steady_region_customers_map[curr_tile.m_region_arr[0]] += curr_tile.m_population;
+		}
+		else if (curr_tile.m_tileType == TileTypeEnum::COMMERCIAL ||
+			curr_tile.m_tileType == TileTypeEnum::INDUSTRIAL)
+		{
+			if (curr_tile.m_population < max_tile_population || curr_tile.is_level_up_ready())
+				return;
+			if (curr_tile.m_tileType == TileTypeEnum::COMMERCIAL)
+				m_steady_commercial_region_set.insert(curr_tile.m_region_arr[0]);
+			// Industrial tiles must not extract resource.
+			else if (m_map_ptr->get_tile_resource(static_cast<int>(i)) > 0)
+				return;
+			else
+				m_steady_industrial_idx_vec.push_back(static_cast<int>(i));
+		}
+	}
+	for (const auto tile_index : m_update_order_related_tile_index_vec)
+		if (m_map_ptr->get_tile_ref(tile_index).m_tileType == TileTypeEnum::COMMERCIAL)
+			m_steady_commercial_idx_vec.push_back(tile_index);
+	m_are_zone_tiles_steady = true;
+}
+
+bool City::skip_steady_days(unsigned int days_num)
+{
+	/* Only the serial residential pass lets full tiles sleep and adds them up the same way each day. The parallel pass
+	 * hands people out in chunks, so its days are always stepped. */
+	if (m_is_residential_pass_parallel || !m_active_tiles.is_all_asleep())
+		return false;
+	// Scan the tiles only once until any of them is updated again, a city which is not steady is stepped cheaply.
+	if (!m_is_steady_scan_valid)
+		this->scan_steady_tiles();
+	if (!m_are_zone_tiles_steady)
+		return false;
+	const double rate = m_birth_rate_per_day - m_death_rate_per_day;
+
+	/* Industrial tiles hand out production to each other and to commercial tiles every day, so only their production
+	 * is checked each day. They must neither hand out production nor have it taken by commercial tiles inside their
+	 * regions, and only those with a negative production per day still change, by adding it each day. */
+	std::vector<int> industrial_idx_vec;
+	for (const auto tile_index : m_steady_industrial_idx_vec)
+	{
+		const Tile& curr_tile = m_map_ptr->get_tile_ref(tile_index);
+		if (curr_tile.get_production_per_day() > 0 || (curr_tile.m_total_production > 0 &&
+			m_steady_commercial_region_set.count(curr_tile.m_region_arr[0])))
+			return false;
+		if (curr_tile.get_production_per_day() != 0)
+			industrial_idx_vec.push_back(tile_index);
+	}
+
+	// The industrial tiles' total production and the commercial tiles' earnings are written below.
+	for (const auto tile_index : industrial_idx_vec)
+		m_map_ptr->mark_tile_changed(tile_index);
+	for (const auto tile_index : m_steady_commercial_idx_vec)
+		m_map_ptr->mark_tile_changed(tile_index);
+
+	/* Replay each day's city-wide sums with the same operations as step_day, so the result is bit-identical to
+	 * stepping. A day costs as much as the sleeping residential tiles' groups rather than the map, and the commercial
+	 * pass is only drawn on the days whose earnings are kept: the day before each month ends and the last day. */
+	const unsigned int target_day = m_day + days_num;
+	while (m_day != target_day)
+	{
+		++m_day;
+		if (m_day % DAYS_NUM_PER_MONTH == 0)
+		{
+			m_fund += m_curr_month_earnings;
+			m_curr_month_earnings = 0;
+		}
+
+		// No tile is awake, so the residential pass only adds the sleeping full residential tiles.
+		double total_population(0);
+		m_active_tiles.begin_day(m_unemployment_num > 0);
+		m_active_tiles.add_full_residential(rate, m_homeless_num, total_population);
+		for (const auto tile_index : industrial_idx_vec)
+		{
+			Tile& curr_tile = m_map_ptr->get_tile_ref(tile_index);
+			curr_tile.m_total_production += curr_tile.get_production_per_day() * (curr_tile.m_level + 1);
+		}
+
+		m_homeless_num += m_homeless_num * rate;
+		total_population += m_homeless_num;
+		float new_workers_num = (total_population - m_city_population) * m_proportion_can_work;
+		m_unemployment_num += new_workers_num;
+		m_employable += new_workers_num;
+		if (m_unemployment_num < 0)
+			m_unemployment_num = 0;
+		if (m_employable < 0)
+			m_employable = 0;
+		m_city_population = total_population;
+
+		if ((m_day + 1) % DAYS_NUM_PER_MONTH != 0 && m_day != target_day)
+			continue;
+		// Draw the commercial tiles' revenue the same way as the commercial pass of this day.
+		m_rng.seed(m_seed ^ (m_day * CITY_DAY_SEED_FACTOR));
+		double commercial_revenue(0);
+		for (const auto tile_index : m_steady_commercial_idx_vec)
+		{
+			Tile& curr_tile = m_map_ptr->get_tile_ref(tile_index);
+			const unsigned int max_customers_num = m_steady_region_customers_map[curr_tile.m_region_arr[0]];
+			curr_tile.m_total_production = (m_rng() % RESIDENTIAL_RANDOM_BASE) * (1 - m_commercial_tax_rate);
+			commercial_revenue += curr_tile.m_total_production * max_customers_num * curr_tile.m_population /
+				CITY_RANDOM_BASE;
+		}
+		m_curr_month_earnings = (m_city_population - m_homeless_num) * RESIDENTIAL_EARNING_FACTOR *
+			m_residential_tax_rate;
+		m_curr_month_earnings += commercial_revenue * m_commercial_tax_rate;
+	}
+	return true;
+}
+
+void City::step_day()
+{
+	PROFILE_SCOPE("City::step_day");
 	// Declare variables for city's total population.
 	double total_population(0);
 
@@ -196,15 +554,10 @@ void City::update(const float dt)
 	double commercial_revenue(0);
 	double industrial_revenue(0);
 
-	// Update the game time.
-	m_current_day_elapsed_time += dt;
-	// Do nothing if it's still the same day.
-	if (m_current_day_elapsed_time < m_time_per_day)
-		return;
-	// Process if time reaches next day.
+	// Process the next day.
 	++m_day;
-	// Reset current day's elapsed time.
-	m_current_day_elapsed_time = 0;
+	// Each day's random numbers only depend on the city's seed and the day.
+	m_rng.seed(m_seed ^ (m_day * CITY_DAY_SEED_FACTOR));
 
 	// Check if reaches next month(I assume that each month contains exactly 30 days).
 	if (m_day % DAYS_NUM_PER_MONTH == 0)
@@ -215,145 +568,147 @@ void City::update(const float dt)
 	}
 
 	// Traverse through each Tile object within the game map to handle residents distribution.
-	for (size_t i = 0; i < m_map_ptr->get_tiles_amount(); ++i)
 	{
-		// Start from Tile object that should be updated first.
-		int curr_tile_index = m_update_order_related_tile_index_vec[i];
-		Tile& curr_tile = m_map_ptr->get_tile_ref(curr_tile_index);
-
-		/* If current tile is a Residential tile, then distribute residents if possible and add current tile's
-		 * population into city's total population. */
-		if (curr_tile.m_tileType == TileTypeEnum::RESIDENTIAL)
-		{
-			this->distributeResidents(m_homeless_num, curr_tile, (m_birth_rate_per_day -
-			m_death_rate_per_day));
-			total_population += curr_tile.m_population;
-		}
-		/* If current tile is a Commercial tile, then hire more people according to commercial tax rate. The lower the
-		 * tax rate is, the higher possibility people will be hired. */
-		else if (curr_tile.m_tileType == TileTypeEnum::COMMERCIAL)
+		PROFILE_SCOPE("City::step_day residential pass");
+		if (m_is_residential_pass_parallel)
+			total_population = this->run_residential_pass_parallel();
+		else
 		{
-			if ((rand() % CITY_RANDOM_BASE) < (TAX_RATE_FACTOR * (1 - m_commercial_tax_rate)))
-				this->distributeResidents(m_unemployment_num, curr_tile, 0.0);
-		}
-		/* If current tile is an Industrial tile, then try to extract resource from the ground and also hire more people
-		 * according to industrial tax rate. The lower the tax rate is, the higher possibility people will be hired. */
-		else if (curr_tile.m_tileType == TileTypeEnum::INDUSTRIAL)
-		{
-			// Check if there is still resource underground and random number check passes.
-			if ((m_map_ptr->get_tile_resource(curr_tile_index) > 0) && (rand() % CITY_RANDOM_BASE <
-			    m_city_population))
+			// Sleeping full residential tiles only overflow, which is added for all of them at once.
+			m_active_tiles.begin_day(m_unemployment_num > 0);
+			m_active_tiles.add_full_residential(m_birth_rate_per_day - m_death_rate_per_day, m_homeless_num,
+				total_population);
+			m_scheduled_tile_idx_vec.clear();
+			// Only awake tiles are updated, starting from Tile object that should be updated first.
+			for (const auto tile_index : m_active_tiles.get_active_idx_vec())
 			{
-				// Increment current tile's production per worker per day by one.
-				curr_tile.set_production_per_day(curr_tile.get_production_per_day() + 1);
-				// Decrement current tile's resource by one.
-				m_map_ptr->decrement_tile_resource(curr_tile_index);
+				this->update_zone_tile(tile_index, m_homeless_num, m_unemployment_num, total_population,
+					m_scheduled_tile_idx_vec);
+				m_map_ptr->mark_tile_changed(tile_index);
+				this->sleep_idle_tile(tile_index);
 			}
-
-			// Try to hire more people.
-			if ((rand() % CITY_RANDOM_BASE) < (TAX_RATE_FACTOR * (1 - m_industrial_tax_rate)))
-				this->distributeResidents(m_unemployment_num, curr_tile, 0.0);
+			m_level_up_scheduler.push_events(m_scheduled_tile_idx_vec);
+		}
+		// Level up the tiles whose level-up is due today, before their levels affect production.
+		m_leveled_up_tile_idx_vec.clear();
+		m_level_up_scheduler.fire_due_events(m_day, m_map_ptr->get_tiles_vec_ref(), m_leveled_up_tile_idx_vec);
+		// Leveled up tiles have room for more people again.
+		for (const auto tile_index : m_leveled_up_tile_idx_vec)
+		{
+			m_active_tiles.wake_tile(tile_index);
+			m_map_ptr->mark_tile_changed(tile_index);
 		}
-		curr_tile.chanceLevelUp();
 	}
 
 	// Second pass to handle industrial tiles' total production update.
-	for (size_t i = 0; i < m_map_ptr->get_tiles_amount(); ++i)
 	{
-		// Start from Tile object that should be updated first.
-		int curr_tile_index = m_update_order_related_tile_index_vec[i];
-		Tile& curr_tile = m_map_ptr->get_tile_ref(curr_tile_index );
-
-		// Only industrial tiles have features on production.
-		if (curr_tile.m_tileType == TileTypeEnum::INDUSTRIAL)
+		PROFILE_SCOPE("City::step_day industrial pass");
+		for (size_t i = 0; i < m_map_ptr->get_tiles_amount(); ++i)
 		{
-			// Store each Tile object's received production.
-			unsigned int received_production(0);
-			// Traverse through each Tile object within the game map.
-			for (auto& each_tile : m_map_ptr->get_tiles_vec_ref())
+			// Start from Tile object that should be updated first.
+			int curr_tile_index = m_update_order_related_tile_index_vec[i];
+			Tile& curr_tile = m_map_ptr->get_tile_ref(curr_tile_index );
+
+			// Only industrial tiles have features on production.
+			if (curr_tile.m_tileType == TileTypeEnum::INDUSTRIAL)
 			{
-				// Try to receive production from industrial tiles within the same region.
-				if ((each_tile.m_region_arr[0] == curr_tile.m_region_arr[0]) && each_tile.m_tileType ==
-				TileTypeEnum::INDUSTRIAL)
+				// Store each Tile object's received production.
+				unsigned int received_production(0);
+				// Traverse through each Tile object within the game map.
+				std::vector<Tile>& tiles_vec = m_map_ptr->get_tiles_vec_ref();
+				for (auto& each_tile : tiles_vec)
 				{
-					// Check if each tile still has production.
-					if (each_tile.get_production_per_day() > 0)
+					// Try to receive production from industrial tiles within the same region.
+					if ((each_tile.m_region_arr[0] == curr_tile.m_region_arr[0]) && each_tile.m_tileType ==
+					TileTypeEnum::INDUSTRIAL)
 					{
-						// Transfer 1 production.
-						++received_production;
-						each_tile.set_production_per_day(each_tile.get_production_per_day() - 1);
+						// Check if each tile still has production.
+						if (each_tile.get_production_per_day() > 0)
+						{
+							// Transfer 1 production.
+							++received_production;
+							each_tile.set_production_per_day(each_tile.get_production_per_day() - 1);
+							m_map_ptr->mark_tile_changed(static_cast<int>(&each_tile - tiles_vec.data()));
+						}
+						/* Current tile's m_level will be used to check if received production is too large(low level
+						 * tiles cannot receive too much production). Received production's maximum value cannot exceed
+						 * m_level by 1. */
+						if (received_production == (curr_tile.m_level + 1))
+							break;
 					}
-					/* Current tile's m_level will be used to check if received production is too large(low level tiles
-					 * cannot receive too much production). Received production's maximum value cannot exceed m_level
-					 * by 1. */
-					if (received_production == (curr_tile.m_level + 1))
-						break;
 				}
+				// Update current Tile object's total production.
+				curr_tile.m_total_production += (received_production + curr_tile.get_production_per_day()) *
+					(curr_tile.m_level + 1);
+				m_map_ptr->mark_tile_changed(curr_tile_index);
 			}
-			// Update current Tile object's total production.
-			curr_tile.m_total_production += (received_production + curr_tile.get_production_per_day()) *
-				(curr_tile.m_level + 1);
 		}
 	}
 
 	// Third pass to handle commercial tiles' production distribution.
-	for (size_t i = 0; i < m_map_ptr->get_tiles_amount(); ++i)
 	{
-		// Start from Tile object that should be updated first.
-		int curr_tile_index = m_update_order_related_tile_index_vec[i];
-		Tile& curr_tile = m_map_ptr->get_tile_ref(curr_tile_index );
-
-		// Only commercial tiles have features on production distribution.
-		if (curr_tile.m_tileType == TileTypeEnum::COMMERCIAL)
+		PROFILE_SCOPE("City::step_day commercial pass");
+		for (size_t i = 0; i < m_map_ptr->get_tiles_amount(); ++i)
 		{
-			// Store each Tile object's received production.
-			unsigned int received_production(0);
-			// Store maximum production customers' number.
-			unsigned int max_customers_num(0);
-			// Traverse through each Tile object within the game map.
-			for (auto& each_tile : m_map_ptr->get_tiles_vec_ref())
+			// Start from Tile object that should be updated first.
+			int curr_tile_index = m_update_order_related_tile_index_vec[i];
+			Tile& curr_tile = m_map_ptr->get_tile_ref(curr_tile_index );
+
+			// Only commercial tiles have features on production distribution.
+			if (curr_tile.m_tileType == TileTypeEnum::COMMERCIAL)
 			{
-				/* Process when each_tile is of industrial type, its production is larger than zero and both curr_tile
-				 * and each_tile are within the same region. */
-				if ((each_tile.m_region_arr[0] == curr_tile.m_region_arr[0]) && (each_tile.m_tileType ==
-					TileTypeEnum::INDUSTRIAL) && (each_tile.m_total_production > 0))
+				// Store each Tile object's received production.
+				unsigned int received_production(0);
+				// Store maximum production customers' number.
+				unsigned int max_customers_num(0);
+				// Traverse through each Tile object within the game map.
+				std::vector<Tile>& tiles_vec = m_map_ptr->get_tiles_vec_ref();
+				for (auto& each_tile : tiles_vec)
 				{
-					/* Check if each_tile still has production and already received production does not exceed current
-					 * Tile object's level plus one. */
-					while ((each_tile.m_total_production > 0) && (received_production != (curr_tile.m_level + 1)))
+					/* Process when each_tile is of industrial type, its production is larger than zero and both
+					 * curr_tile and each_tile are within the same region. */
+					if ((each_tile.m_region_arr[0] == curr_tile.m_region_arr[0]) && (each_tile.m_tileType ==
+						TileTypeEnum::INDUSTRIAL) && (each_tile.m_total_production > 0))
 					{
-						// Keep transferring 1 production.
-						each_tile.set_production_per_day(each_tile.get_production_per_day() - 1);
-						++received_production;
-						//
-						industrial_revenue += INDUSTRIAL_REVENUE_PER_PRODUCTION_FACTOR * (1 - m_industrial_tax_rate);
+						/* Check if each_tile still has production and already received production does not exceed
+						 * current Tile object's level plus one. */
+						while ((each_tile.m_total_production > 0) && (received_production != (curr_tile.m_level + 1)))
+						{
+							// Keep transferring 1 production.
+							each_tile.set_production_per_day(each_tile.get_production_per_day() - 1);
+							m_map_ptr->mark_tile_changed(static_cast<int>(&each_tile - tiles_vec.data()));
+							++received_production;
+							//
+							industrial_revenue += INDUSTRIAL_REVENUE_PER_PRODUCTION_FACTOR * (1 - m_industrial_tax_rate);
+						}
+					}
+					/*
+					 * Process when each_tile is of residential type and both curr_tile
+					 * and each_tile are within the same region.
+					 */
+					else if ((each_tile.m_region_arr[0] == curr_tile.m_region_arr[0]) && each_tile.m_tileType ==
+						TileTypeEnum::RESIDENTIAL)
+					{
+						// Increment maximum customers' number.
+						max_customers_num += each_tile.m_population;
 					}
-				}
-				/*
-				 * Process when each_tile is of residential type and both curr_tile
-				 * and each_tile are within the same region.
-				 */
-				else if ((each_tile.m_region_arr[0] == curr_tile.m_region_arr[0]) && each_tile.m_tileType ==
-					TileTypeEnum::RESIDENTIAL)
-				{
-					// Increment maximum customers' number.
-					max_customers_num += each_tile.m_population;
-				}
 
-				/* Current tile's m_level will be used to check if received production is too large(low level tiles
-				 * cannot receive too much production). Received production's maximum value cannot exceed m_level
-				 * by 1. */
-				if (received_production == (curr_tile.m_level + 1))
-					break;
-			}
+					/* Current tile's m_level will be used to check if received production is too large(low level tiles
+					 * cannot receive too much production). Received production's maximum value cannot exceed m_level
+					 * by 1. */
+					if (received_production == (curr_tile.m_level + 1))
+						break;
+				}
 
-			// Calculate the overall production for current Tile object.
-			curr_tile.m_total_production = (received_production * RESIDENTIAL_REVENUE_PER_PRODUCTION_FACTOR + rand() %
-				RESIDENTIAL_RANDOM_BASE) * (1 - m_commercial_tax_rate);
+				// Calculate the overall production for current Tile object.
+				curr_tile.m_total_production = (received_production * RESIDENTIAL_REVENUE_PER_PRODUCTION_FACTOR +
+					m_rng() % RESIDENTIAL_RANDOM_BASE) * (1 - m_commercial_tax_rate);
+				m_map_ptr->mark_tile_changed(curr_tile_index);
 
-			// Update the overall commercial revenue.
-			commercial_revenue += curr_tile.m_total_production * max_customers_num * curr_tile.m_population /
-				CITY_RANDOM_BASE;
+				// Update the overall commercial revenue.
+				commercial_revenue += curr_tile.m_total_production * max_customers_num * curr_tile.m_population /
+					CITY_RANDOM_BASE;
+			}
 		}
 	}
 
@@ -384,11 +739,223 @@ void City::update(const float dt)
 	m_curr_month_earnings += industrial_revenue * m_industrial_tax_rate;
 }
 
+void City::update_zone_tile(int tile_index, double& homeless_ref, double& unemployment_ref,
+	double& total_population_ref, std::vector<int>& scheduled_idx_vec)
+{
+	Tile& curr_tile = m_map_ptr->get_tile_ref(tile_index);
+
+	/* If current tile is a Residential tile, then distribute residents if possible and add current tile's population
+	 * into city's total population. */
+	if (curr_tile.m_tileType == TileTypeEnum::RESIDENTIAL)
+	{
+		this->distributeResidents(homeless_ref, curr_tile, (m_birth_rate_per_day - m_death_rate_per_day));
+		total_population_ref += curr_tile.m_population;
+	}
+	/* If current tile is a Commercial tile, then hire more people according to commercial tax rate. The lower the tax
+	 * rate is, the higher possibility people will be hired. */
+	else if (curr_tile.m_tileType == TileTypeEnum::COMMERCIAL)
+	{
+		if ((get_tile_random(m_seed, tile_index, m_day, TILE_RANDOM_COMMERCIAL_HIRE_STREAM) % CITY_RANDOM_BASE) <
+			(TAX_RATE_FACTOR * (1 - m_commercial_tax_rate)))
+			this->distributeResidents(unemployment_ref, curr_tile, 0.0);
+	}
+	/* If current tile is an Industrial tile, then try to extract resource from the ground and also hire more people
+	 * according to industrial tax rate. The lower the tax rate is, the higher possibility people will be hired. */
+	else if (curr_tile.m_tileType == TileTypeEnum::INDUSTRIAL)
+	{
+		// Check if there is still resource underground and random number check passes.
+		if ((m_map_ptr->get_tile_resource(tile_index) > 0) && (get_tile_random(m_seed, tile_index, m_day,
+			TILE_RANDOM_INDUSTRIAL_EXTRACT_STREAM) % CITY_RANDOM_BASE < m_city_population))
+		{
+			// Increment current tile's production per worker per day by one.
+			curr_tile.set_production_per_day(curr_tile.get_production_per_day() + 1);
+			// Decrement current tile's resource by one.
+			m_map_ptr->decrement_tile_resource(tile_index);
+		}
+
+		// Try to hire more people.
+		if ((get_tile_random(m_seed, tile_index, m_day, TILE_RANDOM_INDUSTRIAL_HIRE_STREAM) % CITY_RANDOM_BASE) <
+			(TAX_RATE_FACTOR * (1 - m_industrial_tax_rate)))
+			this->distributeResidents(unemployment_ref, curr_tile, 0.0);
+	}
+	// Schedule the tile's level-up once it is full, or cancel it once it is not.
+	if (m_level_up_scheduler.refresh_tile(tile_index, curr_tile, m_day, m_seed))
+		scheduled_idx_vec.push_back(tile_index);
+}
+
+void City::sleep_idle_tile(int tile_index)
+{
+	const Tile& curr_tile = m_map_ptr->get_tile_ref(tile_index);
+	const unsigned int max_tile_population = curr_tile.get_population_limit_per_level() * (curr_tile.m_level + 1);
+
+	// A full residential tile only overflows while the population grows, until it levels up or is replaced.
+	if (curr_tile.m_tileType == TileTypeEnum::RESIDENTIAL)
+	{
+		if (m_birth_rate_per_day >= m_death_rate_per_day && curr_tile.m_population == max_tile_population)
+			m_active_tiles.put_to_sleep(tile_index, TileSleepEnum::FULL, max_tile_population);
+	}
+	/* An employing tile only hires until it is full, and only while there is anyone to hire. Industrial tiles which
+	 * still extract resource keep rolling for it each day. */
+	else if (curr_tile.m_tileType == TileTypeEnum::COMMERCIAL || (curr_tile.m_tileType == TileTypeEnum::INDUSTRIAL &&
+		m_map_ptr->get_tile_resource(tile_index) == 0))
+	{
+		if (curr_tile.m_population >= max_tile_population)
+			m_active_tiles.put_to_sleep(tile_index, TileSleepEnum::FULL);
+		else if (m_unemployment_num <= 0)
+			m_active_tiles.put_to_sleep(tile_index, TileSleepEnum::STARVED);
+	}
+	// Other tiles are never changed by the residential pass.
+	else if (curr_tile.m_tileType != TileTypeEnum::INDUSTRIAL)
+		m_active_tiles.put_to_sleep(tile_index, TileSleepEnum::INERT);
+}
+
+void City::reset_active_tiles()
+{
+	std::vector<bool> is_zone_vec(m_map_ptr->get_tiles_amount());
+	for (std::size_t i = 0; i < is_zone_vec.size(); ++i)
+	{
+		const TileTypeEnum tile_type = m_map_ptr->get_tile_ref(static_cast<int>(i)).m_tileType;
+		is_zone_vec[i] = tile_type == TileTypeEnum::RESIDENTIAL || tile_type == TileTypeEnum::COMMERCIAL ||
+			tile_type == TileTypeEnum::INDUSTRIAL;
+	}
+	m_active_tiles.reset(m_update_order_related_tile_index_vec, is_zone_vec);
+
+	/* Put idle zone tiles to sleep right away, as the last pass would have. Otherwise a loaded city's first pass would
+	 * add full residential tiles' overflow tile by tile instead of at once, and differ from the city which saved it.
+	 * Sleeping tiles are not refreshed by the pass, so their level-ups are scheduled here. */
+	m_scheduled_tile_idx_vec.clear();
+	for (std::size_t i = 0; i < is_zone_vec.size(); ++i)
+	{
+		if (!is_zone_vec[i])
+			continue;
+		const int tile_index = static_cast<int>(i);
+		if (m_level_up_scheduler.refresh_tile(tile_index, m_map_ptr->get_tile_ref(tile_index), m_day, m_seed))
+			m_scheduled_tile_idx_vec.push_back(tile_index);
+		this->sleep_idle_tile(tile_index);
+	}
+	m_level_up_scheduler.push_events(m_scheduled_tile_idx_vec);
+}
+
+double City::run_residential_pass_parallel()
+{
+	// The chunks only depend on the update order, never on the amount of threads.
+	const std::size_t tiles_num = m_map_ptr->get_tiles_amount();
+	std::vector<ResidentialChunk> chunks_vec((tiles_num + CITY_PARALLEL_CHUNK_TILES_NUM - 1) /
+		CITY_PARALLEL_CHUNK_TILES_NUM);
+	std::shared_ptr<JobSystem> job_system_ptr = JobSystem::getInstance();
+
+	// Count each chunk's residential and employing tiles.
+	job_system_ptr->parallel_for(0, chunks_vec.size(), 1, [&](std::size_t begin, std::size_t end)
+	{
+		for (std::size_t chunk_idx = begin; chunk_idx < end; ++chunk_idx)
+			for (std::size_t i = chunk_idx * CITY_PARALLEL_CHUNK_TILES_NUM; i < std::min((chunk_idx + 1) *
+				CITY_PARALLEL_CHUNK_TILES_NUM, tiles_num); ++i)
+			{
+				const int tile_index = m_update_order_related_tile_index_vec[i];
+				const TileTypeEnum tile_type = m_map_ptr->get_tile_ref(tile_index).m_tileType;
+				if (tile_type == TileTypeEnum::RESIDENTIAL)
+					++chunks_vec[chunk_idx].m_residential_tiles_num;
+				else if (tile_type == TileTypeEnum::COMMERCIAL || tile_type == TileTypeEnum::INDUSTRIAL)
+					++chunks_vec[chunk_idx].m_employing_tiles_num;
+			}
+	});
+
+	// Hand out the quotas in chunk order, the people not handed out stay inside the city's groups.
+	std::size_t residential_tiles_num{0};
+	std::size_t employing_tiles_num{0};
+	for (const auto& chunk : chunks_vec)
+	{
+		residential_tiles_num += chunk.m_residential_tiles_num;
+		employing_tiles_num += chunk.m_employing_tiles_num;
+	}
+	for (auto& chunk : chunks_vec)
+	{
+		if (residential_tiles_num > 0)
+			chunk.m_homeless_num = m_homeless_num * chunk.m_residential_tiles_num / residential_tiles_num;
+		if (employing_tiles_num > 0)
+			chunk.m_unemployment_num = m_unemployment_num * chunk.m_employing_tiles_num / employing_tiles_num;
+		m_homeless_num -= chunk.m_homeless_num;
+		m_unemployment_num -= chunk.m_unemployment_num;
+	}
+
+	// Update each chunk's tiles with its own quotas, the tiles' random numbers never depend on the chunks.
+	job_system_ptr->parallel_for(0, chunks_vec.size(), 1, [&](std::size_t begin, std::size_t end)
+	{
+		for (std::size_t chunk_idx = begin; chunk_idx < end; ++chunk_idx)
+		{
+			ResidentialChunk& chunk = chunks_vec[chunk_idx];
+			chunk.m_residential_idx_vec.reserve(chunk.m_residential_tiles_num);
+			for (std::size_t i = chunk_idx * CITY_PARALLEL_CHUNK_TILES_NUM; i < std::min((chunk_idx + 1) *
+				CITY_PARALLEL_CHUNK_TILES_NUM, tiles_num); ++i)
+			{
+				const int tile_index = m_update_order_related_tile_index_vec[i];
+				Tile& curr_tile = m_map_ptr->get_tile_ref(tile_index);
+				// Residential tiles only take homeless people here, they grow together afterwards.
+				if (curr_tile.m_tileType == TileTypeEnum::RESIDENTIAL)
+				{
+					this->distributeResidents(chunk.m_homeless_num, curr_tile);
+					chunk.m_residential_idx_vec.push_back(tile_index);
+				}
+				else
+					this->update_zone_tile(tile_index, chunk.m_homeless_num, chunk.m_unemployment_num,
+						chunk.m_population, chunk.m_scheduled_idx_vec);
+			}
+
+			// Grow and clamp all residential tiles' populations at once, the people beyond the limits become homeless.
+			chunk.m_population_vec.resize(chunk.m_residential_idx_vec.size());
+			chunk.m_limit_vec.resize(chunk.m_residential_idx_vec.size());
+			for (std::size_t i = 0; i < chunk.m_residential_idx_vec.size(); ++i)
+			{
+				const Tile& curr_tile = m_map_ptr->get_tile_ref(chunk.m_residential_idx_vec[i]);
+				chunk.m_population_vec[i] = curr_tile.m_population;
+				chunk.m_limit_vec[i] = curr_tile.get_population_limit_per_level() * (curr_tile.m_level + 1);
+			}
+			grow_and_clamp_populations(chunk.m_population_vec.data(), chunk.m_limit_vec.data(),
+				chunk.m_population_vec.size(), m_birth_rate_per_day - m_death_rate_per_day, chunk.m_homeless_num,
+				chunk.m_population);
+			// Residential tiles' level-ups are scheduled once they have grown.
+			for (std::size_t i = 0; i < chunk.m_residential_idx_vec.size(); ++i)
+			{
+				const int tile_index = chunk.m_residential_idx_vec[i];
+				Tile& curr_tile = m_map_ptr->get_tile_ref(tile_index);
+				curr_tile.m_population = chunk.m_population_vec[i];
+				if (m_level_up_scheduler.refresh_tile(tile_index, curr_tile, m_day, m_seed))
+					chunk.m_scheduled_idx_vec.push_back(tile_index);
+			}
+		}
+	});
+
+	// The tiles were updated by several threads, so every zone tile is marked changed here.
+	for (std::size_t i = 0; i < tiles_num; ++i)
+	{
+		const TileTypeEnum tile_type = m_map_ptr->get_tile_ref(static_cast<int>(i)).m_tileType;
+		if (tile_type == TileTypeEnum::RESIDENTIAL || tile_type == TileTypeEnum::COMMERCIAL ||
+			tile_type == TileTypeEnum::INDUSTRIAL)
+			m_map_ptr->mark_tile_changed(static_cast<int>(i));
+	}
+
+	// Return what is left of the quotas and sum the population in chunk order, so the sums never depend on timing.
+	double total_population{0};
+	for (const auto& chunk : chunks_vec)
+	{
+		m_homeless_num += chunk.m_homeless_num;
+		m_unemployment_num += chunk.m_unemployment_num;
+		total_population += chunk.m_population;
+		m_level_up_scheduler.push_events(chunk.m_scheduled_idx_vec);
+	}
+	return total_population;
+}
+
 std::shared_ptr<Map> City::get_map_ptr() const
 {
 	return m_map_ptr;
 }
 
+const std::string& City::get_name() const
+{
+	return m_name;
+}
+
 unsigned int City::get_day() const
 {
 	return m_day;
@@ -412,4 +979,57 @@ double City::get_employable() const
 void City::set_fund(double new_fund)
 {
 	m_fund = new_fund;
+	// Record the new fund.
+	if (m_journal_ptr)
+		m_journal_ptr->append_fund(++m_journal_seq, m_fund);
+}
+
+unsigned int City::get_seed() const
+{
+	return m_seed;
+}
+
+void City::set_seed(unsigned int new_seed)
+{
+	m_seed = new_seed;
+	this->shuffleTiles();
+	// Level-up days depend on the seed, so they are scheduled again.
+	m_level_up_scheduler.reset(m_map_ptr->get_tiles_amount());
+	// The awake tiles follow the new update order.
+	this->reset_active_tiles();
+}
+
+void City::set_residential_pass_parallel(bool is_parallel)
+{
+	m_is_residential_pass_parallel = is_parallel;
+	// The parallel pass never puts tiles to sleep, so all tiles are woken for the serial pass.
+	if (m_map_ptr)
+		this->reset_active_tiles();
+}
+
+std::size_t City::get_active_tiles_num() const
+{
+	return m_is_residential_pass_parallel ? m_map_ptr->get_tiles_amount() : m_active_tiles.get_active_tiles_num();
+}
+
+std::uint32_t City::get_journal_seq() const
+{
+	return m_journal_seq;
+}
+
+bool City::is_journal_full() const
+{
+	return m_journal_ptr && m_journal_ptr->get_size() >= JOURNAL_COMPACTION_SIZE;
+}
+
+void City::compact_journal(std::uint32_t snapshot_seq)
+{
+	if (m_journal_ptr)
+		m_journal_ptr->compact(snapshot_seq);
+}
+
+void City::finish_journal_compaction(std::size_t read_size)
+{
+	if (m_journal_ptr)
+		m_journal_ptr->finish_compaction(read_size);
 }
\ No newline at end of file
@@ -0,0 +1,333 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <limits>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include "CitySnapshot.hpp"
+#include "MapChunkFile.hpp"
+#include "Profiler.hpp"
+#include "SaveSlot.hpp"
+#include "Utility.hpp"
+
+namespace
+{
+	/**
+	 * Describes one city property inside the city record and the text city configuration file. Exactly one of the
+	 * member pointers is set according to the property's type.
+	 */
+	struct CityField
+	{
+		// Id of the property inside the city record's field table, ids are never reused.
+		std::uint32_t m_id;
+		// Name of the property inside the text city configuration file.
+		const std::string& m_name;
+		unsigned int CitySnapshot::* m_unsigned_ptr;
+		double CitySnapshot::* m_double_ptr;
+		std::string CitySnapshot::* m_string_ptr;
+	};
+
+	// All city properties, in the order they are written.
+	const CityField CITY_FIELD_ARR[]{
+		{ 1, CITY_NAME_STR, nullptr, nullptr, &CitySnapshot::m_name },
+		{ 2, CITY_WIDTH_STR, &CitySnapshot::m_width, nullptr, nullptr },
+		{ 3, CITY_HEIGHT_STR, &CitySnapshot::m_height, nullptr, nullptr },
+		{ 4, CITY_DAY_STR, &CitySnapshot::m_day, nullptr, nullptr },
+		{ 5, CITY_HOMELESS_NUM_STR, nullptr, &CitySnapshot::m_homeless_num, nullptr },
+		{ 6, CITY_UNEMPLOYMENT_NUM_STR, nullptr, &CitySnapshot::m_unemployment_num, nullptr },
+		{ 7, CITY_POPULATION_STR, nullptr, &CitySnapshot::m_city_population, nullptr },
+		{ 8, CITY_EMPLOYABLE_STR, nullptr, &CitySnapshot::m_employable, nullptr },
+		{ 9, CITY_BIRTH_RATE_PER_DAY_STR, nullptr, &CitySnapshot::m_birth_rate_per_day, nullptr },
+		{ 10, CITY_DEATH_RATE_PER_DAY_STR, nullptr, &CitySnapshot::m_death_rate_per_day, nullptr },
+		{ 11, CITY_RESIDENTIAL_TAX_RATE_STR, nullptr, &CitySnapshot::m_residential_tax_rate, nullptr },
+		{ 12, CITY_COMMERCIAL_TAX_RATE_STR, nullptr, &CitySnapshot::m_commercial_tax_rate, nullptr },
+		{ 13, CITY_INDUSTRIAL_TAX_RATE_STR, nullptr, &CitySnapshot::m_industrial_tax_rate, nullptr },
+		{ 14, CITY_FUND_STR, nullptr, &CitySnapshot::m_fund, nullptr },
+		{ 15, CITY_CURR_MONTH_EARNINGS_STR, nullptr, &CitySnapshot::m_curr_month_earnings, nullptr },
+		{ 16, CITY_SEED_STR, &CitySnapshot::m_seed, nullptr, nullptr },
+		{ 17, CITY_JOURNAL_SEQ_STR, &CitySnapshot::m_journal_seq, nullptr, nullptr }
+	};
+
+	/**
+	 * Append the input value's bytes to the buffer.
+	 * @param buffer_vec A reference of vector indicates the buffer.
+	 * @param value A reference of const T indicates the value to be appended.
+	 */
+	template<typename T>
+	void append_value(std::vector<char>& buffer_vec, const T& value)
+	{
+		const char* byte_ptr = reinterpret_cast<const char*>(&value);
+		buffer_vec.insert(buffer_vec.end(), byte_ptr, byte_ptr + sizeof(T));
+	}
+}
+
+bool CitySnapshot::save(const SaveSlot& slot) const
+{
+	PROFILE_SCOPE("CitySnapshot::save");
+	// The city's record is stored inside the game map file, so the city and its map are always committed together.
+	std::vector<char> record_vec;
+	this->encode_record(record_vec);
+	if (!MapChunkFile::write(slot.get_map_path(), m_width, m_height, m_tiles_vec, record_vec))
+		return false;
+	// The text city configuration file of old versions is superseded now.
+	std::remove(slot.get_cfg_path().c_str());
+
+	/* The header file only summarizes the save for the main menu, so the save is still complete even if it cannot be
+	 * written. */
+	slot.write_header(*this);
+	return true;
+}
+
+bool CitySnapshot::load(const SaveSlot& slot, bool& is_legacy)
+{
+	PROFILE_SCOPE("CitySnapshot::load");
+	is_legacy = false;
+	m_name = slot.get_default_name();
+
+	MapChunkFile chunk_file;
+	if (MapChunkFile::is_chunk_file(slot.get_map_path()))
+	{
+		if (!chunk_file.open(slot.get_map_path()))
+			return false;
+		if (!chunk_file.get_city_record().empty())
+		{
+			if (!this->decode_record(chunk_file.get_city_record()))
+			{
+				std::cerr << "Error, invalid city record in game map file " << slot.get_map_path() << '\n';
+				return false;
+			}
+			m_width = chunk_file.get_width();
+			m_height = chunk_file.get_height();
+			return chunk_file.read_all(m_tiles_vec);
+		}
+	}
+
+	// Saves written by old versions keep the city's properties inside the text city configuration file.
+	is_legacy = true;
+	return this->import_text(slot.get_cfg_path()) &&
+		MapChunkFile::load(slot.get_map_path(), m_width, m_height, m_tiles_vec);
+}
+
+void CitySnapshot::encode_record(std::vector<char>& record_vec) const
+{
+	// Lay out each property's value one after another.
+	std::vector<char> values_vec;
+	std::vector<std::uint32_t> field_table_vec;
+	for (const auto& each_field : CITY_FIELD_ARR)
+	{
+		const std::size_t offset = values_vec.size();
+		if (each_field.m_unsigned_ptr != nullptr)
+			append_value(values_vec, static_cast<std::uint32_t>(this->*each_field.m_unsigned_ptr));
+		else if (each_field.m_double_ptr != nullptr)
+			append_value(values_vec, this->*each_field.m_double_ptr);
+		else
+			values_vec.insert(values_vec.end(), (this->*each_field.m_string_ptr).begin(),
+				(this->*each_field.m_string_ptr).end());
+		field_table_vec.insert(field_table_vec.end(), { each_field.m_id, static_cast<std::uint32_t>(offset),
+			static_cast<std::uint32_t>(values_vec.size() - offset) });
+	}
+
+	// The record is the amount of fields, the field table and then all values.
+	record_vec.clear();
+	append_value(record_vec, static_cast<std::uint32_t>(field_table_vec.size() / 3));
+	for (const auto each_value : field_table_vec)
+		append_value(record_vec, each_value);
+	record_vec.insert(record_vec.end(), values_vec.begin(), values_vec.end());
+}
+
+bool CitySnapshot::decode_record(const std::vector<char>& record_vec)
+{
+	std::uint32_t fields_num{0};
+	if (record_vec.size() < sizeof(fields_num))
+		return false;
+	std::memcpy(&fields_num, record_vec.data(), sizeof(fields_num));
+	const std::size_t values_offset = sizeof(fields_num) + static_cast<std::size_t>(fields_num) * 3 *
+		sizeof(std::uint32_t);
+	if (values_offset > record_vec.size())
+		return false;
+
+	for (std::uint32_t i = 0; i < fields_num; ++i)
+	{
+		std::uint32_t entry_arr[3]{ 0, 0, 0 };
+		std::memcpy(entry_arr, record_vec.data() + sizeof(fields_num) + i * sizeof(entry_arr), sizeof(entry_arr));
+		if (static_cast<std::size_t>(entry_arr[1]) + entry_arr[2] > record_vec.size() - values_offset)
+			return false;
+		const char* value_ptr = record_vec.data() + values_offset + entry_arr[1];
+
+		// Skip properties added by newer versions.
+		const auto field_it = std::find_if(std::begin(CITY_FIELD_ARR), std::end(CITY_FIELD_ARR),
+			[&entry_arr](const CityField& field) { return field.m_id == entry_arr[0]; });
+		if (field_it == std::end(CITY_FIELD_ARR))
+			continue;
+
+		if (field_it->m_unsigned_ptr != nullptr && entry_arr[2] == sizeof(std::uint32_t))
+		{
+			std::uint32_t value{0};
+			std::memcpy(&value, value_ptr, sizeof(value));
+			this->*field_it->m_unsigned_ptr = value;
+		}
+		else if (field_it->m_double_ptr != nullptr && entry_arr[2] == sizeof(double))
+			std::memcpy(&(this->*field_it->m_double_ptr), value_ptr, sizeof(double));
+		else if (field_it->m_string_ptr != nullptr)
+			(this->*field_it->m_string_ptr).assign(value_ptr, entry_arr[2]);
+		else
+			return false;
+	}
+	return true;
+}
+
+void CitySnapshot::write(std::ostream& output_stream) const
+{
+	std::vector<char> record_vec;
+	this->encode_record(record_vec);
+	const std::uint32_t record_size = static_cast<std::uint32_t>(record_vec.size());
+	output_stream.write(reinterpret_cast<const char*>(&record_size), sizeof(std::uint32_t));
+	output_stream.write(record_vec.data(), static_cast<std::streamsize>(record_vec.size()));
+	MapChunkFile::write_tiles(output_stream, m_tiles_vec);
+}
+
+bool CitySnapshot::read(std::istream& input_stream)
+{
+	std::uint32_t record_size{0};
+	if (!input_stream.read(reinterpret_cast<char*>(&record_size), sizeof(std::uint32_t)))
+		return false;
+	std::vector<char> record_vec(record_size);
+	if (!input_stream.read(record_vec.data(), static_cast<std::streamsize>(record_vec.size())) ||
+		!this->decode_record(record_vec))
+		return false;
+	// The map's dimension is a part of the city's record.
+	m_tiles_vec.assign(static_cast<std::size_t>(m_width) * m_height, TileSnapshot());
+	return MapChunkFile::read_tiles(input_stream, m_tiles_vec, true);
+}
+
+bool CitySnapshot::export_text(const std::string& cfg_path) const
+{
+	std::ofstream output_file(cfg_path, std::ios::out | std::ios::trunc);
+	// Keep every digit so that the imported city is identical to the exported one.
+	output_file << std::setprecision(std::numeric_limits<double>::max_digits10);
+
+	// Save each property name and value.
+	for (const auto& each_field : CITY_FIELD_ARR)
+	{
+		output_file << each_field.m_name << '=';
+		if (each_field.m_unsigned_ptr != nullptr)
+			output_file << this->*each_field.m_unsigned_ptr << '\n';
+		else if (each_field.m_double_ptr != nullptr)
+			output_file << this->*each_field.m_double_ptr << '\n';
+		else
+			output_file << this->*each_field.m_string_ptr << '\n';
+	}
+
+	// Close the file and check if everything has been written.
+	output_file.close();
+	if (output_file.fail())
+	{
+		std::cerr << "Error, failed to write city configuration file " << cfg_path << '\n';
+		return false;
+	}
+	return true;
+}
+
+bool CitySnapshot::import_text(const std::string& cfg_path)
+{
+	std::ifstream input_file(cfg_path, std::ios::in);
+	if (input_file.fail())
+		return false;
+
+	// Files written before the seed was stored get a random one.
+	m_seed = std::random_device()();
+	std::string each_line_str;
+	while (std::getline(input_file, each_line_str))
+	{
+		// Each line is a property name and its value, delimited by '='.
+		const std::size_t delimiter_pos = each_line_str.find('=');
+		if (delimiter_pos == std::string::npos)
+			continue;
+		const auto field_it = std::find_if(std::begin(CITY_FIELD_ARR), std::end(CITY_FIELD_ARR),
+			[&each_line_str, delimiter_pos](const CityField& field)
+		{
+			return each_line_str.compare(0, delimiter_pos, field.m_name) == 0;
+		});
+		if (field_it == std::end(CITY_FIELD_ARR))
+			continue;
+
+		std::istringstream value_stream(each_line_str.substr(delimiter_pos + 1));
+		if (field_it->m_unsigned_ptr != nullptr)
+			value_stream >> this->*field_it->m_unsigned_ptr;
+		else if (field_it->m_double_ptr != nullptr)
+			value_stream >> this->*field_it->m_double_ptr;
+		else
+			this->*field_it->m_string_ptr = value_stream.str();
+	}
+	return true;
+}
+
+bool CitySnapshot::commit_file(const std::string& temp_path, const std::string& target_path)
+{
+	// Rename is atomic on POSIX systems and replaces the target file directly.
+	if (std::rename(temp_path.c_str(), target_path.c_str()) == 0)
+		return true;
+
+	// Windows refuses to rename onto an existing file, so remove the old target file first and retry.
+	std::remove(target_path.c_str());
+	if (std::rename(temp_path.c_str(), target_path.c_str()) == 0)
+		return true;
+
+	std::cerr << "Error, failed to replace " << target_path << " with " << temp_path << '\n';
+	return false;
+}
+
+namespace
+{
+	/**
+	 * Mix the input value's bytes into the FNV-1a hash.
+	 * @param hash A reference of std::uint64_t indicates the hash to be updated.
+	 * @param value A reference of const T indicates the value to be hashed.
+	 */
+	template<typename T>
+	void hash_value(std::uint64_t& hash, const T& value)
+	{
+		const unsigned char* byte_ptr = reinterpret_cast<const unsigned char*>(&value);
+		for (std::size_t i = 0; i < sizeof(T); ++i)
+		{
+			hash ^= byte_ptr[i];
+			hash *= FNV_PRIME;
+		}
+	}
+}
+
+std::uint64_t CitySnapshot::get_hash() const
+{
+	// Hash each member separately so that padding bytes never affect the result.
+	std::uint64_t hash(FNV_OFFSET_BASIS);
+	hash_value(hash, m_width);
+	hash_value(hash, m_height);
+	hash_value(hash, m_day);
+	hash_value(hash, m_homeless_num);
+	hash_value(hash, m_unemployment_num);
+	hash_value(hash, m_city_population);
+	hash_value(hash, m_employable);
+	hash_value(hash, m_birth_rate_per_day);
+	hash_value(hash, m_death_rate_per_day);
+	hash_value(hash, m_residential_tax_rate);
+	hash_value(hash, m_commercial_tax_rate);
+	hash_value(hash, m_industrial_tax_rate);
+	hash_value(hash, m_fund);
+	hash_value(hash, m_curr_month_earnings);
+	hash_value(hash, m_seed);
+	for (const auto& each_tile : m_tiles_vec)
+	{
+		hash_value(hash, each_tile.m_tileType);
+		hash_value(hash, each_tile.m_level);
+		hash_value(hash, each_tile.m_region_arr[0]);
+		hash_value(hash, each_tile.m_population);
+		hash_value(hash, each_tile.m_total_production);
+		hash_value(hash, each_tile.m_resource);
+		hash_value(hash, each_tile.m_production_per_day);
+	}
+	return hash;
+}
@@ -1,25 +1,107 @@
+#include <future>
+#include <iostream>
 #include "Game.hpp"
 #include "GameState.hpp"
 #include "GuiStyle.hpp"
-#include "Utility.hpp"
+#include "Profiler.hpp"
+#include "RenderUtility.hpp"
 
-Game::Game()
+namespace
 {
+	/**
+	 * Describes how one type of tile looks, each tile's animations are copies of one animation.
+	 */
+	struct TileSpec
+	{
+		const std::string& m_name;
+		unsigned int m_height_num;
+		Animation m_animation;
+		unsigned int m_animations_num;
+		TileTypeEnum m_tileType;
+	};
+
+	const Animation DEFAULT_ANIMATION(GENERAL_ANIMATION_START_FRAME, GENERAL_ANIMATION_END_FRAME,
+		GENERAL_ANIMATION_EACH_FRAME_DURATION);
+
+	const TileSpec TILE_SPEC_ARR[] = {
+		// For grass tile and forest tile, there is only 1 instant animation. Initial height is 1 half tile width.
+		{ GRASS_TILE_TEXTURE_NAME, GRASS_HALF_TILE_WIDTH_NUM, DEFAULT_ANIMATION, 1, TileTypeEnum::GRASS },
+		{ FOREST_TILE_TEXTURE_NAME, FOREST_HALF_TILE_WIDTH_NUM, DEFAULT_ANIMATION, 1, TileTypeEnum::FOREST },
+		/* For water tile, there are 3 animation, each animation consists of 4 frames, each frame takes 0.5 seconds.
+		 * Initial height is 1 half tile width.*/
+		{ WATER_TILE_TEXTURE_NAME, WATER_HALF_TILE_WIDTH_NUM, Animation(WATER_ANIM_START_FRAME, WATER_ANIM_END_FRAME,
+		  WATER_ANIM_EACH_FRAME_DURATION), 3, TileTypeEnum::WATER },
+		// For residential tile, there are 6 instant animation. Initial height is 2 half tile width.
+		{ RESIDENTIAL_TILE_TEXTURE_NAME, RESIDENTIAL_HALF_TILE_WIDTH_NUM, DEFAULT_ANIMATION, 6,
+		  TileTypeEnum::RESIDENTIAL },
+		// For commercial tile, there are 4 instant animation. Initial height is 2 half tile width.
+		{ COMMERCIAL_TILE_TEXTURE_NAME, COMMERCIAL_HALF_TILE_WIDTH_NUM, DEFAULT_ANIMATION, 4,
+		  TileTypeEnum::COMMERCIAL },
+		// For industrial tile, there are 4 instant animation. Initial height is 2 half tile width.
+		{ INDUSTRIAL_TILE_TEXTURE_NAME, INDUSTRIAL_HALF_TILE_WIDTH_NUM, DEFAULT_ANIMATION, 4,
+		  TileTypeEnum::INDUSTRIAL },
+		// For road tile, there are 11 instant animation. Initial height is 1 half tile width.
+		{ ROAD_TILE_TEXTURE_NAME, ROAD_HALF_TILE_WIDTH_NUM, DEFAULT_ANIMATION, 11, TileTypeEnum::ROAD }
+	};
+}
+
+Game::Game() : m_asset_pack_ptr(std::make_shared<AssetPack>())
+{
+	const auto startup_time = std::chrono::steady_clock::now();
+	auto step_time = startup_time;
+
+	// Map the prebuilt asset pack, the loose image and font files are used if it is missing or incomplete.
+	const bool is_pack_used = this->open_asset_pack();
+	this->trace_startup_step(is_pack_used ? "map asset pack" : "look for asset pack", step_time);
+
+	/* Without the asset pack, decode all game images in background while the game window is created, only uploading
+	 * the images into textures needs the window's OpenGL context. The font is loaded in background either way.*/
+	std::vector<sf::Image> image_vec;
+	double decode_sum_ms{0.0};
+	std::future<void> decode_future;
+	if (!is_pack_used)
+	{
+		decode_future = std::async(std::launch::async, [&image_vec, &decode_sum_ms]()
+		{
+			TextureManager::decodeImages(get_game_texture_paths(), image_vec, decode_sum_ms);
+		});
+	}
+	auto font_future = std::async(std::launch::async, &Game::load_fonts, this);
+
 	// Create a 1280 X 720 game window with the title "City Builder" and set max frame rate to be 60fps.
 	m_game_window.create(sf::VideoMode(GAME_WINDOW_WIDTH, GAME_WINDOW_HEIGHT),
 		GAME_TITLE);
 	m_game_window.setFramerateLimit(FPS);
+	this->trace_startup_step("create window", step_time);
 
-	// Load all game textures.
-	Game::load_game_textures();
-	// Create and store all 7 types of tiles.
-	this->load_tiles();
+	if (is_pack_used)
+	{
+		// Create the textures straight from the pack's pixels.
+		TextureManager::storePackedTextures(m_asset_pack_ptr->get_textures());
+		this->trace_startup_step("upload textures from asset pack", step_time);
+	}
+	else
+	{
+		// Wait for the decoded images, then upload them into the TextureManager.
+		decode_future.get();
+		this->trace_startup_step("wait for decoded images", step_time);
+		m_startup_trace_vec.emplace_back("decode images one by one(summed)", decode_sum_ms);
+		TextureManager::storeImages(get_game_texture_names(), image_vec);
+		this->trace_startup_step("upload textures", step_time);
+	}
+
+	// Create and store all 7 types of tiles and how they look.
+	load_tiles(m_str_tile_map);
+	Game::load_map_renderer(m_map_renderer, is_pack_used ? m_asset_pack_ptr.get() : nullptr);
 	// Set up game background's sprite object.
 	m_background_sprite.setTexture(TextureManager::getInstance()->
 	getTextureRef(GAME_BACKGROUND_TEXTURE_NAME));
-	// Load font and Gui styles.
-	this->load_fonts();
+	// Wait for the font, then create the Gui styles.
+	font_future.get();
 	this->load_Gui_styles();
+	this->trace_startup_step("create tiles and Gui styles", step_time);
+	m_startup_trace_vec.emplace_back("total", std::chrono::duration<double, std::milli>(
+		std::chrono::steady_clock::now() - startup_time).count());
 }
 
 Game::~Game()
@@ -58,6 +140,7 @@ void Game::game_loop()
 	sf::Clock game_clock;
 	while (m_game_window.isOpen())
 	{
+		PROFILE_SCOPE("Game::game_loop frame");
 		// Get the elapsed time since last frame and convert it to seconds inside a float value.
 		sf::Time elapsed_time(game_clock.restart());
 		float delta_time = elapsed_time.asSeconds();
@@ -75,85 +158,63 @@ void Game::game_loop()
 	}
 }
 
-void Game::load_game_textures()
+const std::vector<std::string>& Game::get_game_texture_names()
 {
-	TextureManager::getInstance()->loadTexture(GAME_BACKGROUND_TEXTURE_NAME,
-		GAME_BACKGROUND_TEXTURE_PATH);
-	TextureManager::getInstance()->loadTexture(GRASS_TILE_TEXTURE_NAME, GRASS_TILE_TEXTURE_PATH);
-	TextureManager::getInstance()->loadTexture(ROAD_TILE_TEXTURE_NAME, ROAD_TILE_TEXTURE_PATH);
-	TextureManager::getInstance()->loadTexture(WATER_TILE_TEXTURE_NAME, WATER_TILE_TEXTURE_PATH);
-	TextureManager::getInstance()->loadTexture(RESIDENTIAL_TILE_TEXTURE_NAME,
-		RESIDENTIAL_TILE_TEXTURE_PATH);
-	TextureManager::getInstance()->loadTexture(FOREST_TILE_TEXTURE_NAME, FOREST_TILE_TEXTURE_PATH);
-	TextureManager::getInstance()->loadTexture(COMMERCIAL_TILE_TEXTURE_NAME,
-		COMMERCIAL_TILE_TEXTURE_PATH);
-	TextureManager::getInstance()->loadTexture(INDUSTRIAL_TILE_TEXTURE_NAME,
-		INDUSTRIAL_TILE_TEXTURE_PATH);
+	static const std::vector<std::string> texture_name_vec{ GAME_BACKGROUND_TEXTURE_NAME, GRASS_TILE_TEXTURE_NAME,
+		ROAD_TILE_TEXTURE_NAME, WATER_TILE_TEXTURE_NAME, RESIDENTIAL_TILE_TEXTURE_NAME, FOREST_TILE_TEXTURE_NAME,
+		COMMERCIAL_TILE_TEXTURE_NAME, INDUSTRIAL_TILE_TEXTURE_NAME };
+	return texture_name_vec;
 }
 
-void Game::load_tiles()
+const std::vector<std::string>& Game::get_game_texture_paths()
 {
-	// Create a local Animation object to help load all 7 types of tiles.
-	Animation default_anim(GENERAL_ANIMATION_START_FRAME, GENERAL_ANIMATION_END_FRAME,
-		GENERAL_ANIMATION_EACH_FRAME_DURATION);
+	static const std::vector<std::string> texture_path_vec{ GAME_BACKGROUND_TEXTURE_PATH, GRASS_TILE_TEXTURE_PATH,
+		ROAD_TILE_TEXTURE_PATH, WATER_TILE_TEXTURE_PATH, RESIDENTIAL_TILE_TEXTURE_PATH, FOREST_TILE_TEXTURE_PATH,
+		COMMERCIAL_TILE_TEXTURE_PATH, INDUSTRIAL_TILE_TEXTURE_PATH };
+	return texture_path_vec;
+}
 
-	/* For grass tile and forest tile, there is only 1 instant animation. Initial height is 1 half tile width,
-	 * initial cost is 50, no population allowed, max level is 1.*/
-	m_str_tile_map[GRASS_TILE_TEXTURE_NAME] = Tile(m_tile_half_width_pixel,
-		GRASS_HALF_TILE_WIDTH_NUM,TextureManager::getInstance()->
-		getTextureRef(GRASS_TILE_TEXTURE_NAME),{default_anim},TileTypeEnum::GRASS,
-		GRASS_TILE_COST, GRASS_CURR_LEVEL_POPULATION_LIMIT,GRASS_TILE_MAX_LEVEL);
-
-	// For forest tile, initial height is 1 half tile width, initial cost is 100, max level is 1.
-	m_str_tile_map[FOREST_TILE_TEXTURE_NAME] = Tile(m_tile_half_width_pixel,
-		FOREST_HALF_TILE_WIDTH_NUM,TextureManager::getInstance()->
-		getTextureRef(FOREST_TILE_TEXTURE_NAME),{default_anim},TileTypeEnum::FOREST,
-		FOREST_TILE_COST, FOREST_CURR_LEVEL_POPULATION_LIMIT,FOREST_TILE_MAX_LEVEL);
-
-	/* For water tile, there are 3 animation, each animation consists of 4 frames, each frame takes 0.5 seconds.
-	 * Initial height is 1 half tile width, initial cost is 0, no population allowed, max level is 1.*/
-	m_str_tile_map[WATER_TILE_TEXTURE_NAME] = Tile(m_tile_half_width_pixel,
-		WATER_HALF_TILE_WIDTH_NUM,TextureManager::getInstance()->
-		getTextureRef(WATER_TILE_TEXTURE_NAME),{Animation(WATER_ANIM_START_FRAME,
-			WATER_ANIM_END_FRAME,WATER_ANIM_EACH_FRAME_DURATION),
-												Animation(WATER_ANIM_START_FRAME,
-			WATER_ANIM_END_FRAME, WATER_ANIM_EACH_FRAME_DURATION),
-	 Animation(WATER_ANIM_START_FRAME, WATER_ANIM_END_FRAME,
-		 WATER_ANIM_EACH_FRAME_DURATION)}, TileTypeEnum::WATER,
-		WATER_TILE_COST, WATER_CURR_LEVEL_POPULATION_LIMIT, WATER_TILE_MAX_LEVEL);
-
-	/* For residential tile, there are 6 instant animation. Initial height is 2 half tile width, initial cost is 300,
-	 * initial population is 50, max level is 6.*/
-	m_str_tile_map[RESIDENTIAL_TILE_TEXTURE_NAME] = Tile(m_tile_half_width_pixel,
-		RESIDENTIAL_HALF_TILE_WIDTH_NUM,TextureManager::getInstance()->
-		getTextureRef(RESIDENTIAL_TILE_TEXTURE_NAME),{default_anim, default_anim, default_anim,
-	default_anim, default_anim, default_anim},TileTypeEnum::RESIDENTIAL,RESIDENTIAL_TILE_COST,
-	RESIDENTIAL_CURR_LEVEL_POPULATION_LIMIT, RESIDENTIAL_TILE_MAX_LEVEL);
-
-	/* For commercial tile, there are 4 instant animation. Initial height is 2 half tile width, initial cost is 300,
- 	 * initial population is 50, max level is 4.*/
-	m_str_tile_map[COMMERCIAL_TILE_TEXTURE_NAME] = Tile(m_tile_half_width_pixel,
-		COMMERCIAL_HALF_TILE_WIDTH_NUM,TextureManager::getInstance()->
-		getTextureRef(COMMERCIAL_TILE_TEXTURE_NAME),{default_anim, default_anim,
-	default_anim, default_anim},TileTypeEnum::COMMERCIAL,COMMERCIAL_TILE_COST,
-	COMMERCIAL_CURR_LEVEL_POPULATION_LIMIT, COMMERCIAL_TILE_MAX_LEVEL);
-
-	/* For industrial tile, there are 3 instant animation. Initial height is 2 half tile width, initial cost is 300,
-     * initial population is 50, max level is 4.*/
-	m_str_tile_map[INDUSTRIAL_TILE_TEXTURE_NAME] = Tile(m_tile_half_width_pixel,
-		INDUSTRIAL_HALF_TILE_WIDTH_NUM,TextureManager::getInstance()->
-		getTextureRef(INDUSTRIAL_TILE_TEXTURE_NAME),{default_anim, default_anim,
-	default_anim, default_anim},TileTypeEnum::INDUSTRIAL,INDUSTRIAL_TILE_COST,
-	INDUSTRIAL_CURR_LEVEL_POPULATION_LIMIT, INDUSTRIAL_TILE_MAX_LEVEL);
-
-	/* For road tile, there are 11 instant animation. Initial height is 1 half tile width, initial cost is 100,
-	 * no population allowed, max level is 1.*/
-	m_str_tile_map[ROAD_TILE_TEXTURE_NAME] = Tile(m_tile_half_width_pixel,
-		ROAD_HALF_TILE_WIDTH_NUM,TextureManager::getInstance()->
-		getTextureRef(ROAD_TILE_TEXTURE_NAME),{default_anim, default_anim, default_anim,
-											   default_anim, default_anim, default_anim, default_anim,
-	 default_anim, default_anim, default_anim, default_anim},TileTypeEnum::ROAD,ROAD_TILE_COST,
-	 ROAD_CURR_LEVEL_POPULATION_LIMIT, ROAD_TILE_MAX_LEVEL);
+std::vector<Animation> Game::get_tile_animations(const std::string& tile_name)
+{
+	for (const auto& each_spec : TILE_SPEC_ARR)
+	{
+		if (each_spec.m_name == tile_name)
+			return std::vector<Animation>(each_spec.m_animations_num, each_spec.m_animation);
+	}
+	return std::vector<Animation>();
+}
+
+sf::IntRect Game::get_tile_frame_rect(const std::string& tile_name)
+{
+	for (const auto& each_spec : TILE_SPEC_ARR)
+	{
+		if (each_spec.m_name == tile_name)
+			return sf::IntRect(0, 0, 2 * m_tile_half_width_pixel,
+				m_tile_half_width_pixel * static_cast<int>(each_spec.m_height_num));
+	}
+	return sf::IntRect();
+}
+
+void Game::load_map_renderer(MapRenderer& map_renderer, const AssetPack* asset_pack_ptr)
+{
+	for (const auto& each_spec : TILE_SPEC_ARR)
+	{
+		// Tiles loaded from the asset pack take their frame height and animations from it.
+		unsigned int height_num = each_spec.m_height_num;
+		std::vector<Animation> anim_vec(each_spec.m_animations_num, each_spec.m_animation);
+		const PackedTexture* packed_texture_ptr = asset_pack_ptr == nullptr ? nullptr :
+			asset_pack_ptr->find_texture(each_spec.m_name);
+		if (packed_texture_ptr != nullptr && !packed_texture_ptr->m_animations_vec.empty())
+		{
+			height_num = static_cast<unsigned int>(packed_texture_ptr->m_frame_rect.height) / m_tile_half_width_pixel;
+			anim_vec.clear();
+			for (const auto& each_anim : packed_texture_ptr->m_animations_vec)
+				anim_vec.emplace_back(each_anim.m_start_frame, each_anim.m_end_frame, each_anim.m_duration);
+		}
+
+		map_renderer.add_tile(each_spec.m_tileType, m_tile_half_width_pixel, height_num, TextureManager::getInstance()->
+			getTextureRef(each_spec.m_name), anim_vec);
+	}
 }
 
 void Game::load_Gui_styles()
@@ -170,11 +231,49 @@ void Game::load_Gui_styles()
 		sf::Color::Black,sf::Color::Red));
 }
 
+bool Game::open_asset_pack()
+{
+	if (!m_asset_pack_ptr->open(ASSET_PACK_PATH))
+		return false;
+
+	// Only use the pack if it holds every texture and the font, otherwise it was built for another version.
+	bool is_complete = m_asset_pack_ptr->find_font(FONT_NAME) != nullptr;
+	for (const auto& each_name : get_game_texture_names())
+		is_complete = is_complete && m_asset_pack_ptr->find_texture(each_name) != nullptr;
+	if (!is_complete)
+	{
+		std::cerr << "Warning, asset pack " << ASSET_PACK_PATH << " is incomplete, loose asset files are used instead\n";
+		m_asset_pack_ptr->close();
+	}
+	return is_complete;
+}
+
 void Game::load_fonts()
 {
-	sf::Font font;
-	font.loadFromFile(FONT_PATH);
-	m_str_font_ptr_map[FONT_NAME] = std::make_shared<sf::Font>(font);
+	// Load the font into its shared object directly instead of copying a loaded one.
+	auto font_ptr = std::make_shared<sf::Font>();
+	// The font's bytes inside the asset pack stay mapped as long as the Game object lives.
+	const PackedFont* packed_font_ptr = m_asset_pack_ptr->is_open() ? m_asset_pack_ptr->find_font(FONT_NAME) :
+		nullptr;
+	if (packed_font_ptr != nullptr)
+		font_ptr->loadFromMemory(packed_font_ptr->m_data_ptr, packed_font_ptr->m_size);
+	else
+		font_ptr->loadFromFile(FONT_PATH);
+	m_str_font_ptr_map[FONT_NAME] = std::move(font_ptr);
+}
+
+void Game::trace_startup_step(const std::string& step_name, std::chrono::steady_clock::time_point& step_time)
+{
+	const auto curr_time = std::chrono::steady_clock::now();
+	m_startup_trace_vec.emplace_back(step_name, std::chrono::duration<double, std::milli>(curr_time - step_time)
+		.count());
+	step_time = curr_time;
+}
+
+void Game::print_startup_trace(std::ostream& output) const
+{
+	for (const auto& each_step : m_startup_trace_vec)
+		output << "Startup " << each_step.first << ": " << each_step.second << " ms\n";
 }
 
 std::shared_ptr<GuiStyle> Game::getGuiStylePtr(const std::string& Gui_style_name) const
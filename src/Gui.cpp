@@ -1,5 +1,41 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
 #include "Gui.hpp"
 
+namespace
+{
+	/**
+	 * Append a rectangle as two triangles into the vertex array.
+	 * @param vertex_arr A reference of sf::VertexArray object to be appended.
+	 * @param transform A reference of const sf::Transform object which transforms the rectangle's corners.
+	 * @param rect A reference of const sf::FloatRect object indicates the rectangle in local coordinates.
+	 * @param color A reference of const sf::Color object indicates the rectangle's color.
+	 * @param texture_rect A reference of const sf::FloatRect object indicates the rectangle's texture coordinates.
+	 */
+	void append_rect(sf::VertexArray& vertex_arr, const sf::Transform& transform, const sf::FloatRect& rect,
+		const sf::Color& color, const sf::FloatRect& texture_rect = sf::FloatRect())
+	{
+		const sf::Vertex top_left(transform.transformPoint(sf::Vector2f(rect.left, rect.top)), color,
+			sf::Vector2f(texture_rect.left, texture_rect.top));
+		const sf::Vertex top_right(transform.transformPoint(sf::Vector2f(rect.left + rect.width, rect.top)), color,
+			sf::Vector2f(texture_rect.left + texture_rect.width, texture_rect.top));
+		const sf::Vertex bottom_left(transform.transformPoint(sf::Vector2f(rect.left, rect.top + rect.height)), color,
+			sf::Vector2f(texture_rect.left, texture_rect.top + texture_rect.height));
+		const sf::Vertex bottom_right(transform.transformPoint(sf::Vector2f(rect.left + rect.width,
+			rect.top + rect.height)), color, sf::Vector2f(texture_rect.left + texture_rect.width,
+			texture_rect.top + texture_rect.height));
+
+		// Two triangles, GUI_RECT_VERTICES_NUM vertices in total.
+		vertex_arr.append(top_left);
+		vertex_arr.append(top_right);
+		vertex_arr.append(bottom_left);
+		vertex_arr.append(bottom_left);
+		vertex_arr.append(top_right);
+		vertex_arr.append(bottom_right);
+	}
+}
+
 sf::Vector2f Gui::get_gui_size() const
 {
 	return {m_entry_shape_dimension.x, m_entry_shape_dimension.y * m_Gui_entry_vec.size()};
@@ -7,39 +43,25 @@ sf::Vector2f Gui::get_gui_size() const
 
 int Gui::get_gui_entry_idx(const sf::Vector2f& mouse_pos) const
 {
-	// If no GuiEntry objects exist, or the GUI is not visible, then return -1.
-	if (m_Gui_entry_vec.empty())
+	// If no GuiEntry objects are shown, or the GUI is not visible, then return -1.
+	if (m_entry_bounds_vec.empty())
 		return -1;
 	if (!m_is_visible)
 		return -1;
 
-	// Traverse each GuiEntry object.
-	for (size_t i = 0; i < m_Gui_entry_vec.size(); ++i)
-	{
-		// Initialize relative position with original mouse position.
-		sf::Vector2f relative_pos(mouse_pos);
-
-		// Convert mouse position from GUI view's screen coordinate into each GuiEntry object's local coordinate.
-
-		/* The origin of GuiEntry object's shape defines the local point for all transformations. Default value is
-		 * (0, 0) but can be updated. Therefore, we add this value into current mouse position as offset. Now we are
-         * comparing between origin.x to (origin.x + width) and origin.y to (origin.y + height). */
-		relative_pos += m_Gui_entry_vec[i].m_entry_shape.getOrigin();
-		// Remove position offset since we only want to compare between 0 to width and 0 to height.
-		relative_pos -= m_Gui_entry_vec[i].m_entry_shape.getPosition();
-
-		// Ignore all positions that are not within the relative GuiEntry object's shape.
-		if (relative_pos.x < 0 || relative_pos.x > (m_Gui_entry_vec[i].m_entry_shape.getScale().x *
-		m_entry_shape_dimension.x))
-			continue;
-		if (relative_pos.y < 0 || relative_pos.y > (m_Gui_entry_vec[i].m_entry_shape.getScale().y *
-		m_entry_shape_dimension.y))
-			continue;
-		return i;
-	}
-
-	// If not find, then return -1.
-	return -1;
+	/* Find the only GuiEntry object which can be under the mouse from the mouse's offset to the first one, then check
+	 * whether the mouse is within its bounds. */
+	const sf::FloatRect& first_bounds = m_entry_bounds_vec.front();
+	if (first_bounds.width <= 0.f || first_bounds.height <= 0.f)
+		return -1;
+	const float entry_offset = m_is_horizontal ? (mouse_pos.x - first_bounds.left) / first_bounds.width :
+		(mouse_pos.y - first_bounds.top) / first_bounds.height;
+	if (!(entry_offset >= 0.f))
+		return -1;
+	const std::size_t entry_idx = std::min(static_cast<std::size_t>(entry_offset), m_entry_bounds_vec.size() - 1);
+	if (!m_entry_bounds_vec[entry_idx].contains(mouse_pos))
+		return -1;
+	return static_cast<int>(entry_idx);
 }
 
 void Gui::set_gui_entry_text(int entry_idx, const std::string& entry_text)
@@ -48,8 +70,33 @@ void Gui::set_gui_entry_text(int entry_idx, const std::string& entry_text)
 	if (entry_idx < 0 || entry_idx >= m_Gui_entry_vec.size())
 		return;
 
-	// Set the text content.
+	// Set the text content, it is no longer bound to any value.
 	m_Gui_entry_vec[entry_idx].m_text.setString(entry_text);
+	m_Gui_entry_vec[entry_idx].m_bound_format = nullptr;
+	m_is_vertices_dirty = true;
+}
+
+bool Gui::set_gui_entry_values(int entry_idx, const char* format, std::initializer_list<double> value_list)
+{
+	// Check if entry_idx is valid or not.
+	if (entry_idx < 0 || entry_idx >= m_Gui_entry_vec.size() || value_list.size() > GUI_ENTRY_BOUND_VALUES_NUM)
+		return false;
+
+	// Skip formatting if the text already shows the same values.
+	GuiEntry& entry = m_Gui_entry_vec[entry_idx];
+	double value_arr[GUI_ENTRY_BOUND_VALUES_NUM]{};
+	std::copy(value_list.begin(), value_list.end(), value_arr);
+	if (entry.m_bound_format == format && std::equal(value_arr, value_arr + GUI_ENTRY_BOUND_VALUES_NUM,
+		entry.m_bound_value_arr))
+		return false;
+
+	// Unused values are passed too, the format simply ignores them.
+	std::snprintf(entry.m_text_buffer_arr, GUI_ENTRY_TEXT_BUFFER_SIZE, format, value_arr[0], value_arr[1]);
+	entry.m_text.setString(entry.m_text_buffer_arr);
+	entry.m_bound_format = format;
+	std::copy(value_arr, value_arr + GUI_ENTRY_BOUND_VALUES_NUM, entry.m_bound_value_arr);
+	m_is_vertices_dirty = true;
+	return true;
 }
 
 void Gui::set_each_gui_entry_dimension(const sf::Vector2f& dimension)
@@ -64,20 +111,103 @@ void Gui::set_each_gui_entry_dimension(const sf::Vector2f& dimension)
 		each_entry.m_text.setCharacterSize(m_entry_shape_dimension.y - m_gui_style_ptr->m_outline_size -
 		m_text_padding);
 	}
+	this->update_entry_bounds();
+	m_is_vertices_dirty = true;
 }
 
 void Gui::draw(sf::RenderTarget& render_target, sf::RenderStates render_states) const
 {
 	// Check if GUI is visible or not.
-	if (!m_is_visible)
+	if (!m_is_visible || m_Gui_entry_vec.empty())
 		return;
 
-	// Draw each GuiEntry object.
-	for (auto& each_entry : m_Gui_entry_vec)
+	// Draw all shapes, then all texts with the glyph texture of their character size, which all GuiEntry objects share.
+	this->update_vertices();
+	render_target.draw(m_shape_vertex_arr, render_states);
+	render_states.texture = &m_gui_style_ptr->m_font_ptr->getTexture(m_Gui_entry_vec.front().m_text.
+		getCharacterSize());
+	render_target.draw(m_text_vertex_arr, render_states);
+}
+
+void Gui::update_vertices() const
+{
+	if (!m_is_vertices_dirty)
+		return;
+	m_shape_vertex_arr.clear();
+	m_text_vertex_arr.clear();
+	m_entry_shape_vertex_idx_vec.clear();
+	m_entry_text_vertex_idx_vec.clear();
+
+	const sf::Font& font = *(m_gui_style_ptr->m_font_ptr);
+	for (const auto& each_entry : m_Gui_entry_vec)
 	{
-		render_target.draw(each_entry.m_entry_shape);
-		render_target.draw(each_entry.m_text);
+		m_entry_shape_vertex_idx_vec.push_back(m_shape_vertex_arr.getVertexCount());
+		m_entry_text_vertex_idx_vec.push_back(m_text_vertex_arr.getVertexCount());
+
+		/* Fill the whole shape, then cover its outline band with four rectangles. Like sf::RectangleShape, a negative
+		 * outline thickness expands toward the inner part of the shape and a positive one toward the outer part. */
+		const sf::Transform shape_transform(each_entry.m_entry_shape.getTransform());
+		const sf::Vector2f shape_size(each_entry.m_entry_shape.getSize());
+		append_rect(m_shape_vertex_arr, shape_transform, sf::FloatRect(0.f, 0.f, shape_size.x, shape_size.y),
+			each_entry.m_entry_shape.getFillColor());
+
+		const float outline_thickness = each_entry.m_entry_shape.getOutlineThickness();
+		if (outline_thickness != 0.f)
+		{
+			const float outline_size = std::abs(outline_thickness);
+			const float outer_offset = std::max(outline_thickness, 0.f);
+			const sf::FloatRect outer_rect(-outer_offset, -outer_offset, shape_size.x + outer_offset * 2,
+				shape_size.y + outer_offset * 2);
+			const sf::Color& outline_color = each_entry.m_entry_shape.getOutlineColor();
+			append_rect(m_shape_vertex_arr, shape_transform, sf::FloatRect(outer_rect.left, outer_rect.top,
+				outer_rect.width, outline_size), outline_color);
+			append_rect(m_shape_vertex_arr, shape_transform, sf::FloatRect(outer_rect.left, outer_rect.top +
+				outer_rect.height - outline_size, outer_rect.width, outline_size), outline_color);
+			append_rect(m_shape_vertex_arr, shape_transform, sf::FloatRect(outer_rect.left, outer_rect.top +
+				outline_size, outline_size, outer_rect.height - outline_size * 2), outline_color);
+			append_rect(m_shape_vertex_arr, shape_transform, sf::FloatRect(outer_rect.left + outer_rect.width -
+				outline_size, outer_rect.top + outline_size, outline_size, outer_rect.height - outline_size * 2),
+				outline_color);
+		}
+
+		// Lay out the text's glyphs the same way as sf::Text, starting from the first line's baseline.
+		const sf::Transform text_transform(each_entry.m_text.getTransform());
+		const sf::String& text = each_entry.m_text.getString();
+		const unsigned int character_size = each_entry.m_text.getCharacterSize();
+		const sf::Color& text_color = each_entry.m_text.getFillColor();
+		const float whitespace_width = font.getGlyph(L' ', character_size, false).advance;
+		sf::Vector2f glyph_pos(0.f, static_cast<float>(character_size));
+		sf::Uint32 prev_char{0};
+		for (std::size_t i = 0; i < text.getSize(); ++i)
+		{
+			const sf::Uint32 curr_char = text[i];
+			glyph_pos.x += font.getKerning(prev_char, curr_char, character_size);
+			prev_char = curr_char;
+
+			// Whitespaces only move the pen.
+			if (curr_char == L' ' || curr_char == L'\t')
+			{
+				glyph_pos.x += curr_char == L' ' ? whitespace_width : whitespace_width * 4;
+				continue;
+			}
+			if (curr_char == L'\n')
+			{
+				glyph_pos = sf::Vector2f(0.f, glyph_pos.y + font.getLineSpacing(character_size));
+				continue;
+			}
+
+			const sf::Glyph& glyph = font.getGlyph(curr_char, character_size, false);
+			append_rect(m_text_vertex_arr, text_transform, sf::FloatRect(glyph_pos.x + glyph.bounds.left -
+				GUI_GLYPH_PADDING, glyph_pos.y + glyph.bounds.top - GUI_GLYPH_PADDING, glyph.bounds.width +
+				GUI_GLYPH_PADDING * 2, glyph.bounds.height + GUI_GLYPH_PADDING * 2), text_color, sf::FloatRect(
+				glyph.textureRect.left - GUI_GLYPH_PADDING, glyph.textureRect.top - GUI_GLYPH_PADDING,
+				glyph.textureRect.width + GUI_GLYPH_PADDING * 2, glyph.textureRect.height + GUI_GLYPH_PADDING * 2));
+			glyph_pos.x += glyph.advance;
+		}
 	}
+	m_entry_shape_vertex_idx_vec.push_back(m_shape_vertex_arr.getVertexCount());
+	m_entry_text_vertex_idx_vec.push_back(m_text_vertex_arr.getVertexCount());
+	m_is_vertices_dirty = false;
 }
 
 void Gui::show()
@@ -110,6 +240,8 @@ void Gui::show()
 		else
 			origin_offset.y += m_entry_shape_dimension.y;
 	}
+	this->update_entry_bounds();
+	m_is_vertices_dirty = true;
 }
 
 void Gui::hide()
@@ -119,23 +251,60 @@ void Gui::hide()
 
 void Gui::highlight_entry(const int entry_idx)
 {
-	for (size_t i = 0; i < m_Gui_entry_vec.size(); ++i)
-	{
-		// When find the specified GuiEntry object, then use highlighted colors.
-		if (i == entry_idx)
-		{
-			m_Gui_entry_vec[i].m_entry_shape.setFillColor(m_gui_style_ptr->m_background_highlight_color);
-			m_Gui_entry_vec[i].m_entry_shape.setOutlineColor(m_gui_style_ptr->m_outline_highlight_color);
-			m_Gui_entry_vec[i].m_text.setFillColor(m_gui_style_ptr->m_text_highlight_color);
-		}
-		// Otherwise, use normal colors.
-		else
-		{
-			m_Gui_entry_vec[i].m_entry_shape.setFillColor(m_gui_style_ptr->m_background_color);
-			m_Gui_entry_vec[i].m_entry_shape.setOutlineColor(m_gui_style_ptr->m_outline_color);
-			m_Gui_entry_vec[i].m_text.setFillColor(m_gui_style_ptr->m_text_color);
-		}
-	}
+	// Nothing changes if the same GuiEntry object is highlighted again.
+	if (entry_idx == m_highlighted_entry_idx)
+		return;
+
+	// Restore the previously highlighted GuiEntry object's colors, then highlight the new one.
+	this->color_entry(m_highlighted_entry_idx, false);
+	this->color_entry(entry_idx, true);
+	m_highlighted_entry_idx = entry_idx;
+}
+
+int Gui::highlight_hovered_entry(const sf::Vector2f& mouse_pos)
+{
+	const int entry_idx = this->get_gui_entry_idx(mouse_pos);
+	this->highlight_entry(entry_idx);
+	return entry_idx;
+}
+
+void Gui::update_entry_bounds()
+{
+	m_entry_bounds_vec.clear();
+	for (const auto& each_entry : m_Gui_entry_vec)
+		m_entry_bounds_vec.push_back(each_entry.m_entry_shape.getTransform().transformRect(
+			sf::FloatRect(sf::Vector2f(0.f, 0.f), m_entry_shape_dimension)));
+}
+
+void Gui::color_entry(const int entry_idx, const bool is_highlighted)
+{
+	// Check if entry_idx is valid or not.
+	if (entry_idx < 0 || entry_idx >= m_Gui_entry_vec.size())
+		return;
+
+	GuiEntry& entry = m_Gui_entry_vec[entry_idx];
+	const sf::Color& background_color = is_highlighted ? m_gui_style_ptr->m_background_highlight_color :
+		m_gui_style_ptr->m_background_color;
+	const sf::Color& outline_color = is_highlighted ? m_gui_style_ptr->m_outline_highlight_color :
+		m_gui_style_ptr->m_outline_color;
+	const sf::Color& text_color = is_highlighted ? m_gui_style_ptr->m_text_highlight_color :
+		m_gui_style_ptr->m_text_color;
+	entry.m_entry_shape.setFillColor(background_color);
+	entry.m_entry_shape.setOutlineColor(outline_color);
+	entry.m_text.setFillColor(text_color);
+
+	// The vertices are rebuilt with the new colors anyway if they are outdated.
+	if (m_is_vertices_dirty)
+		return;
+
+	// The shape's first rectangle is the fill, the others are the outline.
+	for (std::size_t i = m_entry_shape_vertex_idx_vec[entry_idx]; i < m_entry_shape_vertex_idx_vec[entry_idx + 1];
+		++i)
+		m_shape_vertex_arr[i].color = i < m_entry_shape_vertex_idx_vec[entry_idx] + GUI_RECT_VERTICES_NUM ?
+			background_color : outline_color;
+	for (std::size_t i = m_entry_text_vertex_idx_vec[entry_idx]; i < m_entry_text_vertex_idx_vec[entry_idx + 1];
+		++i)
+		m_text_vertex_arr[i].color = text_color;
 }
 
 std::string Gui::get_entry_msg(const int entry_idx) const
@@ -0,0 +1,164 @@
+// The entrance of the headless runner, which drives the city without any window for benchmarking.
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include "ActionTrace.hpp"
+#include "City.hpp"
+#include "CitySnapshot.hpp"
+#include "Profiler.hpp"
+#include "SaveSlot.hpp"
+#include "Utility.hpp"
+
+/**
+ * Replay an input trace(--replay <path>) or simulate days(--days <n>) on the saved city as fast as possible, then
+ * print the timing profile and the final city's state hash. The save slot can be chosen by --slot <n> and the seed can
+ * be overridden by --seed <n>, and each day's residential pass can be chosen by --residential-pass <serial|parallel>.
+ * The amount of tiles each day's residential pass updates is summarized, and written per day by --active-report <path>.
+ * Afterwards, the city can be advanced by many days at once through City::advanceDays by --fast-forward <n>.
+ * Save files are never written, but the final city's properties can be exported as text
+ * by --export-text <path>.
+ */
+int main(int argc, char* argv[])
+{
+	std::string replay_trace_path;
+	unsigned long days_num{0};
+	unsigned long seed{0};
+	bool is_seed_set{false};
+	unsigned long slot_idx{0};
+	std::string export_text_path;
+	bool is_residential_pass_parallel{false};
+	std::string active_report_path;
+	unsigned long fast_forward_days_num{0};
+	for (int i = 1; i + 1 < argc; ++i)
+	{
+		if (argv[i] == REPLAY_TRACE_OPTION_STR)
+			replay_trace_path = argv[++i];
+		else if (argv[i] == DAYS_OPTION_STR)
+			days_num = std::stoul(argv[++i]);
+		else if (argv[i] == SLOT_OPTION_STR)
+			slot_idx = std::stoul(argv[++i]);
+		else if (argv[i] == EXPORT_TEXT_OPTION_STR)
+			export_text_path = argv[++i];
+		else if (argv[i] == RESIDENTIAL_PASS_OPTION_STR)
+			is_residential_pass_parallel = (argv[++i] == RESIDENTIAL_PASS_PARALLEL_STR);
+		else if (argv[i] == ACTIVE_REPORT_OPTION_STR)
+			active_report_path = argv[++i];
+		else if (argv[i] == FAST_FORWARD_OPTION_STR)
+			fast_forward_days_num = std::stoul(argv[++i]);
+		else if (argv[i] == SEED_OPTION_STR)
+		{
+			seed = std::stoul(argv[++i]);
+			is_seed_set = true;
+		}
+	}
+	if (replay_trace_path.empty() && days_num == 0 && fast_forward_days_num == 0)
+	{
+		std::cerr << "Usage: citybuilder_headless [" << REPLAY_TRACE_OPTION_STR << " <trace path>] [" <<
+		DAYS_OPTION_STR << " <days>] [" << SEED_OPTION_STR << " <seed>] [" << SLOT_OPTION_STR << " <slot>] [" <<
+		EXPORT_TEXT_OPTION_STR << " <text path>] [" << RESIDENTIAL_PASS_OPTION_STR << " <" <<
+		RESIDENTIAL_PASS_SERIAL_STR << "|" << RESIDENTIAL_PASS_PARALLEL_STR << ">] [" << ACTIVE_REPORT_OPTION_STR <<
+		" <csv path>] [" << FAST_FORWARD_OPTION_STR << " <days>]\n";
+		return 1;
+	}
+
+	std::unordered_map<std::string, Tile> str_tile_map;
+	load_tiles(str_tile_map);
+
+	// Load the saved city without journaling, the same way as the main menu does when replaying.
+	City city(SaveSlot(static_cast<unsigned int>(slot_idx)), TILE_HALF_WIDTH, str_tile_map, false);
+
+	// A trace is replayed from its recorded city instead of the saved one.
+	std::shared_ptr<TracePlayer> trace_player_ptr;
+	if (!replay_trace_path.empty())
+	{
+		trace_player_ptr = std::make_shared<TracePlayer>(replay_trace_path);
+		if (!trace_player_ptr->is_valid() || !trace_player_ptr->restore_start(city, str_tile_map))
+			return 1;
+	}
+	if (is_seed_set)
+		city.set_seed(static_cast<unsigned int>(seed));
+	const unsigned int start_day = city.get_day();
+	city.set_residential_pass_parallel(is_residential_pass_parallel);
+
+	// Write the amount of tiles updated by each day's residential pass if required.
+	std::ofstream active_report_file;
+	if (!active_report_path.empty())
+	{
+		active_report_file.open(active_report_path);
+		if (!active_report_file)
+		{
+			std::cerr << "Failed to open " << active_report_path << '\n';
+			return 1;
+		}
+		active_report_file << "day,active_tiles\n";
+	}
+	unsigned int last_day{start_day};
+	std::size_t active_days_num{0};
+	std::size_t total_active_tiles_num{0};
+	std::size_t max_active_tiles_num{0};
+
+	// Play each frame and keep track of the slowest one.
+	std::size_t frames_num{0};
+	std::chrono::steady_clock::duration total_time{0};
+	std::chrono::steady_clock::duration max_frame_time{0};
+	while (true)
+	{
+		const auto frame_start_time = std::chrono::steady_clock::now();
+		if (trace_player_ptr)
+		{
+			if (!trace_player_ptr->play_frame(city, str_tile_map))
+				break;
+		}
+		else
+		{
+			if (frames_num == days_num)
+				break;
+			// Each update call processes one day since a day lasts zero seconds.
+			city.update(0.f);
+		}
+		const auto frame_time = std::chrono::steady_clock::now() - frame_start_time;
+		total_time += frame_time;
+		max_frame_time = std::max(max_frame_time, frame_time);
+		++frames_num;
+
+		// Only frames which processed a day ran a residential pass, the last one of them is reported.
+		if (city.get_day() != last_day)
+		{
+			last_day = city.get_day();
+			++active_days_num;
+			total_active_tiles_num += city.get_active_tiles_num();
+			max_active_tiles_num = std::max(max_active_tiles_num, city.get_active_tiles_num());
+			if (active_report_file)
+				active_report_file << city.get_day() << ',' << city.get_active_tiles_num() << '\n';
+		}
+	}
+
+	// Skip the remaining days at once, which is only stepped day by day until the city is steady.
+	if (fast_forward_days_num > 0)
+	{
+		const unsigned int fast_forward_start_day = city.get_day();
+		const auto fast_forward_start_time = std::chrono::steady_clock::now();
+		city.advanceDays(static_cast<unsigned int>(fast_forward_days_num));
+		std::cout << "fast-forward: " << fast_forward_start_day << " -> " << city.get_day() << " in " <<
+		std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - fast_forward_start_time).count() <<
+		" ms\n";
+	}
+
+	CitySnapshot snapshot;
+	city.take_snapshot(snapshot);
+	const double total_ms = std::chrono::duration<double, std::milli>(total_time).count();
+	std::cout << "frames: " << frames_num << '\n';
+	std::cout << "days: " << start_day << " -> " << city.get_day() << '\n';
+	std::cout << "total time: " << total_ms << " ms\n";
+	std::cout << "frame time: avg " << (frames_num ? total_ms / frames_num : 0.0) << " ms, max " <<
+	std::chrono::duration<double, std::milli>(max_frame_time).count() << " ms\n";
+	std::cout << "active tiles: avg " << (active_days_num ? total_active_tiles_num / active_days_num : 0) << ", max " <<
+	max_active_tiles_num << " of " << city.get_map_ptr()->get_tiles_amount() << '\n';
+	std::cout << "fund: " << city.get_fund() << ", population: " << city.get_population() << '\n';
+	std::cout << "seed: " << city.get_seed() << ", state hash: " << std::hex << snapshot.get_hash() << std::dec << '\n';
+	// Dump the profiling events of the whole run if profiling is compiled in.
+	PROFILE_DUMP(PROFILE_TRACE_PATH);
+	if (!export_text_path.empty() && !snapshot.export_text(export_text_path))
+		return 1;
+	return 0;
+}
@@ -0,0 +1,195 @@
+#include "JobSystem.hpp"
+
+namespace
+{
+	// The job system owning the current thread, null for threads outside any pool.
+	thread_local const JobSystem* t_owner_job_system_ptr{nullptr};
+	// The current thread's own queue inside its owning job system.
+	thread_local unsigned int t_queue_idx{0};
+}
+
+JobSystem::JobSystem(unsigned int threads_num)
+{
+	// The hardware concurrency is zero when it cannot be detected.
+	threads_num = std::max(threads_num, 1u);
+	for (unsigned int i = 0; i < threads_num; ++i)
+		m_queues_vec.emplace_back(new JobQueue);
+	for (unsigned int i = 1; i < threads_num; ++i)
+		m_workers_vec.emplace_back(&JobSystem::worker_loop, this, i);
+}
+
+JobSystem::~JobSystem()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_wake_mutex);
+		m_is_stopping = true;
+	}
+	m_wake_cv.notify_all();
+	for (auto& each_worker : m_workers_vec)
+		each_worker.join();
+}
+
+std::shared_ptr<JobSystem> JobSystem::getInstance()
+{
+	// Created on the first call, which is thread-safe for a function-local static object.
+	static std::shared_ptr<JobSystem> instance(new JobSystem);
+	return instance;
+}
+
+unsigned int JobSystem::get_threads_num() const
+{
+	return static_cast<unsigned int>(m_queues_vec.size());
+}
+
+void JobSystem::submit(std::function<void()> job_func, JobGroup& group)
+{
+	group.m_pending_num.fetch_add(1, std::memory_order_relaxed);
+	// Worker threads queue into their own queue, all other threads share queue 0.
+	const unsigned int queue_idx = (t_owner_job_system_ptr == this) ? t_queue_idx : 0;
+	{
+		std::lock_guard<std::mutex> lock(m_queues_vec[queue_idx]->m_mutex);
+		m_queues_vec[queue_idx]->m_jobs_deque.push_back(Job{std::move(job_func), &group});
+	}
+	m_queued_jobs_num.fetch_add(1, std::memory_order_release);
+
+	// Lock before notifying, so a worker checking the counter right before sleeping cannot miss the job.
+	{
+		std::lock_guard<std::mutex> lock(m_wake_mutex);
+	}
+	m_wake_cv.notify_one();
+}
+
+void JobSystem::wait(JobGroup& group)
+{
+	const unsigned int queue_idx = (t_owner_job_system_ptr == this) ? t_queue_idx : 0;
+	// Help with queued jobs instead of blocking, the group's jobs may be queued behind others.
+	while (!group.is_done())
+		if (!this->try_run_job(queue_idx))
+			std::this_thread::yield();
+}
+
+void JobSystem::parallel_for(std::size_t begin, std::size_t end, std::size_t grain_size,
+	const std::function<void(std::size_t, std::size_t)>& func)
+{
+	if (end <= begin)
+		return;
+	const std::size_t indices_num = end - begin;
+	const std::size_t auto_chunk_size = indices_num / (this->get_threads_num() * JOB_SYSTEM_CHUNKS_PER_THREAD);
+	const std::size_t chunk_size = std::max(std::max(grain_size, auto_chunk_size), static_cast<std::size_t>(1));
+
+	// A single chunk runs directly, which keeps small ranges free of any queuing.
+	if (chunk_size >= indices_num || this->get_threads_num() == 1)
+	{
+		func(begin, end);
+		return;
+	}
+
+	JobGroup group;
+	// Queue all chunks but the first one, which the calling thread runs itself.
+	for (std::size_t idx = begin + chunk_size; idx < end; idx += chunk_size)
+	{
+		const std::size_t chunk_end = std::min(idx + chunk_size, end);
+		this->submit([&func, idx, chunk_end]() { func(idx, chunk_end); }, group);
+	}
+	func(begin, begin + chunk_size);
+	this->wait(group);
+}
+
+bool JobSystem::try_run_job(unsigned int queue_idx)
+{
+	Job job;
+	bool is_found{false};
+	const unsigned int queues_num = this->get_threads_num();
+	// Take the own queue's newest job first, which is most likely still in the cache.
+	for (unsigned int i = 0; i < queues_num && !is_found; ++i)
+	{
+		JobQueue& queue = *m_queues_vec[(queue_idx + i) % queues_num];
+		std::lock_guard<std::mutex> lock(queue.m_mutex);
+		if (queue.m_jobs_deque.empty())
+			continue;
+		if (i == 0)
+		{
+			job = std::move(queue.m_jobs_deque.back());
+			queue.m_jobs_deque.pop_back();
+		}
+		// Steal other queues' oldest job, which tends to be the largest remaining piece of work.
+		else
+		{
+			job = std::move(queue.m_jobs_deque.front());
+			queue.m_jobs_deque.pop_front();
+		}
+		is_found = true;
+	}
+	if (!is_found)
+		return false;
+
+	m_queued_jobs_num.fetch_sub(1, std::memory_order_relaxed);
+	job.m_func();
+	// The group may be destroyed by its waiting thread right after this, so it is not touched afterwards.
+	job.m_group_ptr->m_pending_num.fetch_sub(1, std::memory_order_release);
+	return true;
+}
+
+void JobSystem::worker_loop(unsigned int queue_idx)
+{
+	t_owner_job_system_ptr = this;
+	t_queue_idx = queue_idx;
+	while (true)
+	{
+		if (this->try_run_job(queue_idx))
+			continue;
+
+		std::unique_lock<std::mutex> lock(m_wake_mutex);
+		m_wake_cv.wait(lock, [this]()
+		{
+			return m_is_stopping || m_queued_jobs_num.load(std::memory_order_acquire) > 0;
+		});
+		// Finish all queued jobs before stopping.
+		if (m_is_stopping && m_queued_jobs_num.load(std::memory_order_acquire) == 0)
+			return;
+	}
+}
+
+std::size_t TaskGraph::add_task(std::function<void()> task_func, const std::vector<std::size_t>& dependency_idx_vec)
+{
+	const std::size_t task_idx = m_tasks_vec.size();
+	Task task;
+	task.m_func = std::move(task_func);
+	for (const auto dependency_idx : dependency_idx_vec)
+	{
+		// Ignore invalid dependencies, which can only be the task itself or tasks added after it.
+		if (dependency_idx >= task_idx)
+			continue;
+		m_tasks_vec[dependency_idx].m_successor_idx_vec.push_back(task_idx);
+		++task.m_dependencies_num;
+	}
+	m_tasks_vec.push_back(std::move(task));
+	return task_idx;
+}
+
+void TaskGraph::run(JobSystem& job_system)
+{
+	// Amount of unfinished dependencies of each task, the task is queued once it reaches zero.
+	std::unique_ptr<std::atomic<std::size_t>[]> remaining_num_arr(new std::atomic<std::size_t>[m_tasks_vec.size()]);
+	for (std::size_t i = 0; i < m_tasks_vec.size(); ++i)
+		remaining_num_arr[i].store(m_tasks_vec[i].m_dependencies_num, std::memory_order_relaxed);
+
+	JobGroup group;
+	std::function<void(std::size_t)> submit_task;
+	submit_task = [&](std::size_t task_idx)
+	{
+		job_system.submit([&, task_idx]()
+		{
+			m_tasks_vec[task_idx].m_func();
+			for (const auto successor_idx : m_tasks_vec[task_idx].m_successor_idx_vec)
+				if (remaining_num_arr[successor_idx].fetch_sub(1, std::memory_order_acq_rel) == 1)
+					submit_task(successor_idx);
+		}, group);
+	};
+
+	for (std::size_t i = 0; i < m_tasks_vec.size(); ++i)
+		if (m_tasks_vec[i].m_dependencies_num == 0)
+			submit_task(i);
+	// Successors are submitted before their finished dependency leaves the group, so the group never empties early.
+	job_system.wait(group);
+}
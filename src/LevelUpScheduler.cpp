@@ -0,0 +1,75 @@
+#include "LevelUpScheduler.hpp"
+#include "TileRandom.hpp"
+
+void LevelUpScheduler::reset(std::size_t tiles_num)
+{
+	m_events_queue = decltype(m_events_queue)();
+	m_due_day_vec.assign(tiles_num, LEVEL_UP_NO_EVENT_DAY);
+}
+
+bool LevelUpScheduler::refresh_tile(int tile_index, const Tile& tile, unsigned int day, unsigned int seed)
+{
+	unsigned int& due_day = m_due_day_vec[tile_index];
+	// A tile which is no longer ready keeps its level.
+	if (!tile.is_level_up_ready())
+	{
+		due_day = LEVEL_UP_NO_EVENT_DAY;
+		return false;
+	}
+	// A ready tile keeps its level-up day, which is still the first successful day from today on.
+	if (due_day != LEVEL_UP_NO_EVENT_DAY || tile.get_level_up_chance() == 0)
+		return false;
+
+	/* Find the first successful day from today on, each day being one trial as the daily dice roll was. The waiting
+	 * time is geometric, about RAND_BASE_NUM / chance days. */
+	for (unsigned int each_day = day; each_day - day < LEVEL_UP_MAX_SCHEDULED_DAYS; ++each_day)
+		if (is_level_up_day(tile_index, tile, each_day, seed))
+		{
+			due_day = each_day;
+			return true;
+		}
+	return false;
+}
+
+void LevelUpScheduler::cancel_tile(int tile_index)
+{
+	m_due_day_vec[tile_index] = LEVEL_UP_NO_EVENT_DAY;
+}
+
+void LevelUpScheduler::push_events(const std::vector<int>& tile_idx_vec)
+{
+	for (const auto tile_index : tile_idx_vec)
+		if (m_due_day_vec[tile_index] != LEVEL_UP_NO_EVENT_DAY)
+			m_events_queue.push(LevelUpEvent{ m_due_day_vec[tile_index], tile_index });
+}
+
+std::size_t LevelUpScheduler::fire_due_events(unsigned int day, std::vector<Tile>& tiles_vec,
+	std::vector<int>& fired_idx_vec)
+{
+	std::size_t level_ups_num{0};
+	while (!m_events_queue.empty() && m_events_queue.top().m_day <= day)
+	{
+		const LevelUpEvent event = m_events_queue.top();
+		m_events_queue.pop();
+		// Skip cancelled events, and events which were cancelled and then scheduled again for another day.
+		if (m_due_day_vec[event.m_tile_index] != event.m_day)
+			continue;
+		m_due_day_vec[event.m_tile_index] = LEVEL_UP_NO_EVENT_DAY;
+		++tiles_vec[event.m_tile_index].m_level;
+		fired_idx_vec.push_back(event.m_tile_index);
+		++level_ups_num;
+	}
+	return level_ups_num;
+}
+
+std::size_t LevelUpScheduler::get_events_num() const
+{
+	return m_events_queue.size();
+}
+
+bool LevelUpScheduler::is_level_up_day(int tile_index, const Tile& tile, unsigned int day, unsigned int seed)
+{
+	// Each level has its own stream, so a tile's chances after leveling up are independent of those before.
+	return get_tile_random(seed, tile_index, day, TILE_RANDOM_LEVEL_UP_STREAM + tile.m_level) % RAND_BASE_NUM <
+		tile.get_level_up_chance();
+}
@@ -2,8 +2,12 @@
 #include "MainGameState.hpp"
 #include "Utility.hpp"
 #include "City.hpp"
+#include "AutoSaver.hpp"
+#include "CitySnapshot.hpp"
+#include "Profiler.hpp"
 
-MainGameState::MainGameState(const std::shared_ptr<Game>& game_ptr) : m_action_state(GameActionEnum::NONE)
+MainGameState::MainGameState(const std::shared_ptr<Game>& game_ptr, std::shared_ptr<City> city_ptr,
+	const SaveSlot& slot) : m_action_state(GameActionEnum::NONE), m_game_city_ptr(std::move(city_ptr)), m_slot(slot)
 {
 	// Store the game pointer.
 	this->set_game_ptr(game_ptr);
@@ -15,16 +19,38 @@ MainGameState::MainGameState(const std::shared_ptr<Game>& game_ptr) : m_action_s
 	m_view.setCenter(game_view_size * 0.5f);
 	m_gui_view.setCenter(game_view_size * 0.5f);
 
-	// Create and store a 64x64 game city.
-	m_game_city_ptr = std::make_shared<City>(City(CITY_NAME_STR,
-		game_ptr->m_tile_half_width_pixel,game_ptr->m_str_tile_map));
-	// Shuffle the city to allow update in random order later.
-	m_game_city_ptr->shuffleTiles();
+	/* A replayed city is loaded without journaling and never saved, so replaying does not change the player's save
+	 * files. */
+	if (!game_ptr->m_replay_trace_path.empty())
+	{
+		// Replay the trace from its recorded city and as fast as possible.
+		m_trace_player_ptr = std::make_shared<TracePlayer>(game_ptr->m_replay_trace_path);
+		if (!m_trace_player_ptr->is_valid() ||
+			!m_trace_player_ptr->restore_start(*m_game_city_ptr, this->get_game_ptr()->m_str_tile_map))
+		{
+			// Replaying from any other state is meaningless, so close the game window instead.
+			this->get_game_ptr()->m_is_replay_failed = true;
+			this->get_game_ptr()->m_game_window.close();
+		}
+		this->get_game_ptr()->m_game_window.setFramerateLimit(0);
+	}
+	else
+	{
+		// Save the city in background every AUTOSAVE_INTERVAL_DAYS game days.
+		m_autosaver_ptr = std::make_shared<AutoSaver>(m_slot, AUTOSAVE_INTERVAL_DAYS);
+		// Record player's input from the loaded city if required.
+		if (!game_ptr->m_record_trace_path.empty())
+		{
+			CitySnapshot start_snapshot;
+			m_game_city_ptr->take_snapshot(start_snapshot);
+			m_trace_recorder_ptr = std::make_shared<TraceRecorder>(game_ptr->m_record_trace_path, start_snapshot);
+		}
+	}
 
 	/* Create and store right click menu Gui object. Display when the player presses the right mouse button.
 	 * All possible tiles that can be placed will be shown. After player choose one, that will also be the current
 	 * selected tile.*/
-	m_str_gui_map.emplace(MENU_GUI_STR, Gui(sf::Vector2f(MENU_GUI_ENTRY_SHAPE_WIDTH,
+	m_menu_gui_ptr = std::make_shared<Gui>(Gui(sf::Vector2f(MENU_GUI_ENTRY_SHAPE_WIDTH,
 		MENU_GUI_ENTRY_SHAPE_HEIGHT),MENU_GUI_TEXT_PADDING, false,
 			(*this->get_game_ptr()->getGuiStylePtr(BUTTON_NAME)),
 			{
@@ -39,14 +65,14 @@ MainGameState::MainGameState(const std::shared_ptr<Game>& game_ptr) : m_action_s
 
 	/* Create and store select cost text Gui object. Display the player-selected tiles' total cost.
 	 * The color will be red if player does not have enough fund.*/
-	m_str_gui_map.emplace(SELECT_TILE_COST_TEXT_GUI_STR, Gui(sf::Vector2f(
+	m_select_cost_text_gui_ptr = std::make_shared<Gui>(Gui(sf::Vector2f(
 		SELECT_TILE_COST_TEXT_GUI_ENTRY_SHAPE_WIDTH, SELECT_TILE_COST_TEXT_GUI_ENTRY_SHAPE_HEIGHT), 0,
 			false, (*this->get_game_ptr()->getGuiStylePtr(TEXT_NAME)),
 			{std::make_pair("", "")}));
 
 	/* Create and store the information bar Gui object. Located at the bottom of the screen, display the in-game days
 	 * and other useful information for the player. */
-	m_str_gui_map.emplace(INFO_BAR_GUI_STR, Gui(sf::Vector2f(INFO_BAR_GUI_ENTRY_SHAPE_WIDTH,
+	m_info_bar_gui_ptr = std::make_shared<Gui>(Gui(sf::Vector2f(INFO_BAR_GUI_ENTRY_SHAPE_WIDTH,
 		INFO_BAR_GUI_ENTRY_SHAPE_HEIGHT), INFO_BAR_GUI_TEXT_PADDING, true,
 			(*this->get_game_ptr()->getGuiStylePtr(BUTTON_NAME)),
 			{
@@ -57,6 +83,9 @@ MainGameState::MainGameState(const std::shared_ptr<Game>& game_ptr) : m_action_s
 				std::make_pair(CURR_TILE_GUI_ENTRY_STR, CURR_TILE_GUI_ENTRY_MSG)
 			}));
 
+	// Draw the information bar first, so the select cost text and the right click menu are drawn above it.
+	m_gui_ptr_vec = {m_info_bar_gui_ptr, m_select_cost_text_gui_ptr, m_menu_gui_ptr};
+
 	// Center the camera on the isometric map.
 	sf::Vector2f camera_center(m_game_city_ptr->get_map_ptr()->get_width(), m_game_city_ptr->get_map_ptr()->
 	get_height() * 0.5);
@@ -64,47 +93,12 @@ MainGameState::MainGameState(const std::shared_ptr<Game>& game_ptr) : m_action_s
 	m_view.setCenter(camera_center);
 
 	// Initialize current selected tile as a Grass tile.
-	m_curr_selected_tile_ptr = std::make_shared<Tile>(this->get_game_ptr()->m_str_tile_map.at
-		(GRASS_TILE_TEXTURE_NAME));
-}
-
-std::string tileTypeToStr(TileTypeEnum tile_type)
-{
-	// A string store the result.
-	std::string res_str{};
-	// Check each case, for unlisted input, use Void to represent.
-	switch (tile_type)
-	{
-	case TileTypeEnum::INDUSTRIAL:
-		res_str = INDUSTRIAL_TILE_TEXTURE_NAME;
-		break;
-	case TileTypeEnum::COMMERCIAL:
-		res_str = COMMERCIAL_TILE_TEXTURE_NAME;
-		break;
-	case TileTypeEnum::RESIDENTIAL:
-		res_str = RESIDENTIAL_TILE_TEXTURE_NAME;
-		break;
-	case TileTypeEnum::GRASS:
-		res_str = GRASS_TILE_TEXTURE_NAME;
-		break;
-	case TileTypeEnum::FOREST:
-		res_str = FOREST_TILE_TEXTURE_NAME;
-		break;
-	case TileTypeEnum::WATER:
-		res_str = WATER_TILE_TEXTURE_NAME;
-		break;
-	case TileTypeEnum::ROAD:
-		res_str = ROAD_TILE_TEXTURE_NAME;
-		break;
-	default:
-		res_str = VOID_TILE_TEXTURE_NAME;
-		break;
-	}
-	return res_str;
+	this->set_curr_selected_tile(GRASS_TILE_TEXTURE_NAME);
 }
 
 void MainGameState::render(const float dt)
 {
+	PROFILE_SCOPE("MainGameState::render");
 	// Clear previous content and draw the background in the gui view.
 	this->get_game_ptr()->m_game_window.clear(sf::Color::Black);
 	this->get_game_ptr()->m_game_window.setView(m_gui_view);
@@ -112,51 +106,179 @@ void MainGameState::render(const float dt)
 
 	// Draw the game map within the main game view.
 	this->get_game_ptr()->m_game_window.setView(m_view);
-	m_game_city_ptr->get_map_ptr()->render(this->get_game_ptr()->m_game_window, dt);
+	this->get_game_ptr()->m_map_renderer.render(this->get_game_ptr()->m_game_window, *m_game_city_ptr->get_map_ptr(),
+		dt);
 
-	// Then draw each Gui object within the gui game view.
+	/* Then draw each Gui object within the gui game view. Hidden ones are skipped, and each visible one draws its cached
+	 * shapes and texts with two draw calls. */
 	this->get_game_ptr()->m_game_window.setView(m_gui_view);
-	for (const auto& pair : m_str_gui_map)
-		this->get_game_ptr()->m_game_window.draw(pair.second);
+	for (const auto& each_gui_ptr : m_gui_ptr_vec)
+		this->get_game_ptr()->m_game_window.draw(*each_gui_ptr);
 }
 
 void MainGameState::update(const float dt)
 {
-	// Update the whole game city.
-	m_game_city_ptr->update(dt);
-
-	// Set up information bar Gui's all 5 GuiEntry objects' texts(displayed at the bottom of the screen).
-	m_str_gui_map.at(INFO_BAR_GUI_STR).set_gui_entry_text(0, "Day: " +
-	std::to_string(m_game_city_ptr->get_day()));
-	m_str_gui_map.at(INFO_BAR_GUI_STR).set_gui_entry_text(1, "Fund: $" +
-	std::to_string(m_game_city_ptr->get_fund()));
-	m_str_gui_map.at(INFO_BAR_GUI_STR).set_gui_entry_text(2, "Population:" +
-		std::to_string(m_game_city_ptr->get_population()) + "(Homeless:" +
-		std::to_string(m_game_city_ptr->getHomelessNum()) + ")");
-	m_str_gui_map.at(INFO_BAR_GUI_STR).set_gui_entry_text(3, "(Employee:"+
-	std::to_string(m_game_city_ptr->get_employable()) + "(Unemployed:" +
-		std::to_string(m_game_city_ptr->getUnemployedNum()) + ")");
-	m_str_gui_map.at(INFO_BAR_GUI_STR).set_gui_entry_text(4, "Selected Tile:" +
+	PROFILE_SCOPE("MainGameState::update");
+	if (m_trace_player_ptr)
+		this->replay_frame();
+	else
+	{
+		// Record the frame after all of its input.
+		if (m_trace_recorder_ptr)
+			m_trace_recorder_ptr->record_frame(dt);
+		// Update the whole game city.
+		m_game_city_ptr->update(dt);
+		// Autosave the city if enough game days have elapsed.
+		m_autosaver_ptr->update(*m_game_city_ptr);
+	}
+
+	/* Bind information bar Gui's first 4 GuiEntry objects' texts to the city's stats(displayed at the bottom of the
+	 * screen), each text is only formatted again when its stats change. The selected tile GuiEntry object is updated
+	 * whenever the selected tile changes. */
+	m_info_bar_gui_ptr->set_gui_entry_values(0, DAY_GUI_ENTRY_FORMAT,
+		{ static_cast<double>(m_game_city_ptr->get_day()) });
+	m_info_bar_gui_ptr->set_gui_entry_values(1, FUND_GUI_ENTRY_FORMAT, { m_game_city_ptr->get_fund() });
+	m_info_bar_gui_ptr->set_gui_entry_values(2, POPULATION_GUI_ENTRY_FORMAT, { m_game_city_ptr->get_population(),
+		m_game_city_ptr->getHomelessNum() });
+	m_info_bar_gui_ptr->set_gui_entry_values(3, EMPLOYMENT_GUI_ENTRY_FORMAT, { m_game_city_ptr->get_employable(),
+		m_game_city_ptr->getUnemployedNum() });
+}
+
+void MainGameState::replay_frame()
+{
+	// Nothing is replayed if the trace could not be replayed from its recorded city.
+	if (this->get_game_ptr()->m_is_replay_failed)
+		return;
+	// Close the game window once the whole trace has been replayed.
+	m_view_records_vec.clear();
+	if (!m_trace_player_ptr->play_frame(*m_game_city_ptr, this->get_game_ptr()->m_str_tile_map, &m_view_records_vec))
+	{
+		CitySnapshot snapshot;
+		m_game_city_ptr->take_snapshot(snapshot);
+		std::cout << "Replayed " << m_trace_player_ptr->get_frames_num() << " frames, day " <<
+		m_game_city_ptr->get_day() << ", state hash " << std::hex << snapshot.get_hash() << std::dec << '\n';
+		this->get_game_ptr()->m_game_window.close();
+		return;
+	}
+
+	// Move the camera in the same way as it was moved when recorded.
+	for (const auto& record : m_view_records_vec)
+	{
+		if (record.m_type == TraceRecordEnum::ZOOM)
+		{
+			m_view.zoom(record.m_zoom_factor);
+			m_zoom_level *= record.m_zoom_factor;
+		}
+		else if (record.m_type == TraceRecordEnum::PAN)
+			m_view.move(record.m_pan_offset);
+	}
+
+	// Show the replayed tile type inside the information bar.
+	if (m_curr_selected_tile_ptr->m_tileType != m_trace_player_ptr->get_tile_type())
+		this->set_curr_selected_tile(tileTypeToStr(m_trace_player_ptr->get_tile_type()));
+}
+
+void MainGameState::set_curr_selected_tile(const std::string& tile_name)
+{
+	m_curr_selected_tile_ptr = std::make_shared<Tile>(this->get_game_ptr()->m_str_tile_map.at(tile_name));
+	m_info_bar_gui_ptr->set_gui_entry_text(4, CURR_TILE_GUI_ENTRY_PREFIX +
 		tileTypeToStr(m_curr_selected_tile_ptr->m_tileType));
+}
+
+void MainGameState::apply_mouse_move(const sf::Vector2i& mouse_screen_pos)
+{
+	// Pan the camera when player keep pressing the mouse middle button.
+	if (m_action_state == GameActionEnum::CAMERA_PANNING)
+	{
+		sf::Vector2f pos(sf::Vector2f(mouse_screen_pos - m_prev_mouse_pos));
+		/* Main game view should move towards the opposite direction according to the zoom level since moving a camera
+		 * to the right is the same as moving everything else to the left. */
+		m_view.move(-1.f * pos * m_zoom_level);
+		if (m_trace_recorder_ptr)
+			m_trace_recorder_ptr->record_pan(-1.f * pos * m_zoom_level);
+		// Update mouse position.
+		m_prev_mouse_pos = mouse_screen_pos;
+	}
+	// Select a rectangle of tile objects when player keep pressing the mouse left button.
+	else if (m_action_state == GameActionEnum::TILE_SELECTING)
+	{
+		// Convert and store mouse's screen position to world position.
+		sf::Vector2f mouse_pos(this->get_game_ptr()->m_game_window.mapPixelToCoords(mouse_screen_pos, m_view));
+		/* Inverse of algebra formula inside MapRenderer::render function(change world coordinate to tile coordinate).
+		 * Additional 0.5 is a compensation offset for integer truncation. */
+		m_select_end_pos.x = (mouse_pos.y / m_game_city_ptr->get_map_ptr()->get_tile_half_width()) +
+			(mouse_pos.x / (2 * m_game_city_ptr->get_map_ptr()->get_tile_half_width())) -
+			(0.5 * m_game_city_ptr->get_map_ptr()->get_width()) - INT_TRUNCATION_OFFSET;
+		m_select_end_pos.y = (mouse_pos.y / m_game_city_ptr->get_map_ptr()->get_tile_half_width()) -
+			(mouse_pos.x / (2 * m_game_city_ptr->get_map_ptr()->get_tile_half_width())) +
+			(0.5 * m_game_city_ptr->get_map_ptr()->get_width()) + INT_TRUNCATION_OFFSET;
+
+		// Record the selected rectangle before it is sorted and clamped.
+		if (m_trace_recorder_ptr)
+			m_trace_recorder_ptr->record_select(m_select_start_pos, m_select_end_pos);
 
-	// Highlight the mouse hovered GuiEntry object within right click menu Gui.
-	m_str_gui_map.at(MENU_GUI_STR).highlight_entry(m_str_gui_map.at(MENU_GUI_STR).
-	get_gui_entry_idx(this->get_game_ptr()->m_game_window.mapPixelToCoords
-	(sf::Mouse::getPosition(this->get_game_ptr()->m_game_window), m_gui_view)));
+		// Replace the selection with all tiles which can be replaced by current selected tile.
+		m_game_city_ptr->select(m_select_start_pos, m_select_end_pos, m_curr_selected_tile_ptr->m_tileType);
+
+		// Set up select text cost Gui object's contents, which are counted without visiting the selected tiles.
+		unsigned int selected_tiles_total_cost(m_game_city_ptr->get_selection_cost(*m_curr_selected_tile_ptr));
+		m_select_cost_text_gui_ptr->set_gui_entry_text(0, "$" + std::to_string(selected_tiles_total_cost));
+
+		//  If the city does not have enough funds, then highlights the text content with red color.
+		if (m_game_city_ptr->get_fund() < selected_tiles_total_cost)
+			m_select_cost_text_gui_ptr->highlight_entry(0);
+		else
+			m_select_cost_text_gui_ptr->highlight_entry(-1);
+
+		// Place and display the text to the bottom right of the mouse cursor.
+		m_select_cost_text_gui_ptr->setPosition(this->get_game_ptr()->m_game_window.mapPixelToCoords(
+			mouse_screen_pos, m_gui_view) + sf::Vector2f(SELECT_TILE_COST_TEXT_GUI_X_OFFSET,
+			SELECT_TILE_COST_TEXT_GUI_Y_OFFSET));
+		m_select_cost_text_gui_ptr->show();
+	}
+
+	// If player's mouse hover on any of GuiEntries of right click menu, then highlight it.
+	m_menu_gui_ptr->highlight_hovered_entry(this->get_game_ptr()->m_game_window.mapPixelToCoords(mouse_screen_pos,
+		m_gui_view));
 }
 
 void MainGameState::inputProcess()
 {
+	PROFILE_SCOPE("MainGameState::inputProcess");
 	// Store mouse positions within main game view and gui view separately.
 	sf::Vector2f mouse_pos_in_game_view(this->get_game_ptr()->m_game_window.mapPixelToCoords(
 		sf::Mouse::getPosition(this->get_game_ptr()->m_game_window), m_view));
 	sf::Vector2f mouse_pos_in_gui_view(this->get_game_ptr()->m_game_window.mapPixelToCoords(
 		sf::Mouse::getPosition(this->get_game_ptr()->m_game_window), m_gui_view));
 
+	/* High rate mice deliver many mouse moved events per frame. Only the last mouse position before any other event,
+	 * or before the end of the frame, is applied. */
+	bool is_mouse_moved{false};
+	sf::Vector2i mouse_move_pos(0, 0);
+
 	sf::Event event{};
 	// Check if there is a pending sf::Event object.
 	while (this->get_game_ptr()->m_game_window.pollEvent(event))
 	{
+		// Player's mouse input is ignored while replaying a trace.
+		if (m_trace_player_ptr && (event.type == sf::Event::MouseMoved || event.type ==
+			sf::Event::MouseButtonPressed || event.type == sf::Event::MouseButtonReleased || event.type ==
+			sf::Event::MouseWheelScrolled))
+			continue;
+
+		// Defer the mouse move, other events see the mouse moves before them applied.
+		if (event.type == sf::Event::MouseMoved)
+		{
+			is_mouse_moved = true;
+			mouse_move_pos = sf::Vector2i(event.mouseMove.x, event.mouseMove.y);
+			continue;
+		}
+		if (is_mouse_moved)
+		{
+			this->apply_mouse_move(mouse_move_pos);
+			is_mouse_moved = false;
+		}
+
 		// Check the event type.
 		switch (event.type)
 		{
@@ -164,7 +286,12 @@ void MainGameState::inputProcess()
 		case sf::Event::Closed:
 		{
 			this->get_game_ptr()->m_game_window.close();
-			m_game_city_ptr->save(CITY_NAME_STR);
+			// A replayed city is never saved.
+			if (!m_autosaver_ptr)
+				break;
+			// Wait for the pending autosave so that it does not overwrite the final save.
+			m_autosaver_ptr->wait();
+			m_game_city_ptr->save(m_slot);
 			break;
 		}
 		// If user resize the window size.
@@ -177,13 +304,13 @@ void MainGameState::inputProcess()
 			m_view.zoom(m_zoom_level);
 
 			// Set information bar Gui object's dimension and position.
-			m_str_gui_map.at(INFO_BAR_GUI_STR).set_each_gui_entry_dimension(sf::Vector2f(
-				event.size.width / m_str_gui_map.at(INFO_BAR_GUI_STR).get_entry_size(),
+			m_info_bar_gui_ptr->set_each_gui_entry_dimension(sf::Vector2f(
+				event.size.width / m_info_bar_gui_ptr->get_entry_size(),
 				INFO_BAR_GUI_ENTRY_SHAPE_HEIGHT));
-			m_str_gui_map.at(INFO_BAR_GUI_STR).setPosition(this->get_game_ptr()->m_game_window.mapPixelToCoords
+			m_info_bar_gui_ptr->setPosition(this->get_game_ptr()->m_game_window.mapPixelToCoords
 			(sf::Vector2i(0, event.size.height - INFO_BAR_GUI_ENTRY_SHAPE_HEIGHT), m_gui_view));
 			// Display the updated information bar.
-			m_str_gui_map.at(INFO_BAR_GUI_STR).show();
+			m_info_bar_gui_ptr->show();
 
 			// Set background sprite's position to window position (0, 0) related world position inside GUI view.
 			this->get_game_ptr()->m_background_sprite.setPosition(this->get_game_ptr()->
@@ -202,75 +329,9 @@ void MainGameState::inputProcess()
 			// If user pressed escape key, then close the game window.
 			if (event.key.code == sf::Keyboard::Escape)
 				this->get_game_ptr()->m_game_window.close();
-			break;
-		}
-		// Mouse moved condition.
-		case sf::Event::MouseMoved:
-		{
-			// Pan the camera when player keep pressing the mouse middle button.
-			if (m_action_state == GameActionEnum::CAMERA_PANNING)
-			{
-				sf::Vector2f pos(sf::Vector2f(sf::Mouse::getPosition(this->get_game_ptr()
-				->m_game_window) - m_prev_mouse_pos));
-				/* Main game view should move towards the opposite direction according to the zoom level since moving
-				 * a camera to the right is the same as moving everything else to the left. */
-				m_view.move(-1.f * pos * m_zoom_level);
-				// Update mouse position.
-				m_prev_mouse_pos = sf::Mouse::getPosition(this->get_game_ptr()->m_game_window);
-			}
-			// Select a rectangle of tile objects when player keep pressing the mouse left button.
-			else if (m_action_state == GameActionEnum::TILE_SELECTING)
-			{
-				// Convert and store mouse's screen position to world position.
-				sf::Vector2f mouse_pos(this->get_game_ptr()->m_game_window.mapPixelToCoords(sf::Mouse::getPosition
-					(this->get_game_ptr()->m_game_window), m_view));
-				/* Inverse of algebra formula inside Map::render function(change world coordinate to tile coordinate).
-				 * Additional 0.5 is a compensation offset for integer truncation. */
-				m_select_end_pos.x = (mouse_pos.y / m_game_city_ptr->get_map_ptr()->get_tile_half_width()) +
-					(mouse_pos.x / (2 * m_game_city_ptr->get_map_ptr()->get_tile_half_width())) -
-					(0.5 * m_game_city_ptr->get_map_ptr()->get_width()) - INT_TRUNCATION_OFFSET;
-				m_select_end_pos.y = (mouse_pos.y / m_game_city_ptr->get_map_ptr()->get_tile_half_width()) -
-					(mouse_pos.x / (2 * m_game_city_ptr->get_map_ptr()->get_tile_half_width())) +
-					(0.5 * m_game_city_ptr->get_map_ptr()->get_width()) + INT_TRUNCATION_OFFSET;
-
-				// Deselected all tiles first.
-				m_game_city_ptr->get_map_ptr()->deselect_tiles();
-
-				/* If m_curr_selected_tile_ptr is pointed to a grass tile, then current player action is considered to
-				 * destroy all exist tiles rather than grass tiles. Therefore, grass tiles are considered as black list
-				 * and all other tiles should be selected. */
-				if (m_curr_selected_tile_ptr->m_tileType == TileTypeEnum::GRASS)
-					m_game_city_ptr->get_map_ptr()->select(m_select_start_pos, m_select_end_pos,
-						{ TileTypeEnum::GRASS});
-				/* Else current player action is considered to build related new tile. And new tile can only be built on
-				 * the grass tiles. Therefore, all other 7 type of tiles are considered as black list. */
-				else
-					m_game_city_ptr->get_map_ptr()->select(m_select_start_pos, m_select_end_pos,
-						{ TileTypeEnum::VOID, TileTypeEnum::WATER, TileTypeEnum::ROAD,
-						  TileTypeEnum::FOREST, TileTypeEnum::RESIDENTIAL, TileTypeEnum::COMMERCIAL,
-						  TileTypeEnum::INDUSTRIAL});
-
-				// Set up select text cost Gui object's contents.
-				unsigned int selected_tiles_total_cost(m_curr_selected_tile_ptr->getCost() * m_game_city_ptr->
-				get_map_ptr()->get_selected_tiles_num());
-				m_str_gui_map.at(SELECT_TILE_COST_TEXT_GUI_STR).set_gui_entry_text(0, "$" +
-				std::to_string(selected_tiles_total_cost));
-
-				//  If the city does not have enough funds, then highlights the text content with red color.
-				if (m_game_city_ptr->get_fund() < selected_tiles_total_cost)
-					m_str_gui_map.at(SELECT_TILE_COST_TEXT_GUI_STR).highlight_entry(0);
-				else
-					m_str_gui_map.at(SELECT_TILE_COST_TEXT_GUI_STR).highlight_entry(-1);
-
-				// Place and display the text to the bottom right of the mouse cursor.
-				m_str_gui_map.at(SELECT_TILE_COST_TEXT_GUI_STR).setPosition(mouse_pos_in_gui_view +
-				sf::Vector2f(SELECT_TILE_COST_TEXT_GUI_X_OFFSET, SELECT_TILE_COST_TEXT_GUI_Y_OFFSET));
-				m_str_gui_map.at(SELECT_TILE_COST_TEXT_GUI_STR).show();
-			}
-
-			// If player's mouse hover on any of GuiEntries of right click menu, then highlight it.
-			m_str_gui_map.at(MENU_GUI_STR).highlight_entry(m_str_gui_map.at(MENU_GUI_STR).
-			get_gui_entry_idx(mouse_pos_in_gui_view));
+			// Dump the profiling events recorded so far if profiling is compiled in.
+			else if (event.key.code == sf::Keyboard::F12)
+				PROFILE_DUMP(PROFILE_TRACE_PATH);
 			break;
 		}
 		// Check mouse button pressed cases.
@@ -280,8 +341,8 @@ void MainGameState::inputProcess()
 			if (event.mouseButton.button == sf::Mouse::Middle)
 			{
 				// Hide right click menu and selection cost text.
-				m_str_gui_map.at(MENU_GUI_STR).hide();
-				m_str_gui_map.at(SELECT_TILE_COST_TEXT_GUI_STR).hide();
+				m_menu_gui_ptr->hide();
+				m_select_cost_text_gui_ptr->hide();
 
 				// Switch to the camera panning state.
 				if (m_action_state != GameActionEnum::CAMERA_PANNING)
@@ -295,19 +356,22 @@ void MainGameState::inputProcess()
 			else if (event.mouseButton.button == sf::Mouse::Left)
 			{
 				// If right click menu is visible, then try to select the tile which player's mouse hovers on.
-				if (m_str_gui_map.at(MENU_GUI_STR).get_visible())
+				if (m_menu_gui_ptr->get_visible())
 				{
 					// Try to get activated message from player mouse clicked Gui Entry object if valid.
-					std::string activated_msg = m_str_gui_map.at(MENU_GUI_STR).
+					std::string activated_msg = m_menu_gui_ptr->
 						get_mouse_pos_entry_msg(mouse_pos_in_gui_view);
 					/* If there is one valid Gui Entry object been clicked, then store related tile object as current
 					 * selected tile.*/
 					if (activated_msg != "NULL")
-						m_curr_selected_tile_ptr = std::make_shared<Tile>(this->get_game_ptr()->m_str_tile_map.
-							at(activated_msg));
+					{
+						this->set_curr_selected_tile(activated_msg);
+						if (m_trace_recorder_ptr)
+							m_trace_recorder_ptr->record_tile(m_curr_selected_tile_ptr->m_tileType);
+					}
 
 					// Hide the right click menu.
-					m_str_gui_map.at(MENU_GUI_STR).hide();
+					m_menu_gui_ptr->hide();
 				}
 				else
 				{
@@ -315,7 +379,7 @@ void MainGameState::inputProcess()
 					if (m_action_state != GameActionEnum::TILE_SELECTING)
 					{
 						m_action_state = GameActionEnum::TILE_SELECTING;
-						/* Inverse of algebra formula inside Map::render function(change world coordinate to tile
+						/* Inverse of algebra formula inside MapRenderer::render function(change world coordinate to tile
 						 * coordinate). Additional 0.5 is a compensation offset for integer truncation. */
 						m_select_start_pos.x = (mouse_pos_in_game_view.y / m_game_city_ptr->get_map_ptr()->
 							get_tile_half_width()) + (mouse_pos_in_game_view.x / (2 * m_game_city_ptr->get_map_ptr()
@@ -336,9 +400,11 @@ void MainGameState::inputProcess()
 					// Switch to the none state.
 					m_action_state = GameActionEnum::NONE;
 					// Hide the Gui which shows selected tiles overall cost.
-					m_str_gui_map.at(SELECT_TILE_COST_TEXT_GUI_STR).hide();
+					m_select_cost_text_gui_ptr->hide();
 					// De-select all exist tiles.
 					m_game_city_ptr->get_map_ptr()->deselect_tiles();
+					if (m_trace_recorder_ptr)
+						m_trace_recorder_ptr->record_cancel();
 				}
 				// If not, then instead open the right click menu.
 				else
@@ -349,16 +415,17 @@ void MainGameState::inputProcess()
 					/* Ensure that right click menu Gui is displayed within the screen properly. If not enough space to
 					 * put right click menu on mouse position's right side, then put it  on the left side of mouse
 					 * position.*/
-					if (pos.x > (this->get_game_ptr()->m_game_window.getSize().x - m_str_gui_map.at(MENU_GUI_STR)
-					.get_gui_size().x))
-						pos -= sf::Vector2f(m_str_gui_map.at(MENU_GUI_STR).get_gui_size().x, 0);
-					if (pos.y > (this->get_game_ptr()->m_game_window.getSize().y - m_str_gui_map.at(MENU_GUI_STR)
-						.get_gui_size().y))
-						pos -= sf::Vector2f(0, m_str_gui_map.at(MENU_GUI_STR).get_gui_size().y);
-
-					// Then update right click menu's position and display it.
-					m_str_gui_map.at(MENU_GUI_STR).setPosition(pos);
-					m_str_gui_map.at(MENU_GUI_STR).show();
+					if (pos.x > (this->get_game_ptr()->m_game_window.getSize().x - m_menu_gui_ptr
+					->get_gui_size().x))
+						pos -= sf::Vector2f(m_menu_gui_ptr->get_gui_size().x, 0);
+					if (pos.y > (this->get_game_ptr()->m_game_window.getSize().y - m_menu_gui_ptr
+						->get_gui_size().y))
+						pos -= sf::Vector2f(0, m_menu_gui_ptr->get_gui_size().y);
+
+					// Then update right click menu's position, display it and highlight the entry under the mouse.
+					m_menu_gui_ptr->setPosition(pos);
+					m_menu_gui_ptr->show();
+					m_menu_gui_ptr->highlight_hovered_entry(mouse_pos_in_gui_view);
 				}
 			}
 			break;
@@ -377,23 +444,12 @@ void MainGameState::inputProcess()
 					// If we have enough funds and have a current selected tile, then replace all selected tiles.
 					if (m_curr_selected_tile_ptr != nullptr)
 					{
-						// Calculate overall cost.
-						unsigned int selected_tiles_cost(m_curr_selected_tile_ptr->getCost() * m_game_city_ptr->
-						get_map_ptr()->get_selected_tiles_num());
-						// Check if city's fund is enough or not.
-						if (m_game_city_ptr->get_fund() >= selected_tiles_cost)
-						{
-							// Replace all selected tiles.
-							m_game_city_ptr->bulldoze(*m_curr_selected_tile_ptr);
-							// Update city's fund.
-							m_game_city_ptr->set_fund(m_game_city_ptr->get_fund() - selected_tiles_cost);
-							// Update road tiles and re-calculate connected regions.
-							m_game_city_ptr->updateTiles();
-						}
-
+						if (m_trace_recorder_ptr)
+							m_trace_recorder_ptr->record_place();
+						m_game_city_ptr->place_selection(*m_curr_selected_tile_ptr);
 					}
 					// Hide select tile cost Gui.
-					m_str_gui_map.at(SELECT_TILE_COST_TEXT_GUI_STR).hide();
+					m_select_cost_text_gui_ptr->hide();
 					// Set game state to none and deselect all tiles.
 					m_action_state = GameActionEnum::NONE;
 					m_game_city_ptr->get_map_ptr()->deselect_tiles();
@@ -409,12 +465,16 @@ void MainGameState::inputProcess()
 			{
 				m_view.zoom(DOWNWARD_SCROLL_FACTOR);
 				m_zoom_level *= DOWNWARD_SCROLL_FACTOR;
+				if (m_trace_recorder_ptr)
+					m_trace_recorder_ptr->record_zoom(DOWNWARD_SCROLL_FACTOR);
 			}
 			// If mouse wheel move upward, halve the zoom level of game view(view smaller, object bigger).
 			else
 			{
 				m_view.zoom(UPWARD_SCROLL_FACTOR);
 				m_zoom_level *= UPWARD_SCROLL_FACTOR;
+				if (m_trace_recorder_ptr)
+					m_trace_recorder_ptr->record_zoom(UPWARD_SCROLL_FACTOR);
 			}
 			break;
 		}
@@ -422,4 +482,8 @@ void MainGameState::inputProcess()
 			break;
 		}
 	}
-}
+
+	// Apply the last mouse move of the frame.
+	if (is_mouse_moved)
+		this->apply_mouse_move(mouse_move_pos);
+}
\ No newline at end of file
@@ -1,7 +1,8 @@
 #include "MainMenuGameState.hpp"
 #include "MainGameState.hpp"
+#include "City.hpp"
 #include "Gui.hpp"
-#include "Utility.hpp"
+#include "RenderUtility.hpp"
 
 MainMenuGameState::MainMenuGameState(std::shared_ptr<Game> game_ptr)
 {
@@ -15,18 +16,55 @@ MainMenuGameState::MainMenuGameState(std::shared_ptr<Game> game_ptr)
 	sf::Vector2f half_main_menu_view_size(main_menu_view_size/2.f);
 	m_view.setCenter(half_main_menu_view_size);
 
+	// List each used save slot by its header only, followed by a new city entry if there is still a free slot.
+	SaveSlot::read_all_headers(m_slot_headers_vec);
+	std::vector<std::pair<std::string, std::string>> entries_text_msg_vec;
+	for (const auto& header : m_slot_headers_vec)
+	{
+		std::string entry_text(header.m_name);
+		if (header.m_has_summary)
+			entry_text += "  Day " + std::to_string(header.m_day) + "  Pop " + std::to_string(static_cast<long long>(
+				header.m_population)) + "  $" + std::to_string(static_cast<long long>(header.m_fund)) + "  " +
+				std::to_string(header.m_width) + "x" + std::to_string(header.m_height);
+		entries_text_msg_vec.emplace_back(entry_text, LOAD_SLOT_GUI_ENTRY_MSG_PREFIX +
+			std::to_string(header.m_slot_idx));
+	}
+	if (SaveSlot::find_free_slot_idx() < SAVE_SLOTS_NUM)
+		entries_text_msg_vec.emplace_back(NEW_CITY_GUI_ENTRY_NAME, NEW_CITY_GUI_ENTRY_MSG);
+
 	// Create and store the new Gui object.
-	m_str_Gui_map.emplace(GUI_NAME, std::make_shared<Gui>(Gui(sf::Vector2f(GUI_ENTRY_WIDTH,
-		GUI_ENTRY_HEIGHT), GUI_TEXT_PADDING,
-		false, *(this->get_game_ptr()->getGuiStylePtr(BUTTON_GUI_STYLE_NAME)),
-		{std::make_pair(LOAD_GAME_GUI_ENTRY_NAME, LOAD_GAME_GUI_ENTRY_MSG)})));
+	m_str_Gui_map.emplace(GUI_NAME, std::make_shared<Gui>(Gui(sf::Vector2f(SLOT_GUI_ENTRY_WIDTH,
+		SLOT_GUI_ENTRY_HEIGHT), GUI_TEXT_PADDING,
+		false, *(this->get_game_ptr()->getGuiStylePtr(BUTTON_GUI_STYLE_NAME)), entries_text_msg_vec)));
 
 	// Set Gui at the center position of the view.
 	m_str_Gui_map.at(GUI_NAME)->setPosition(half_main_menu_view_size);
 	// Set Gui's origin to its center.
-	m_str_Gui_map.at(GUI_NAME)->setOrigin(GUI_ORIGIN_WIDTH, GUI_ORIGIN_HEIGHT);
+	m_str_Gui_map.at(GUI_NAME)->setOrigin(m_str_Gui_map.at(GUI_NAME)->get_gui_size() / 2.f);
 	// Mark the Gui visible and place all the entries in the correct location.
 	m_str_Gui_map.at(GUI_NAME)->show();
+
+	// Thumbnails are scaled up and shown at the right side of the save slot list.
+	m_thumbnail_sprite.setScale(SLOT_THUMBNAIL_SCALE, SLOT_THUMBNAIL_SCALE);
+
+	// Show the preloading progress below the save slot list.
+	m_str_Gui_map.emplace(PRELOAD_GUI_NAME, std::make_shared<Gui>(Gui(sf::Vector2f(SLOT_GUI_ENTRY_WIDTH,
+		SLOT_GUI_ENTRY_HEIGHT), GUI_TEXT_PADDING, false, *(this->get_game_ptr()->getGuiStylePtr(TEXT_NAME)),
+		{ std::make_pair(std::string(), PRELOAD_GUI_NAME) })));
+	m_str_Gui_map.at(PRELOAD_GUI_NAME)->setOrigin(m_str_Gui_map.at(GUI_NAME)->getOrigin() - sf::Vector2f(0.f,
+		m_str_Gui_map.at(GUI_NAME)->get_gui_size().y + PRELOAD_GUI_Y_OFFSET));
+	m_str_Gui_map.at(PRELOAD_GUI_NAME)->setPosition(half_main_menu_view_size);
+	m_str_Gui_map.at(PRELOAD_GUI_NAME)->show();
+
+	// Start loading the first listed city right away, it is most likely to be chosen.
+	this->preload_city(0);
+}
+
+MainMenuGameState::~MainMenuGameState()
+{
+	// The preload future blocks until its thread returns, so let it stop at its next loading step.
+	if (m_preload_cancel_ptr)
+		m_preload_cancel_ptr->store(true);
 }
 
 void MainMenuGameState::render(const float dt)
@@ -39,11 +77,28 @@ void MainMenuGameState::render(const float dt)
 	// Render each object.
 	for (const auto& gui : m_str_Gui_map)
 		this->get_game_ptr()->m_game_window.draw(*gui.second);
+	if (m_is_thumbnail_visible)
+		this->get_game_ptr()->m_game_window.draw(m_thumbnail_sprite);
 }
 
 void MainMenuGameState::update(const float dt)
 {
+	this->update_preload_progress();
+	// Release a cancelled preloaded city once its background thread has stopped.
+	if (m_preload_future.valid() && m_preload_cancel_ptr->load() &&
+		m_preload_future.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+		m_preload_future = std::future<std::shared_ptr<City>>();
 
+	// Switch to the main game once the background thread has loaded the chosen city.
+	if (!m_city_future.valid() || m_city_future.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+		return;
+	std::shared_ptr<City> city_ptr = m_city_future.get();
+	// The preloaded city is loaded without journaling, start journaling now if required.
+	if (m_is_preloaded_city && this->get_game_ptr()->m_replay_trace_path.empty())
+		city_ptr->start_journaling(m_loading_slot);
+	m_is_preloaded_city = false;
+	this->get_game_ptr()->push_state(std::make_unique<MainGameState>(this->get_game_ptr(), city_ptr,
+		m_loading_slot));
 }
 
 void MainMenuGameState::inputProcess()
@@ -83,8 +138,9 @@ void MainMenuGameState::inputProcess()
 			// Transfer from screen position to world position.
 			new_half_view_pos = this->get_game_ptr()->m_game_window.mapPixelToCoords(sf::Vector2i
 				(new_half_view_pos), m_view);
-			// Set specified Gui at the center of the screen again.
+			// Set specified Gui and the preloading progress below it at the center of the screen again.
 			m_str_Gui_map.at(GUI_NAME)->setPosition(new_half_view_pos);
+			m_str_Gui_map.at(PRELOAD_GUI_NAME)->setPosition(new_half_view_pos);
 
 			// Set background sprite to fill the entire window.
 			this->get_game_ptr()->m_background_sprite.setScale(
@@ -102,23 +158,26 @@ void MainMenuGameState::inputProcess()
 				this->get_game_ptr()->m_game_window.close();
 			break;
 		}
-		// Highlight mouse hover GuiEntry object.
+		// Highlight mouse hover GuiEntry object and show its save slot's thumbnail.
 		case sf::Event::MouseMoved:
 		{
-			m_str_Gui_map.at(GUI_NAME)->highlight_entry(m_str_Gui_map.at(GUI_NAME)->
-			get_gui_entry_idx(mouse_pos));
+			const int entry_idx = m_str_Gui_map.at(GUI_NAME)->highlight_hovered_entry(mouse_pos);
+			this->show_thumbnail(entry_idx);
+			break;
 		}
 		// Handle left mouse button pressed case.
 		case sf::Event::MouseButtonPressed:
 		{
-			// Check if user press left mouse button.
-			if (event.mouseButton.button == sf::Mouse::Left)
+			// Check if user press left mouse button and no city is being loaded.
+			if (event.mouseButton.button == sf::Mouse::Left && !m_city_future.valid())
 			{
-				// Load game if user press the "load game" GuiEntry object.
-				std::string msg = m_str_Gui_map.at(GUI_NAME)->get_mouse_pos_entry_msg(mouse_pos);
-				if (msg == LOAD_GAME_GUI_ENTRY_MSG)
-					this->loadGame();
+				// Load the related city if user press a save slot or the new city GuiEntry object.
+				const int entry_idx = m_str_Gui_map.at(GUI_NAME)->get_gui_entry_idx(mouse_pos);
+				unsigned int slot_idx{0};
+				if (this->get_entry_slot_idx(entry_idx, slot_idx))
+					this->loadGame(slot_idx, entry_idx);
 			}
+			break;
 		}
 		default:
 			break;
@@ -126,10 +185,128 @@ void MainMenuGameState::inputProcess()
 	}
 }
 
-void MainMenuGameState::loadGame()
+void MainMenuGameState::loadGame(unsigned int slot_idx, int entry_idx)
 {
-	// Create a MainGameState object and push it into the state stack.
+	// Show the loading progress on the clicked GuiEntry object.
+	m_str_Gui_map.at(GUI_NAME)->set_gui_entry_text(entry_idx, LOADING_GUI_ENTRY_TEXT);
 
-	MainGameState main_menu_game_state(this->get_game_ptr());
-	this->get_game_ptr()->push_state(std::make_unique<MainGameState>(main_menu_game_state));
-}
\ No newline at end of file
+	// Take over the preloaded city if it is chosen, the switch happens as soon as it is loaded.
+	m_loading_slot = SaveSlot(slot_idx);
+	if (m_preload_future.valid() && m_preload_slot.get_idx() == slot_idx)
+	{
+		m_city_future = std::move(m_preload_future);
+		m_is_preloaded_city = true;
+		return;
+	}
+	// Another city is chosen, so stop preloading instead of loading both cities at once.
+	this->cancel_preload();
+
+	/* Load the city in background so that the menu keeps responding. A replayed city is neither journaled nor saved.
+	 * Tile prototypes are only read while the city is loading. */
+	const bool is_journaling = this->get_game_ptr()->m_replay_trace_path.empty();
+	std::unordered_map<std::string, Tile>& str_tile_map = this->get_game_ptr()->m_str_tile_map;
+	const SaveSlot slot(m_loading_slot);
+	const unsigned int tile_half_width = Game::m_tile_half_width_pixel;
+	m_city_future = std::async(std::launch::async, [slot, tile_half_width, is_journaling, &str_tile_map]
+	{
+		return std::make_shared<City>(slot, tile_half_width, str_tile_map, is_journaling);
+	});
+}
+
+void MainMenuGameState::show_thumbnail(int entry_idx)
+{
+	if (entry_idx == m_thumbnail_entry_idx)
+		return;
+	m_thumbnail_entry_idx = entry_idx;
+
+	// Only save slots with a header file have a thumbnail.
+	m_is_thumbnail_visible = entry_idx >= 0 && entry_idx < static_cast<int>(m_slot_headers_vec.size()) &&
+		m_slot_headers_vec[entry_idx].m_has_summary;
+	if (!m_is_thumbnail_visible)
+		return;
+
+	// Color each thumbnail pixel according to its tile type.
+	const std::vector<std::uint8_t>& thumbnail_vec = m_slot_headers_vec[entry_idx].m_thumbnail_vec;
+	m_thumbnail_image.create(SAVE_SLOT_THUMBNAIL_SIZE, SAVE_SLOT_THUMBNAIL_SIZE, sf::Color::Black);
+	for (unsigned int y = 0; y < SAVE_SLOT_THUMBNAIL_SIZE; ++y)
+	{
+		for (unsigned int x = 0; x < SAVE_SLOT_THUMBNAIL_SIZE; ++x)
+		{
+			const std::uint8_t tile_type = thumbnail_vec[y * SAVE_SLOT_THUMBNAIL_SIZE + x];
+			if (tile_type <= static_cast<std::uint8_t>(TileTypeEnum::INDUSTRIAL))
+				m_thumbnail_image.setPixel(x, y, SLOT_THUMBNAIL_TILE_COLOR_ARR[tile_type]);
+		}
+	}
+	m_thumbnail_texture.loadFromImage(m_thumbnail_image);
+	m_thumbnail_sprite.setTexture(m_thumbnail_texture, true);
+
+	// Place the thumbnail at the right side of the save slot list, aligned with the hovered entry.
+	const Gui& slot_gui = *m_str_Gui_map.at(GUI_NAME);
+	m_thumbnail_sprite.setPosition(slot_gui.getPosition() - slot_gui.getOrigin() + sf::Vector2f(
+		slot_gui.get_gui_size().x + SLOT_THUMBNAIL_X_OFFSET, static_cast<float>(entry_idx * SLOT_GUI_ENTRY_HEIGHT)));
+}
+void MainMenuGameState::preload_city(int entry_idx)
+{
+	unsigned int slot_idx{0};
+	if (!this->get_entry_slot_idx(entry_idx, slot_idx))
+		return;
+
+	// The preloaded city never touches the save files, so preloading a city which is not chosen changes nothing.
+	m_preload_slot = SaveSlot(slot_idx);
+	m_preload_name = entry_idx < static_cast<int>(m_slot_headers_vec.size()) ? m_slot_headers_vec[entry_idx].m_name :
+		NEW_CITY_GUI_ENTRY_NAME;
+	m_preload_progress_ptr = std::make_shared<std::atomic<unsigned int>>(0);
+	m_preload_cancel_ptr = std::make_shared<std::atomic<bool>>(false);
+	std::unordered_map<std::string, Tile>& str_tile_map = this->get_game_ptr()->m_str_tile_map;
+	const SaveSlot slot(m_preload_slot);
+	const unsigned int tile_half_width = Game::m_tile_half_width_pixel;
+	std::shared_ptr<std::atomic<unsigned int>> progress_ptr(m_preload_progress_ptr);
+	std::shared_ptr<std::atomic<bool>> cancel_ptr(m_preload_cancel_ptr);
+	m_preload_future = std::async(std::launch::async, [slot, tile_half_width, progress_ptr, cancel_ptr, &str_tile_map]
+	{
+		return std::make_shared<City>(slot, tile_half_width, str_tile_map, false, progress_ptr.get(),
+			cancel_ptr.get());
+	});
+}
+
+void MainMenuGameState::cancel_preload()
+{
+	if (!m_preload_future.valid())
+		return;
+
+	/* Destroying the future right away would block until the whole city is loaded, so keep it until update finds
+	 * that the background thread has stopped. */
+	m_preload_cancel_ptr->store(true);
+	m_preload_progress_ptr.reset();
+	m_shown_preload_progress = -1;
+	m_str_Gui_map.at(PRELOAD_GUI_NAME)->set_gui_entry_text(0, std::string());
+}
+
+void MainMenuGameState::update_preload_progress()
+{
+	if (!m_preload_progress_ptr)
+		return;
+
+	// Only change the text when the progress changes.
+	const int progress = static_cast<int>(m_preload_progress_ptr->load());
+	if (progress == m_shown_preload_progress)
+		return;
+	m_shown_preload_progress = progress;
+	if (progress < static_cast<int>(CITY_LOAD_DONE_PROGRESS))
+		m_str_Gui_map.at(PRELOAD_GUI_NAME)->set_gui_entry_text(0, PRELOADING_GUI_ENTRY_PREFIX + m_preload_name + " " +
+			std::to_string(progress) + "%");
+	else
+		m_str_Gui_map.at(PRELOAD_GUI_NAME)->set_gui_entry_text(0, m_preload_name + PRELOADED_GUI_ENTRY_SUFFIX);
+}
+
+bool MainMenuGameState::get_entry_slot_idx(int entry_idx, unsigned int& slot_idx) const
+{
+	const std::string msg = m_str_Gui_map.at(GUI_NAME)->get_entry_msg(entry_idx);
+	if (msg.compare(0, LOAD_SLOT_GUI_ENTRY_MSG_PREFIX.size(), LOAD_SLOT_GUI_ENTRY_MSG_PREFIX) == 0)
+		slot_idx = std::stoul(msg.substr(LOAD_SLOT_GUI_ENTRY_MSG_PREFIX.size()));
+	else if (msg == NEW_CITY_GUI_ENTRY_MSG)
+		slot_idx = SaveSlot::find_free_slot_idx();
+	else
+		return false;
+	return true;
+}
@@ -1,5 +1,9 @@
-#include <fstream>
+#include <algorithm>
+#include <array>
+#include "JobSystem.hpp"
 #include "Map.hpp"
+#include "MapChunkFile.hpp"
+#include "Profiler.hpp"
 #include "Utility.hpp"
 
 Map::Map(const std::string& file_name, unsigned int width, unsigned int height,
@@ -8,26 +12,43 @@ Map::Map(const std::string& file_name, unsigned int width, unsigned int height,
 	this->load(file_name, width, height, str_tile_map);
 }
 
-void Map::load(const std::string& file_name, unsigned int width, unsigned int height,
+bool Map::load(const std::string& file_name, unsigned int width, unsigned int height,
 	std::unordered_map<std::string, Tile>& str_tile_map)
 {
+	// Read all tiles from the chunked game map file(or the one written by old versions).
+	std::vector<TileSnapshot> tiles_vec;
+	if (!MapChunkFile::load(file_name, width, height, tiles_vec))
+		tiles_vec.clear();
+	return this->load(tiles_vec, width, height, str_tile_map);
+}
+
+bool Map::load(const std::vector<TileSnapshot>& tiles_vec, unsigned int width, unsigned int height,
+	std::unordered_map<std::string, Tile>& str_tile_map)
+{
+	PROFILE_SCOPE("Map::load");
 	// Store the dimension of the map.
 	m_width = width;
 	m_height = height;
-
-	// Open the store eternal file in binary form to read.
-	std::ifstream input_file(file_name, std::ios::in | std::ios::binary);
+	// All chunks' grass summed-area tables are built once the first rectangle is counted.
+	const unsigned int chunks_num = this->get_chunks_x_num() * ((height + MAP_CHUNK_SIZE - 1) / MAP_CHUNK_SIZE);
+	m_grass_sums_vec.assign(static_cast<std::size_t>(chunks_num) * MAP_CHUNK_SIZE * MAP_CHUNK_SIZE, 0);
+	m_is_grass_chunk_dirty_vec.assign(chunks_num, 0);
+	m_dirty_grass_chunk_idx_vec.clear();
+	if (width > 0 && height > 0)
+		this->mark_grass_sums_dirty(sf::Vector2i(0, 0), sf::Vector2i(width - 1, height - 1));
+	// No snapshot holds the new tiles yet.
+	m_is_chunk_changed_vec.assign(chunks_num, 0);
+	m_changed_chunk_idx_vec.clear();
+	m_are_all_chunks_changed = true;
 
 	// Check if its first time we create the game map or something wrong with the game map.
-	if(input_file.fail())
+	if (tiles_vec.size() != static_cast<std::size_t>(width) * height)
 	{
 		// Generate each tile within the game map.
 		for (int pos = 0; pos < (m_width * m_height); ++pos)
 		{
 			// Set each tile object's initial production to be 255.
 			m_resource_vec.emplace_back(EACH_TILE_PRODUCTION);
-			// Initialize each selected tile's condition to zero(not selected).
-			m_selected_tiles_condition_vec.emplace_back(TILE_NOT_SELECTED_FLAG);
 
 			// For each tile, 20% to be a forest tile, 20% to be a water tile and other 60% to be a grass tile.
 			switch (rand() % 10)
@@ -67,22 +88,17 @@ void Map::load(const std::string& file_name, unsigned int width, unsigned int he
 				break;
 			}
 		}
+		return false;
 	}
 	else
 	{
-		// Load each tile object within the game map.
-		for (int pos = 0; pos < (m_width * m_height); ++pos)
+		// Create each tile object within the game map from its snapshot.
+		for (const auto& each_tile : tiles_vec)
 		{
-			// Set each tile object's initial production to be 255.
-			m_resource_vec.emplace_back(EACH_TILE_PRODUCTION);
-			// Initialize each selected tile's condition to zero(not selected).
-			m_selected_tiles_condition_vec.emplace_back(TILE_NOT_SELECTED_FLAG);
+			m_resource_vec.emplace_back(each_tile.m_resource);
 
-			// Read and store each tile object's tile type.
-			TileTypeEnum tileType;
-			input_file.read(reinterpret_cast<char*>(&tileType), sizeof(TileTypeEnum));
 			// Set up each tile object's texture according to its tile type.
-			switch (tileType)
+			switch (each_tile.m_tileType)
 			{
 			case TileTypeEnum::VOID:
 			case TileTypeEnum::FOREST:
@@ -110,68 +126,117 @@ void Map::load(const std::string& file_name, unsigned int width, unsigned int he
 				break;
 			}
 
-			// Set up each tile object's current level, region id array, current population and total production.
+			/* Set up each tile object's current level, region id array, current population, total production and
+			 * production per day. */
 			Tile& curr_tile_ref = m_tiles_vec.back();
-			input_file.read(reinterpret_cast<char*>(&(curr_tile_ref.m_level)), sizeof(unsigned int));
-			input_file.read(reinterpret_cast<char*>(&(curr_tile_ref.m_region_arr)), sizeof(unsigned int) * 1);
-			input_file.read(reinterpret_cast<char*>(&(curr_tile_ref.m_population)), sizeof(double));
-			input_file.read(reinterpret_cast<char*>(&(curr_tile_ref.m_total_production)), sizeof(float));
+			curr_tile_ref.m_level = each_tile.m_level;
+			curr_tile_ref.m_region_arr[0] = each_tile.m_region_arr[0];
+			curr_tile_ref.m_population = each_tile.m_population;
+			curr_tile_ref.m_total_production = each_tile.m_total_production;
+			curr_tile_ref.set_production_per_day(each_tile.m_production_per_day);
 		}
-		input_file.close();
+		return true;
 	}
 }
 
 void Map::save(const std::string& file_name)
 {
-	// Open the eternal file in binary form to write.
-	std::ofstream output_file(file_name, std::ios::binary|std::ios::out);
+	// Capture each tile object and write them into disk.
+	std::vector<TileSnapshot> tiles_vec;
+	this->take_snapshot(tiles_vec);
+	MapChunkFile::write(file_name, m_width, m_height, tiles_vec);
+}
+
+void Map::take_snapshot(std::vector<TileSnapshot>& tiles_vec) const
+{
+	// Resize only when the map's size changes, otherwise reuse the existing buffer.
+	tiles_vec.resize(m_tiles_vec.size());
+
+	// Each tile is copied independently, so the map is split among the job system's threads.
+	JobSystem::getInstance()->parallel_for(0, m_tiles_vec.size(), JOB_SYSTEM_MIN_TILES_PER_JOB,
+		[this, &tiles_vec](std::size_t begin, std::size_t end)
+	{
+		for (size_t i = begin; i < end; ++i)
+			this->copy_tile_snapshot(i, tiles_vec[i]);
+	});
+}
 
-	// Store each tile object's tile type, current level, region id array, current population and total production.
-	for (auto& each_tile: m_tiles_vec)
+void Map::update_snapshot(std::vector<TileSnapshot>& tiles_vec)
+{
+	PROFILE_SCOPE("Map::update_snapshot");
+	if (m_are_all_chunks_changed || tiles_vec.size() != m_tiles_vec.size())
+		this->take_snapshot(tiles_vec);
+	else
 	{
-		output_file.write(reinterpret_cast<char*>(&(each_tile.m_tileType)), sizeof(TileTypeEnum));
-		output_file.write(reinterpret_cast<char*>(&(each_tile.m_level)), sizeof(unsigned int));
-		output_file.write(reinterpret_cast<char*>(&(each_tile.m_region_arr)), sizeof(unsigned int) * 1);
-		output_file.write(reinterpret_cast<char*>(&(each_tile.m_population)), sizeof(double));
-		output_file.write(reinterpret_cast<char*>(&(each_tile.m_total_production)), sizeof(float));
+		// Each changed chunk is copied row by row, the chunks are split among the job system's threads.
+		const unsigned int chunks_x_num = this->get_chunks_x_num();
+		JobSystem::getInstance()->parallel_for(0, m_changed_chunk_idx_vec.size(), JOB_SYSTEM_MIN_TILES_PER_JOB /
+			(MAP_CHUNK_SIZE * MAP_CHUNK_SIZE), [this, &tiles_vec, chunks_x_num](std::size_t begin, std::size_t end)
+		{
+			for (std::size_t i = begin; i < end; ++i)
+			{
+				const unsigned int first_x = m_changed_chunk_idx_vec[i] % chunks_x_num * MAP_CHUNK_SIZE;
+				const unsigned int first_y = m_changed_chunk_idx_vec[i] / chunks_x_num * MAP_CHUNK_SIZE;
+				const unsigned int last_x = std::min(first_x + MAP_CHUNK_SIZE, m_width);
+				const unsigned int last_y = std::min(first_y + MAP_CHUNK_SIZE, m_height);
+				for (unsigned int y = first_y; y < last_y; ++y)
+					for (std::size_t idx = y * m_width + first_x; idx < y * m_width + last_x; ++idx)
+						this->copy_tile_snapshot(idx, tiles_vec[idx]);
+			}
+		});
 	}
 
-	output_file.close();
+	// The snapshot now holds every tile, so nothing is changed since.
+	for (const auto chunk_idx : m_changed_chunk_idx_vec)
+		m_is_chunk_changed_vec[chunk_idx] = 0;
+	m_changed_chunk_idx_vec.clear();
+	m_are_all_chunks_changed = false;
 }
 
-void Map::render(sf::RenderWindow& renderWindow, float dt)
+void Map::mark_tile_changed(int idx)
 {
+	const unsigned int chunk_idx = idx / static_cast<int>(m_width) / MAP_CHUNK_SIZE * this->get_chunks_x_num() +
+		idx % static_cast<int>(m_width) / MAP_CHUNK_SIZE;
+	if (m_is_chunk_changed_vec[chunk_idx])
+		return;
+	m_is_chunk_changed_vec[chunk_idx] = 1;
+	m_changed_chunk_idx_vec.push_back(chunk_idx);
+}
 
-	// Iterate horizontally and then vertically to render each isometric tile.
-	for (int y = 0; y < m_height; ++y)
-		for (int x = 0; x < m_width; ++x)
-		{
-			// Get each isometric tile's position(tile coordinate to screen coordinate).
-			sf::Vector2f pos(m_tile_half_width * (x - y) + m_width * m_tile_half_width,
-				m_tile_half_width * (x + y) * 0.5);
-			// Bind each tile's position with related element inside m_tiles_vec.
-			m_tiles_vec[y * m_width + x].m_sprite.setPosition(pos);
-
-			// If current tile is selected, set its color to be dark, white color otherwise.
-			if (m_selected_tiles_condition_vec.at(y * m_width + x) == TILE_SELECTED_FLAG)
-				m_tiles_vec[y * m_width + x].m_sprite.setColor(TILE_SELECTED_COLOR);
-			else
-				m_tiles_vec[y * m_width + x].m_sprite.setColor(sf::Color::White);
-
-			// Draw each tile object.
-			m_tiles_vec[y * m_width + x].render(renderWindow, dt);
-		}
+void Map::mark_all_tiles_changed()
+{
+	m_are_all_chunks_changed = true;
+}
+
+void Map::copy_tile_snapshot(std::size_t idx, TileSnapshot& tile_snapshot) const
+{
+	/* Copy the tile object's tile type, current level, region id array, current population, total production,
+	 * resource and production per day. */
+	tile_snapshot.m_tileType = m_tiles_vec[idx].m_tileType;
+	tile_snapshot.m_level = m_tiles_vec[idx].m_level;
+	tile_snapshot.m_region_arr[0] = m_tiles_vec[idx].m_region_arr[0];
+	tile_snapshot.m_population = m_tiles_vec[idx].m_population;
+	tile_snapshot.m_total_production = m_tiles_vec[idx].m_total_production;
+	tile_snapshot.m_resource = m_resource_vec[idx];
+	tile_snapshot.m_production_per_day = m_tiles_vec[idx].get_production_per_day();
 }
 
 void Map::calculateConnectedRegionsNum(const std::vector<TileTypeEnum>& region_tiles_type_vec, unsigned int region_index)
 {
+	PROFILE_SCOPE("Map::calculateConnectedRegionsNum");
 	// Indicates the number of input region type, starts from one.
 	unsigned int region_num{1};
 
 	/* Reset each tile object's region array's input region_type's related value to zero( which means not inside related
-	 * region for now). */
-	for (auto& tile : m_tiles_vec)
-		tile.m_region_arr[region_index] = 0;
+	 * region for now). The previous values are kept so each region can keep its id. */
+	std::vector<unsigned int> prev_region_vec(m_tiles_vec.size());
+	unsigned int max_prev_region{0};
+	for (std::size_t i = 0; i < m_tiles_vec.size(); ++i)
+	{
+		prev_region_vec[i] = m_tiles_vec[i].m_region_arr[region_index];
+		max_prev_region = std::max(max_prev_region, prev_region_vec[i]);
+		m_tiles_vec[i].m_region_arr[region_index] = 0;
+	}
 
 	// Iterate through all tile objects.
 	for (int y = 0; y < m_height; ++y)
@@ -194,187 +259,279 @@ void Map::calculateConnectedRegionsNum(const std::vector<TileTypeEnum>& region_t
 
 	// Store the input region type's region number.
 	m_region_num_arr[region_index] = region_num;
+
+	/* Each region keeps the previous id of its first tile in map order which had one, so an edit only changes the ids
+	 * of the regions it splits or merges rather than of every region found after it. A region whose previous id is
+	 * already kept by an earlier one, or which had none, takes the smallest unused id. */
+	std::vector<unsigned int> region_id_vec(region_num, 0);
+	for (std::size_t i = 0; i < m_tiles_vec.size(); ++i)
+	{
+		const unsigned int region_idx = m_tiles_vec[i].m_region_arr[region_index];
+		if (region_idx != 0 && region_id_vec[region_idx] == 0)
+			region_id_vec[region_idx] = prev_region_vec[i];
+	}
+	std::vector<std::uint8_t> is_id_kept_vec(std::max(max_prev_region, region_num) + 1, 0);
+	for (unsigned int region_idx = 1; region_idx < region_num; ++region_idx)
+	{
+		if (is_id_kept_vec[region_id_vec[region_idx]])
+			region_id_vec[region_idx] = 0;
+		else if (region_id_vec[region_idx] != 0)
+			is_id_kept_vec[region_id_vec[region_idx]] = 1;
+	}
+	unsigned int unused_id{1};
+	for (unsigned int region_idx = 1; region_idx < region_num; ++region_idx)
+	{
+		if (region_id_vec[region_idx] != 0)
+			continue;
+		while (is_id_kept_vec[unused_id])
+			++unused_id;
+		region_id_vec[region_idx] = unused_id;
+		is_id_kept_vec[unused_id] = 1;
+	}
+
+	// Relabel the tiles, only those whose id changes are copied by the next autosave.
+	for (std::size_t i = 0; i < m_tiles_vec.size(); ++i)
+	{
+		unsigned int& region_id = m_tiles_vec[i].m_region_arr[region_index];
+		region_id = region_id_vec[region_id];
+		if (region_id != prev_region_vec[i])
+			this->mark_tile_changed(static_cast<int>(i));
+	}
 }
 
 void Map::updateDirection(TileTypeEnum tileType)
 {
-	for (int y = 0; y < m_height; ++y)
+	PROFILE_SCOPE("Map::updateDirection");
+	/* Each tile only reads its neighbours' tile types and only writes its own level, so rows are split among the job
+	 * system's threads. */
+	const std::size_t min_rows_num = JOB_SYSTEM_MIN_TILES_PER_JOB / std::max(m_width, 1u);
+	JobSystem::getInstance()->parallel_for(0, m_height, min_rows_num, [this, tileType](std::size_t begin,
+		std::size_t end)
 	{
-		for (int x = 0; x < m_width; ++x)
-		{
-			// Retrieve current position.
-			int pos = y * m_width + x;
-
-			// Check if current tile object's type matches the input.
-			if (m_tiles_vec[pos].m_tileType != tileType)
-				continue;
-
-			/* Create a 2D 3X3 array(as a mimic of 9 isometric tiles' structure) to help the check.
-			 * Check current tile object's 8 adjacent tiles. Set related array element to true if the adjacent Tile
-			 * object is of the same type as the current tile object and false otherwise. Current tile(y, x) is also
-			 * the center element (1, 1) of the adjacent tile array. */
-
-			/* 					(0, 0)
-			 * 			   (0, 1)    (1, 0)
-			 * 			 (0, 2) (1, 1) (2, 0)
-			 * 			   (1, 2)    (2, 1)
-			 * 			        (2, 2)
-			 * The isometric sample represented by the adjacent array.
-			 * */
-
-			std::array<std::array<int, 3>, 3> adjacent_tiles_arr{{{ 0, 0, 0 }, { 0, 0, 0 }, { 0, 0, 0 }}};
-
-			// Match with top tile object.
-			if (x > 0 && y > 0)
-				adjacent_tiles_arr[0][0] = (m_tiles_vec[(y - 1) * m_width + (x - 1)].m_tileType == tileType);
-			// Match with top left tile object.
-			if (y > 0)
-				adjacent_tiles_arr[0][1] = (m_tiles_vec[(y - 1) * m_width + x].m_tileType == tileType);
-			// Match with left tile object.
-			if (x < m_width - 1 && y > 0)
-				adjacent_tiles_arr[0][2] = (m_tiles_vec[(y - 1) * m_width + (x + 1)].m_tileType == tileType);
-			// Match with top right tile object.
-			if (x > 0)
-				adjacent_tiles_arr[1][0] = (m_tiles_vec[y * m_width + (x - 1)].m_tileType == tileType);
-			// Match with bottom left tile object.
-			if (x < m_width - 1)
-				adjacent_tiles_arr[1][2] = (m_tiles_vec[y * m_width + (x + 1)].m_tileType == tileType);
-			// Match with right tile object.
-			if (x > 0 && y < m_height - 1)
-				adjacent_tiles_arr[2][0] = (m_tiles_vec[(y + 1) * m_width + (x - 1)].m_tileType == tileType);
-			// Match with bottom right tile object.
-			if (y < m_height - 1)
-				adjacent_tiles_arr[2][1] = (m_tiles_vec[(y + 1) * m_width + x].m_tileType == tileType);
-			// Match with bottom tile object.
-			if (x < m_width - 1 && y < m_height - 1)
-				adjacent_tiles_arr[2][2] = (m_tiles_vec[(y + 1) * m_width + (x + 1)].m_tileType == tileType);
-
-			// Change the tile level depending on related adjacent elements' values.
-			if (adjacent_tiles_arr[1][0] && adjacent_tiles_arr[1][2] && adjacent_tiles_arr[0][1] &&
-				adjacent_tiles_arr[2][1])
-				m_tiles_vec[pos].set_level(TOP_LEFT_TOP_RIGHT_BOTTOM_LEFT_BOTTOM_RIGHT_DIR);
-			else if (adjacent_tiles_arr[1][0] && adjacent_tiles_arr[1][2] && adjacent_tiles_arr[0][1])
-				m_tiles_vec[pos].set_level(TOP_LEFT_TOP_RIGHT_BOTTOM_LEFT_DIR);
-			else if (adjacent_tiles_arr[1][0] && adjacent_tiles_arr[1][2] && adjacent_tiles_arr[2][1])
-				m_tiles_vec[pos].set_level(TOP_RIGHT_BOTTOM_LEFT_BOTTOM_RIGHT_DIR);
-			else if (adjacent_tiles_arr[0][1] && adjacent_tiles_arr[2][1] && adjacent_tiles_arr[1][0])
-				m_tiles_vec[pos].set_level(TOP_LEFT_TOP_RIGHT_BOTTOM_RIGHT_DIR);
-			else if (adjacent_tiles_arr[0][1] && adjacent_tiles_arr[2][1] && adjacent_tiles_arr[1][2])
-				m_tiles_vec[pos].set_level(TOP_LEFT_BOTTOM_LEFT_BOTTOM_RIGHT_DIR);
-			else if (adjacent_tiles_arr[1][0] && adjacent_tiles_arr[1][2])
-				m_tiles_vec[pos].set_level(TOP_RIGHT_BOTTOM_LEFT_DIR);
-			else if (adjacent_tiles_arr[0][1] && adjacent_tiles_arr[2][1])
-				m_tiles_vec[pos].set_level(TOP_LEFT_BOTTOM_RIGHT_DIR);
-			else if (adjacent_tiles_arr[2][1] && adjacent_tiles_arr[1][0])
-				m_tiles_vec[pos].set_level(TOP_RIGHT_BOTTOM_RIGHT_DIR);
-			else if (adjacent_tiles_arr[0][1] && adjacent_tiles_arr[1][2])
-				m_tiles_vec[pos].set_level(TOP_LEFT_BOTTOM_LEFT_DIR);
-			else if (adjacent_tiles_arr[1][0] && adjacent_tiles_arr[0][1])
-				m_tiles_vec[pos].set_level(TOP_LEFT_TOP_RIGHT_DIR);
-			else if (adjacent_tiles_arr[2][1] && adjacent_tiles_arr[1][2])
-				m_tiles_vec[pos].set_level(BOTTOM_LEFT_BOTTOM_RIGHT_DIR);
-			else if (adjacent_tiles_arr[1][0])
-				m_tiles_vec[pos].set_level(TOP_RIGHT_DIR);
-			else if (adjacent_tiles_arr[1][2])
-				m_tiles_vec[pos].set_level(BOTTOM_LEFT_DIR);
-			else if (adjacent_tiles_arr[0][1])
-				m_tiles_vec[pos].set_level(TOP_LEFT_DIR);
-			else if (adjacent_tiles_arr[2][1])
-				m_tiles_vec[pos].set_level(BOTTOM_RIGHT_DIR);
-		}
-	}
+		for (int y = static_cast<int>(begin); y < static_cast<int>(end); ++y)
+			for (int x = 0; x < m_width; ++x)
+				this->update_tile_direction(x, y, tileType);
+	});
+	// The levels are written by several threads, so the changed tiles are not tracked one by one.
+	this->mark_all_tiles_changed();
 }
 
-void Map::DFS(const std::vector<TileTypeEnum>& whitelist_vec, sf::Vector2i pos, unsigned int region_idx,
-	unsigned int region_type)
+void Map::updateDirection(TileTypeEnum tileType, const std::vector<int>& changed_idx_vec)
 {
-	// Check if input position is valid or not.
-	if (pos.x < 0 || pos.x >= m_width)
-		return;
-	if (pos.y < 0 || pos.y >= m_height)
+	PROFILE_SCOPE("Map::updateDirection");
+	if (changed_idx_vec.empty())
 		return;
 
-	// Check if related tile was already visited before or not.
-	if (m_tiles_vec[pos.y * m_width + pos.x].m_region_arr[0] != 0)
-		return;
+	// Find the changed tiles' bounding rectangle grown by one tile, clamped into the map.
+	sf::Vector2i start_pos(m_width, m_height);
+	sf::Vector2i end_pos(-1, -1);
+	for (const auto idx : changed_idx_vec)
+	{
+		const sf::Vector2i pos(idx % static_cast<int>(m_width), idx / static_cast<int>(m_width));
+		start_pos = sf::Vector2i(std::min(start_pos.x, pos.x), std::min(start_pos.y, pos.y));
+		end_pos = sf::Vector2i(std::max(end_pos.x, pos.x), std::max(end_pos.y, pos.y));
+	}
+	start_pos = sf::Vector2i(std::max(start_pos.x - 1, 0), std::max(start_pos.y - 1, 0));
+	end_pos = sf::Vector2i(std::min(end_pos.x + 1, static_cast<int>(m_width) - 1),
+		std::min(end_pos.y + 1, static_cast<int>(m_height) - 1));
 
-	// Check if current tile object's tile type is in the white list(can make up a region).
-	bool is_tile_type_match{false};
-	for (const auto& tileType : whitelist_vec)
-		if (tileType == m_tiles_vec[pos.y * m_width + pos.x].m_tileType)
+	for (int y = start_pos.y; y <= end_pos.y; ++y)
+		for (int x = start_pos.x; x <= end_pos.x; ++x)
 		{
-			is_tile_type_match = true;
-			break;
+			const int idx = y * static_cast<int>(m_width) + x;
+			const unsigned int prev_level = m_tiles_vec[idx].m_level;
+			this->update_tile_direction(x, y, tileType);
+			if (m_tiles_vec[idx].m_level != prev_level)
+				this->mark_tile_changed(idx);
 		}
-	// If not, no longer needs subsequent process.
-	if (!is_tile_type_match)
+}
+
+void Map::update_tile_direction(int x, int y, TileTypeEnum tileType)
+{
+	// Retrieve current position.
+	int pos = y * m_width + x;
+
+	// Check if current tile object's type matches the input.
+	if (m_tiles_vec[pos].m_tileType != tileType)
 		return;
 
-	// Otherwise assigns current Tile's region array's related region type's region a unique region_idx.
-	m_tiles_vec[pos.y * m_width + pos.x].m_region_arr[region_type] = region_idx;
+	/* Create a 2D 3X3 array(as a mimic of 9 isometric tiles' structure) to help the check.
+	 * Check current tile object's 8 adjacent tiles. Set related array element to true if the adjacent Tile
+	 * object is of the same type as the current tile object and false otherwise. Current tile(y, x) is also
+	 * the center element (1, 1) of the adjacent tile array. */
+
+	/* 					(0, 0)
+	 * 			   (0, 1)    (1, 0)
+	 * 			 (0, 2) (1, 1) (2, 0)
+	 * 			   (1, 2)    (2, 1)
+	 * 			        (2, 2)
+	 * The isometric sample represented by the adjacent array.
+	 * */
+
+	std::array<std::array<int, 3>, 3> adjacent_tiles_arr{{{ 0, 0, 0 }, { 0, 0, 0 }, { 0, 0, 0 }}};
+
+	// Match with top tile object.
+	if (x > 0 && y > 0)
+		adjacent_tiles_arr[0][0] = (m_tiles_vec[(y - 1) * m_width + (x - 1)].m_tileType == tileType);
+	// Match with top left tile object.
+	if (y > 0)
+		adjacent_tiles_arr[0][1] = (m_tiles_vec[(y - 1) * m_width + x].m_tileType == tileType);
+	// Match with left tile object.
+	if (x < m_width - 1 && y > 0)
+		adjacent_tiles_arr[0][2] = (m_tiles_vec[(y - 1) * m_width + (x + 1)].m_tileType == tileType);
+	// Match with top right tile object.
+	if (x > 0)
+		adjacent_tiles_arr[1][0] = (m_tiles_vec[y * m_width + (x - 1)].m_tileType == tileType);
+	// Match with bottom left tile object.
+	if (x < m_width - 1)
+		adjacent_tiles_arr[1][2] = (m_tiles_vec[y * m_width + (x + 1)].m_tileType == tileType);
+	// Match with right tile object.
+	if (x > 0 && y < m_height - 1)
+		adjacent_tiles_arr[2][0] = (m_tiles_vec[(y + 1) * m_width + (x - 1)].m_tileType == tileType);
+	// Match with bottom right tile object.
+	if (y < m_height - 1)
+		adjacent_tiles_arr[2][1] = (m_tiles_vec[(y + 1) * m_width + x].m_tileType == tileType);
+	// Match with bottom tile object.
+	if (x < m_width - 1 && y < m_height - 1)
+		adjacent_tiles_arr[2][2] = (m_tiles_vec[(y + 1) * m_width + (x + 1)].m_tileType == tileType);
+
+	// Change the tile level depending on related adjacent elements' values.
+	if (adjacent_tiles_arr[1][0] && adjacent_tiles_arr[1][2] && adjacent_tiles_arr[0][1] &&
+		adjacent_tiles_arr[2][1])
+		m_tiles_vec[pos].set_level(TOP_LEFT_TOP_RIGHT_BOTTOM_LEFT_BOTTOM_RIGHT_DIR);
+	else if (adjacent_tiles_arr[1][0] && adjacent_tiles_arr[1][2] && adjacent_tiles_arr[0][1])
+		m_tiles_vec[pos].set_level(TOP_LEFT_TOP_RIGHT_BOTTOM_LEFT_DIR);
+	else if (adjacent_tiles_arr[1][0] && adjacent_tiles_arr[1][2] && adjacent_tiles_arr[2][1])
+		m_tiles_vec[pos].set_level(TOP_RIGHT_BOTTOM_LEFT_BOTTOM_RIGHT_DIR);
+	else if (adjacent_tiles_arr[0][1] && adjacent_tiles_arr[2][1] && adjacent_tiles_arr[1][0])
+		m_tiles_vec[pos].set_level(TOP_LEFT_TOP_RIGHT_BOTTOM_RIGHT_DIR);
+	else if (adjacent_tiles_arr[0][1] && adjacent_tiles_arr[2][1] && adjacent_tiles_arr[1][2])
+		m_tiles_vec[pos].set_level(TOP_LEFT_BOTTOM_LEFT_BOTTOM_RIGHT_DIR);
+	else if (adjacent_tiles_arr[1][0] && adjacent_tiles_arr[1][2])
+		m_tiles_vec[pos].set_level(TOP_RIGHT_BOTTOM_LEFT_DIR);
+	else if (adjacent_tiles_arr[0][1] && adjacent_tiles_arr[2][1])
+		m_tiles_vec[pos].set_level(TOP_LEFT_BOTTOM_RIGHT_DIR);
+	else if (adjacent_tiles_arr[2][1] && adjacent_tiles_arr[1][0])
+		m_tiles_vec[pos].set_level(TOP_RIGHT_BOTTOM_RIGHT_DIR);
+	else if (adjacent_tiles_arr[0][1] && adjacent_tiles_arr[1][2])
+		m_tiles_vec[pos].set_level(TOP_LEFT_BOTTOM_LEFT_DIR);
+	else if (adjacent_tiles_arr[1][0] && adjacent_tiles_arr[0][1])
+		m_tiles_vec[pos].set_level(TOP_LEFT_TOP_RIGHT_DIR);
+	else if (adjacent_tiles_arr[2][1] && adjacent_tiles_arr[1][2])
+		m_tiles_vec[pos].set_level(BOTTOM_LEFT_BOTTOM_RIGHT_DIR);
+	else if (adjacent_tiles_arr[1][0])
+		m_tiles_vec[pos].set_level(TOP_RIGHT_DIR);
+	else if (adjacent_tiles_arr[1][2])
+		m_tiles_vec[pos].set_level(BOTTOM_LEFT_DIR);
+	else if (adjacent_tiles_arr[0][1])
+		m_tiles_vec[pos].set_level(TOP_LEFT_DIR);
+	else if (adjacent_tiles_arr[2][1])
+		m_tiles_vec[pos].set_level(BOTTOM_RIGHT_DIR);
+}
 
-	// Call DFS function recursively on current tile object's four adjacent tile objects.
-	DFS(whitelist_vec, pos + sf::Vector2i(0, 1), region_idx, region_type);
-	DFS(whitelist_vec, pos + sf::Vector2i(1, 0), region_idx, region_type);
-	DFS(whitelist_vec, pos + sf::Vector2i(-1, 0), region_idx, region_type);
-	DFS(whitelist_vec, pos + sf::Vector2i(0, -1), region_idx, region_type);
+void Map::DFS(const std::vector<TileTypeEnum>& whitelist_vec, sf::Vector2i pos, unsigned int region_idx,
+	unsigned int region_type)
+{
+	/* Keep the positions still to be visited on an explicit stack rather than recursing, since a region of a large map
+	 * can hold millions of tiles and would overflow the call stack. */
+	std::vector<sf::Vector2i> pos_stack_vec{ pos };
+	while (!pos_stack_vec.empty())
+	{
+		pos = pos_stack_vec.back();
+		pos_stack_vec.pop_back();
+
+		// Check if input position is valid or not.
+		if (pos.x < 0 || pos.x >= m_width)
+			continue;
+		if (pos.y < 0 || pos.y >= m_height)
+			continue;
+
+		// Check if related tile was already visited before or not.
+		if (m_tiles_vec[pos.y * m_width + pos.x].m_region_arr[0] != 0)
+			continue;
+
+		// Check if current tile object's tile type is in the white list(can make up a region).
+		bool is_tile_type_match{false};
+		for (const auto& tileType : whitelist_vec)
+			if (tileType == m_tiles_vec[pos.y * m_width + pos.x].m_tileType)
+			{
+				is_tile_type_match = true;
+				break;
+			}
+		// If not, no longer needs subsequent process.
+		if (!is_tile_type_match)
+			continue;
+
+		// Otherwise assigns current Tile's region array's related region type's region a unique region_idx.
+		m_tiles_vec[pos.y * m_width + pos.x].m_region_arr[region_type] = region_idx;
+
+		// Visit current tile object's four adjacent tile objects.
+		pos_stack_vec.push_back(pos + sf::Vector2i(0, -1));
+		pos_stack_vec.push_back(pos + sf::Vector2i(-1, 0));
+		pos_stack_vec.push_back(pos + sf::Vector2i(1, 0));
+		pos_stack_vec.push_back(pos + sf::Vector2i(0, 1));
+	}
 }
 
 void Map::select(sf::Vector2i& start_pos, sf::Vector2i& end_pos, const std::vector<TileTypeEnum>& blacklist_vec)
 {
-	// Ensure that start pos is always less than end pos on both axis.
-	if (start_pos.x > end_pos.x)
-		std::swap(start_pos.x, end_pos.x);
-	if (start_pos.y > end_pos.y)
-		std::swap(start_pos.y, end_pos.y);
+	this->clamp_rect(start_pos, end_pos);
+
+	// Store the selected rectangle and its blacklist.
+	m_is_selected = true;
+	m_selected_start_pos = start_pos;
+	m_selected_end_pos = end_pos;
+	m_select_blacklist_mask = 0;
+	for (const auto& tile_type : blacklist_vec)
+		m_select_blacklist_mask |= 1u << static_cast<unsigned int>(tile_type);
+}
 
-	// Clamp both start pos and end pos in range.
-	if (start_pos.x >= m_width)
-		start_pos.x = (m_width - 1);
-	else if (start_pos.x < 0)
-		start_pos.x = 0;
-	if (start_pos.y >= m_height)
-		start_pos.y = (m_height - 1);
-	else if (start_pos.y < 0)
-		start_pos.y = 0;
+void Map::deselect_tiles()
+{
+	m_is_selected = false;
+}
 
-	if (end_pos.x >= m_width)
-		end_pos.x = m_width - 1;
-	else if (end_pos.x < 0)
-		end_pos.x = 0;
-	if (end_pos.y >= m_height)
-		end_pos.y = m_height - 1;
-	else if (end_pos.y < 0)
-		end_pos.y = 0;
+void Map::replace_selected_tiles(const Tile& new_tile, double& homeless_num, double& unemployment_num,
+	std::vector<int>& changed_idx_vec)
+{
+	changed_idx_vec.clear();
+	if (!m_is_selected)
+		return;
 
-	// Traverse each position within the rectangle boundary of the map.
-	for (int y = start_pos.y; y <= end_pos.y; ++y)
-		for (int x = start_pos.x; x <= end_pos.x; ++x)
+	for (int y = m_selected_start_pos.y; y <= m_selected_end_pos.y; ++y)
+		for (int x = m_selected_start_pos.x; x <= m_selected_end_pos.x; ++x)
 		{
-			// Mark each selected tile object's condition to 1(selected) first.
-			m_selected_tiles_condition_vec[y * m_width + x] = TILE_SELECTED_FLAG;
-			// Increment the selected tiles' number first.
-			++m_selected_tiles_num;
-
-			// Iterate through each invalid tile type(should not be selected/de-selected).
-			for (const auto& tile_type : blacklist_vec)
-				// Check if current selected tile has an invalid type to be selected/de-selected.
-				if (m_tiles_vec[y * m_width + x].m_tileType == tile_type)
-				{
-					// Set related selected tile's condition and decrement the selected tiles' number.
-					m_selected_tiles_condition_vec[y * m_width + x] = TILE_INVALID_FLAG;
-					--m_selected_tiles_num;
-					break;
-				}
+			// Skip tiles which are invalid to be selected.
+			const int idx = y * static_cast<int>(m_width) + x;
+			Tile& curr_tile = m_tiles_vec[idx];
+			if (m_select_blacklist_mask & (1u << static_cast<unsigned int>(curr_tile.m_tileType)))
+				continue;
+
+			// Residential tiles' population become homeless, others' population become unemployed.
+			if (curr_tile.m_tileType == TileTypeEnum::RESIDENTIAL)
+				homeless_num += curr_tile.m_population;
+			else if (curr_tile.m_tileType == TileTypeEnum::INDUSTRIAL ||
+				curr_tile.m_tileType == TileTypeEnum::COMMERCIAL)
+				unemployment_num += curr_tile.m_population;
+
+			// Replace the original Tile with the new one.
+			curr_tile = new_tile;
+			changed_idx_vec.push_back(idx);
+			this->mark_tile_changed(idx);
 		}
+
+	if (!changed_idx_vec.empty())
+		this->mark_grass_sums_dirty(m_selected_start_pos, m_selected_end_pos);
 }
 
-void Map::deselect_tiles()
+sf::Vector2i Map::get_selected_start_pos() const
 {
-	// De-select each tile and reset the selected tiles' number to zero.
-	for (auto& val : m_selected_tiles_condition_vec)
-		val = 0;
-	m_selected_tiles_num = 0;
+	return m_selected_start_pos;
+}
+
+sf::Vector2i Map::get_selected_end_pos() const
+{
+	return m_selected_end_pos;
 }
 
 unsigned int Map::get_width() const
@@ -399,7 +556,17 @@ void Map::set_tile_half_width(unsigned int tile_half_width)
 
 char Map::get_selected_tile_condition(int idx) const
 {
-	return m_selected_tiles_condition_vec[idx];
+	// Tiles outside the selected rectangle are de-selected.
+	const int x = idx % static_cast<int>(m_width);
+	const int y = idx / static_cast<int>(m_width);
+	if (!m_is_selected || x < m_selected_start_pos.x || x > m_selected_end_pos.x || y < m_selected_start_pos.y ||
+		y > m_selected_end_pos.y)
+		return TILE_NOT_SELECTED_FLAG;
+
+	// Tiles inside it are invalid if their types are in the blacklist.
+	if (m_select_blacklist_mask & (1u << static_cast<unsigned int>(m_tiles_vec[idx].m_tileType)))
+		return TILE_INVALID_FLAG;
+	return TILE_SELECTED_FLAG;
 }
 
 Tile Map::get_tile(int idx) const
@@ -411,9 +578,20 @@ Tile& Map::get_tile_ref(int idx)
 	return m_tiles_vec[idx];
 }
 
+const Tile& Map::get_tile_ref(int idx) const
+{
+	return m_tiles_vec[idx];
+}
+
 void Map::set_tile(int idx, const Tile& new_tile)
 {
+	if (m_tiles_vec[idx].m_tileType != new_tile.m_tileType)
+	{
+		const sf::Vector2i pos(idx % static_cast<int>(m_width), idx / static_cast<int>(m_width));
+		this->mark_grass_sums_dirty(pos, pos);
+	}
 	m_tiles_vec[idx] = new_tile;
+	this->mark_tile_changed(idx);
 }
 
 unsigned int Map::get_tiles_amount() const
@@ -428,7 +606,11 @@ unsigned int Map::get_tile_resource(int idx) const
 
 void Map::decrement_tile_resource(int idx)
 {
-	--m_resource_vec[idx];
+	if (m_resource_vec[idx] > 0)
+	{
+		--m_resource_vec[idx];
+		this->mark_tile_changed(idx);
+	}
 }
 
 std::vector<Tile>& Map::get_tiles_vec_ref()
@@ -438,5 +620,188 @@ std::vector<Tile>& Map::get_tiles_vec_ref()
 
 unsigned int Map::get_selected_tiles_num() const
 {
-	return m_selected_tiles_num;
+	// Nothing is selected, or the rectangle is empty since a corner is clamped past the opposite one.
+	if (!m_is_selected || m_selected_start_pos.x > m_selected_end_pos.x || m_selected_start_pos.y >
+		m_selected_end_pos.y)
+		return 0;
+
+	/* Grass tiles are counted from the summed-area tables. The other types are either all selected or all invalid for
+	 * building and bulldozing, so they are the rest of the rectangle or none of it. */
+	const unsigned int grass_mask = 1u << static_cast<unsigned int>(TileTypeEnum::GRASS);
+	const std::uint32_t other_types_mask = ((1u << TILE_TYPES_NUM) - 1) & ~grass_mask;
+	const unsigned int grass_tiles_num = this->count_grass(m_selected_start_pos, m_selected_end_pos);
+	unsigned int selected_tiles_num = (m_select_blacklist_mask & grass_mask) ? 0 : grass_tiles_num;
+	if ((m_select_blacklist_mask & other_types_mask) == 0)
+		selected_tiles_num += (m_selected_end_pos.x - m_selected_start_pos.x + 1) * (m_selected_end_pos.y -
+			m_selected_start_pos.y + 1) - grass_tiles_num;
+	// Any other blacklist is counted tile by tile.
+	else if ((m_select_blacklist_mask & other_types_mask) != other_types_mask)
+		for (int y = m_selected_start_pos.y; y <= m_selected_end_pos.y; ++y)
+			for (int x = m_selected_start_pos.x; x <= m_selected_end_pos.x; ++x)
+			{
+				const unsigned int tile_mask = 1u << static_cast<unsigned int>(m_tiles_vec[y * m_width + x].m_tileType);
+				if (tile_mask != grass_mask && !(m_select_blacklist_mask & tile_mask))
+					++selected_tiles_num;
+			}
+	return selected_tiles_num;
+}
+
+void Map::clamp_rect(sf::Vector2i& start_pos, sf::Vector2i& end_pos) const
+{
+	// Ensure that start pos is always less than end pos on both axis.
+	if (start_pos.x > end_pos.x)
+		std::swap(start_pos.x, end_pos.x);
+	if (start_pos.y > end_pos.y)
+		std::swap(start_pos.y, end_pos.y);
+
+	// Clamp both start pos and end pos in range.
+	if (start_pos.x >= m_width)
+		start_pos.x = (m_width - 1);
+	else if (start_pos.x < 0)
+		start_pos.x = 0;
+	if (start_pos.y >= m_height)
+		start_pos.y = (m_height - 1);
+	else if (start_pos.y < 0)
+		start_pos.y = 0;
+
+	if (end_pos.x >= m_width)
+		end_pos.x = m_width - 1;
+	else if (end_pos.x < 0)
+		end_pos.x = 0;
+	if (end_pos.y >= m_height)
+		end_pos.y = m_height - 1;
+	else if (end_pos.y < 0)
+		end_pos.y = 0;
+}
+
+unsigned int Map::get_chunks_x_num() const
+{
+	return (m_width + MAP_CHUNK_SIZE - 1) / MAP_CHUNK_SIZE;
+}
+
+void Map::mark_grass_sums_dirty(const sf::Vector2i& start_pos, const sf::Vector2i& end_pos) const
+{
+	const unsigned int chunks_x_num = this->get_chunks_x_num();
+	for (unsigned int chunk_y = start_pos.y / MAP_CHUNK_SIZE; chunk_y <= end_pos.y / MAP_CHUNK_SIZE; ++chunk_y)
+		for (unsigned int chunk_x = start_pos.x / MAP_CHUNK_SIZE; chunk_x <= end_pos.x / MAP_CHUNK_SIZE; ++chunk_x)
+		{
+			const unsigned int chunk_idx = chunk_y * chunks_x_num + chunk_x;
+			if (m_is_grass_chunk_dirty_vec[chunk_idx])
+				continue;
+			m_is_grass_chunk_dirty_vec[chunk_idx] = 1;
+			m_dirty_grass_chunk_idx_vec.push_back(chunk_idx);
+		}
+}
+
+void Map::update_grass_sums() const
+{
+	if (m_dirty_grass_chunk_idx_vec.empty())
+		return;
+
+	// Rebuild only the changed chunks' tables, a placement costs as much as the chunks it touches.
+	const unsigned int chunks_x_num = this->get_chunks_x_num();
+	const unsigned int chunks_y_num = (m_height + MAP_CHUNK_SIZE - 1) / MAP_CHUNK_SIZE;
+	for (const auto chunk_idx : m_dirty_grass_chunk_idx_vec)
+	{
+		const unsigned int first_x = chunk_idx % chunks_x_num * MAP_CHUNK_SIZE;
+		const unsigned int first_y = chunk_idx / chunks_x_num * MAP_CHUNK_SIZE;
+		const unsigned int chunk_width = std::min(MAP_CHUNK_SIZE, m_width - first_x);
+		const unsigned int chunk_height = std::min(MAP_CHUNK_SIZE, m_height - first_y);
+		std::uint16_t* sums_ptr = &m_grass_sums_vec[static_cast<std::size_t>(chunk_idx) * MAP_CHUNK_SIZE *
+			MAP_CHUNK_SIZE];
+		for (unsigned int y = 0; y < chunk_height; ++y)
+		{
+			// Each entry is the amount in the row so far plus the entry right above it.
+			std::uint16_t row_sum{0};
+			for (unsigned int x = 0; x < chunk_width; ++x)
+			{
+				if (m_tiles_vec[(first_y + y) * m_width + first_x + x].m_tileType == TileTypeEnum::GRASS)
+					++row_sum;
+				sums_ptr[y * MAP_CHUNK_SIZE + x] = static_cast<std::uint16_t>(row_sum + (y > 0 ?
+					sums_ptr[(y - 1) * MAP_CHUNK_SIZE + x] : 0));
+			}
+		}
+		m_is_grass_chunk_dirty_vec[chunk_idx] = 0;
+	}
+	m_dirty_grass_chunk_idx_vec.clear();
+
+	/* The chunks' table has one entry per chunk, so it is cheap to rebuild from each chunk's total. Its first row and
+	 * column stay zero. */
+	m_chunk_grass_sums_vec.assign(static_cast<std::size_t>(chunks_x_num + 1) * (chunks_y_num + 1), 0);
+	for (unsigned int chunk_y = 0; chunk_y < chunks_y_num; ++chunk_y)
+	{
+		std::uint32_t row_sum{0};
+		for (unsigned int chunk_x = 0; chunk_x < chunks_x_num; ++chunk_x)
+		{
+			const unsigned int chunk_idx = chunk_y * chunks_x_num + chunk_x;
+			const unsigned int last_x = std::min(MAP_CHUNK_SIZE, m_width - chunk_x * MAP_CHUNK_SIZE) - 1;
+			const unsigned int last_y = std::min(MAP_CHUNK_SIZE, m_height - chunk_y * MAP_CHUNK_SIZE) - 1;
+			row_sum += m_grass_sums_vec[(static_cast<std::size_t>(chunk_idx) * MAP_CHUNK_SIZE + last_y) *
+				MAP_CHUNK_SIZE + last_x];
+			m_chunk_grass_sums_vec[(chunk_y + 1) * (chunks_x_num + 1) + chunk_x + 1] = row_sum +
+				m_chunk_grass_sums_vec[chunk_y * (chunks_x_num + 1) + chunk_x + 1];
+		}
+	}
+}
+
+unsigned int Map::count_grass(const sf::Vector2i& start_pos, const sf::Vector2i& end_pos) const
+{
+	this->update_grass_sums();
+	const int chunk_size = static_cast<int>(MAP_CHUNK_SIZE);
+	const int chunks_x_num = static_cast<int>(this->get_chunks_x_num());
+
+	// Inclusion-exclusion of the four corners' sums inside one chunk's table, local corners are inclusive.
+	const auto count_in_chunk = [this, chunk_size, chunks_x_num](int chunk_x, int chunk_y, int first_x, int first_y,
+		int last_x, int last_y)
+	{
+		const std::uint16_t* sums_ptr = &m_grass_sums_vec[static_cast<std::size_t>(chunk_y * chunks_x_num + chunk_x) *
+			chunk_size * chunk_size];
+		const auto get_sum = [sums_ptr, chunk_size](int x, int y)
+		{
+			return x < 0 || y < 0 ? 0u : static_cast<unsigned int>(sums_ptr[y * chunk_size + x]);
+		};
+		return get_sum(last_x, last_y) - get_sum(first_x - 1, last_y) - get_sum(last_x, first_y - 1) +
+			get_sum(first_x - 1, first_y - 1);
+	};
+
+	// Chunks fully inside the rectangle, whose last chunk may be cut by the map's border rather than the rectangle.
+	const int first_chunk_x = start_pos.x / chunk_size;
+	const int first_chunk_y = start_pos.y / chunk_size;
+	const int last_chunk_x = end_pos.x / chunk_size;
+	const int last_chunk_y = end_pos.y / chunk_size;
+	const int full_first_chunk_x = start_pos.x % chunk_size == 0 ? first_chunk_x : first_chunk_x + 1;
+	const int full_first_chunk_y = start_pos.y % chunk_size == 0 ? first_chunk_y : first_chunk_y + 1;
+	const int full_last_chunk_x = (end_pos.x + 1) % chunk_size == 0 || end_pos.x + 1 == static_cast<int>(m_width) ?
+		last_chunk_x : last_chunk_x - 1;
+	const int full_last_chunk_y = (end_pos.y + 1) % chunk_size == 0 || end_pos.y + 1 == static_cast<int>(m_height) ?
+		last_chunk_y : last_chunk_y - 1;
+	unsigned int grass_tiles_num{0};
+	if (full_first_chunk_x <= full_last_chunk_x && full_first_chunk_y <= full_last_chunk_y)
+	{
+		const auto get_sum = [this, chunks_x_num](int chunk_x, int chunk_y)
+		{
+			return m_chunk_grass_sums_vec[static_cast<std::size_t>(chunk_y) * (chunks_x_num + 1) + chunk_x];
+		};
+		grass_tiles_num += get_sum(full_last_chunk_x + 1, full_last_chunk_y + 1) - get_sum(full_first_chunk_x,
+			full_last_chunk_y + 1) - get_sum(full_last_chunk_x + 1, full_first_chunk_y) + get_sum(full_first_chunk_x,
+			full_first_chunk_y);
+	}
+
+	// Each chunk on the rectangle's border counts its own part, at most two per chunk row of the full ones.
+	for (int chunk_y = first_chunk_y; chunk_y <= last_chunk_y; ++chunk_y)
+	{
+		const bool is_full_row = chunk_y >= full_first_chunk_y && chunk_y <= full_last_chunk_y;
+		for (int chunk_x = first_chunk_x; chunk_x <= last_chunk_x; ++chunk_x)
+		{
+			if (is_full_row && chunk_x >= full_first_chunk_x && chunk_x <= full_last_chunk_x)
+			{
+				chunk_x = full_last_chunk_x;
+				continue;
+			}
+			grass_tiles_num += count_in_chunk(chunk_x, chunk_y, std::max(start_pos.x - chunk_x * chunk_size, 0),
+				std::max(start_pos.y - chunk_y * chunk_size, 0), std::min(end_pos.x - chunk_x * chunk_size,
+				chunk_size - 1), std::min(end_pos.y - chunk_y * chunk_size, chunk_size - 1));
+		}
+	}
+	return grass_tiles_num;
 }
\ No newline at end of file
@@ -0,0 +1,394 @@
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include "MapChunkFile.hpp"
+#include "Utility.hpp"
+
+namespace
+{
+	/**
+	 * Write the input value's bytes into the stream.
+	 * @param output_stream A reference of std::ostream indicates the stream to be written.
+	 * @param value A reference of const T indicates the value to be written.
+	 */
+	template<typename T>
+	void write_value(std::ostream& output_stream, const T& value)
+	{
+		output_stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+
+	/**
+	 * Read the input value's bytes from the stream.
+	 * @param input_stream A reference of std::istream indicates the stream to be read.
+	 * @param value A reference of T indicates the value to be filled.
+	 */
+	template<typename T>
+	void read_value(std::istream& input_stream, T& value)
+	{
+		input_stream.read(reinterpret_cast<char*>(&value), sizeof(T));
+	}
+}
+
+bool MapChunkFile::write(const std::string& map_path, unsigned int width, unsigned int height,
+	const std::vector<TileSnapshot>& tiles_vec, const std::vector<char>& city_record_vec)
+{
+	// Copy each chunk's rows out of the whole map.
+	return write(map_path, width, height, [&tiles_vec, width](unsigned int chunk_x, unsigned int chunk_y,
+		std::vector<TileSnapshot>& chunk_tiles_vec)
+	{
+		const unsigned int chunk_width = std::min(MAP_CHUNK_SIZE, width - chunk_x * MAP_CHUNK_SIZE);
+		const unsigned int chunk_height = static_cast<unsigned int>(chunk_tiles_vec.size()) / chunk_width;
+		for (unsigned int y = 0; y < chunk_height; ++y)
+		{
+			const auto row_begin = tiles_vec.begin() + (chunk_y * MAP_CHUNK_SIZE + y) * width + chunk_x * MAP_CHUNK_SIZE;
+			std::copy(row_begin, row_begin + chunk_width, chunk_tiles_vec.begin() + y * chunk_width);
+		}
+	}, city_record_vec);
+}
+
+bool MapChunkFile::write(const std::string& map_path, unsigned int width, unsigned int height,
+	const std::function<void(unsigned int, unsigned int, std::vector<TileSnapshot>&)>& fill_chunk_func,
+	const std::vector<char>& city_record_vec)
+{
+	// Open the temporary file in binary form to write.
+	const std::string temp_map_path(map_path + TEMP_FILE_SUFFIX);
+	std::ofstream output_file(temp_map_path, std::ios::binary | std::ios::out | std::ios::trunc);
+
+	/* The header stores the map's dimension, the chunk's size, the region aggregates' offset and the city's record, so
+	 * the city is read together with the chunk table. */
+	const unsigned int chunks_x_num = (width + MAP_CHUNK_SIZE - 1) / MAP_CHUNK_SIZE;
+	const unsigned int chunks_y_num = (height + MAP_CHUNK_SIZE - 1) / MAP_CHUNK_SIZE;
+	for (const std::uint32_t each_value : { MAP_CHUNK_FILE_MAGIC, MAP_CHUNK_FILE_VERSION, width, height, MAP_CHUNK_SIZE,
+											chunks_x_num, chunks_y_num })
+		write_value(output_file, each_value);
+	const auto regions_offset_pos = output_file.tellp();
+	write_value(output_file, std::uint64_t{0});
+	write_value(output_file, static_cast<std::uint32_t>(city_record_vec.size()));
+	output_file.write(city_record_vec.data(), city_record_vec.size());
+
+	// Reserve the chunk table, it is filled once all chunks' offsets are known.
+	const auto table_pos = output_file.tellp();
+	std::vector<ChunkEntry> entries_vec(chunks_x_num * chunks_y_num);
+	std::vector<ChunkSummary> summaries_vec(entries_vec.size());
+	const auto write_table = [&output_file, &entries_vec, &summaries_vec]()
+	{
+		for (std::size_t i = 0; i < entries_vec.size(); ++i)
+		{
+			write_value(output_file, entries_vec[i].m_offset);
+			write_value(output_file, entries_vec[i].m_size);
+			write_value(output_file, static_cast<std::uint32_t>(summaries_vec[i].m_region_aggregates_vec.size()));
+			write_value(output_file, summaries_vec[i].m_tile_type_num_arr);
+			write_value(output_file, summaries_vec[i].m_population);
+			write_value(output_file, summaries_vec[i].m_total_production);
+			write_value(output_file, summaries_vec[i].m_resource);
+		}
+	};
+	write_table();
+
+	// Then store each chunk's tiles in chunk row order.
+	std::vector<TileSnapshot> chunk_tiles_vec;
+	for (unsigned int chunk_y = 0; chunk_y < chunks_y_num; ++chunk_y)
+	{
+		for (unsigned int chunk_x = 0; chunk_x < chunks_x_num; ++chunk_x)
+		{
+			const unsigned int chunk_idx = chunk_y * chunks_x_num + chunk_x;
+			chunk_tiles_vec.assign(std::min(MAP_CHUNK_SIZE, width - chunk_x * MAP_CHUNK_SIZE) *
+				std::min(MAP_CHUNK_SIZE, height - chunk_y * MAP_CHUNK_SIZE), TileSnapshot());
+			fill_chunk_func(chunk_x, chunk_y, chunk_tiles_vec);
+			summarize(chunk_tiles_vec, summaries_vec[chunk_idx]);
+
+			entries_vec[chunk_idx].m_offset = static_cast<std::uint64_t>(output_file.tellp());
+			write_tiles(output_file, chunk_tiles_vec);
+			entries_vec[chunk_idx].m_size = static_cast<std::uint32_t>(static_cast<std::uint64_t>(output_file.tellp()) -
+				entries_vec[chunk_idx].m_offset);
+		}
+	}
+
+	// Store all chunks' region aggregates together, so opening the file reads them in one pass.
+	const std::uint64_t regions_offset = static_cast<std::uint64_t>(output_file.tellp());
+	for (const auto& each_summary : summaries_vec)
+	{
+		for (const auto& each_aggregate : each_summary.m_region_aggregates_vec)
+		{
+			write_value(output_file, static_cast<std::uint32_t>(each_aggregate.m_region_id));
+			write_value(output_file, each_aggregate.m_tiles_num);
+			write_value(output_file, each_aggregate.m_population);
+			write_value(output_file, each_aggregate.m_total_production);
+			write_value(output_file, each_aggregate.m_resource);
+		}
+	}
+	output_file.seekp(regions_offset_pos);
+	write_value(output_file, regions_offset);
+	output_file.seekp(table_pos);
+	write_table();
+
+	// Close the file and check if everything has been written.
+	output_file.close();
+	if (output_file.fail())
+	{
+		std::cerr << "Error, failed to write game map file " << temp_map_path << '\n';
+		return false;
+	}
+	return CitySnapshot::commit_file(temp_map_path, map_path);
+}
+
+bool MapChunkFile::load(const std::string& map_path, unsigned int width, unsigned int height,
+	std::vector<TileSnapshot>& tiles_vec)
+{
+	if (!is_chunk_file(map_path))
+	{
+		std::ifstream input_file(map_path, std::ios::in | std::ios::binary);
+		if (input_file.fail())
+			return false;
+
+		/* Files saved by old versions store all tiles in map order without a header. Their resource plane may also be
+		 * missing, in which case tiles keep the initial resource. */
+		tiles_vec.assign(width * height, TileSnapshot());
+		if (!read_tiles(input_file, tiles_vec, false))
+		{
+			for (auto& each_tile : tiles_vec)
+				each_tile.m_resource = EACH_TILE_PRODUCTION;
+		}
+		return true;
+	}
+
+	MapChunkFile chunk_file;
+	if (!chunk_file.open(map_path))
+		return false;
+	if (chunk_file.get_width() != width || chunk_file.get_height() != height)
+	{
+		std::cerr << "Error, game map file " << map_path << " is " << chunk_file.get_width() << "x" <<
+		chunk_file.get_height() << " but the city is " << width << "x" << height << '\n';
+		return false;
+	}
+	return chunk_file.read_all(tiles_vec);
+}
+
+void MapChunkFile::write_tiles(std::ostream& output_stream, const std::vector<TileSnapshot>& tiles_vec)
+{
+	for (const auto& each_tile : tiles_vec)
+	{
+		write_value(output_stream, each_tile.m_tileType);
+		write_value(output_stream, each_tile.m_level);
+		write_value(output_stream, each_tile.m_region_arr[0]);
+		write_value(output_stream, each_tile.m_population);
+		write_value(output_stream, each_tile.m_total_production);
+	}
+	for (const auto& each_tile : tiles_vec)
+		write_value(output_stream, each_tile.m_resource);
+	for (const auto& each_tile : tiles_vec)
+		write_value(output_stream, each_tile.m_production_per_day);
+}
+
+bool MapChunkFile::read_tiles(std::istream& input_stream, std::vector<TileSnapshot>& tiles_vec,
+	bool is_production_saved)
+{
+	for (auto& each_tile : tiles_vec)
+	{
+		read_value(input_stream, each_tile.m_tileType);
+		read_value(input_stream, each_tile.m_level);
+		read_value(input_stream, each_tile.m_region_arr[0]);
+		read_value(input_stream, each_tile.m_population);
+		read_value(input_stream, each_tile.m_total_production);
+	}
+	std::vector<std::uint8_t> resource_vec(tiles_vec.size());
+	if (!input_stream.read(reinterpret_cast<char*>(resource_vec.data()), resource_vec.size()))
+		return false;
+	for (std::size_t i = 0; i < tiles_vec.size(); ++i)
+		tiles_vec[i].m_resource = resource_vec[i];
+	if (is_production_saved)
+		for (auto& each_tile : tiles_vec)
+			read_value(input_stream, each_tile.m_production_per_day);
+	return static_cast<bool>(input_stream);
+}
+
+bool MapChunkFile::is_chunk_file(const std::string& map_path)
+{
+	std::ifstream input_file(map_path, std::ios::in | std::ios::binary);
+	std::uint32_t magic{0};
+	read_value(input_file, magic);
+	return input_file && magic == MAP_CHUNK_FILE_MAGIC;
+}
+
+void MapChunkFile::summarize(const std::vector<TileSnapshot>& chunk_tiles_vec, ChunkSummary& summary)
+{
+	summary = ChunkSummary();
+	// Sum tiles of each region in region id order.
+	std::map<unsigned int, RegionAggregate> region_aggregates_map;
+	for (const auto& each_tile : chunk_tiles_vec)
+	{
+		const auto type_idx = static_cast<std::size_t>(each_tile.m_tileType);
+		if (type_idx < sizeof(summary.m_tile_type_num_arr) / sizeof(summary.m_tile_type_num_arr[0]))
+			++summary.m_tile_type_num_arr[type_idx];
+		summary.m_population += each_tile.m_population;
+		summary.m_total_production += each_tile.m_total_production;
+		summary.m_resource += each_tile.m_resource;
+
+		// Region id 0 means the tile is not inside any region.
+		if (each_tile.m_region_arr[0] == 0)
+			continue;
+		RegionAggregate& aggregate = region_aggregates_map[each_tile.m_region_arr[0]];
+		aggregate.m_region_id = each_tile.m_region_arr[0];
+		++aggregate.m_tiles_num;
+		aggregate.m_population += each_tile.m_population;
+		aggregate.m_total_production += each_tile.m_total_production;
+		aggregate.m_resource += each_tile.m_resource;
+	}
+	for (const auto& each_pair : region_aggregates_map)
+		summary.m_region_aggregates_vec.push_back(each_pair.second);
+}
+
+bool MapChunkFile::open(const std::string& map_path)
+{
+	m_input_file.close();
+	m_input_file.clear();
+	m_city_record_vec.clear();
+	m_entries_vec.clear();
+	m_summaries_vec.clear();
+	m_input_file.open(map_path, std::ios::in | std::ios::binary);
+
+	// Check the header.
+	std::uint32_t header_arr[7]{};
+	std::uint64_t regions_offset{0};
+	read_value(m_input_file, header_arr);
+	read_value(m_input_file, regions_offset);
+	if (!m_input_file || header_arr[0] != MAP_CHUNK_FILE_MAGIC || header_arr[1] == 0 ||
+		header_arr[1] > MAP_CHUNK_FILE_VERSION ||
+		header_arr[4] == 0 || header_arr[5] != (header_arr[2] + header_arr[4] - 1) / header_arr[4] ||
+		header_arr[6] != (header_arr[3] + header_arr[4] - 1) / header_arr[4])
+	{
+		std::cerr << "Error, invalid chunked game map file " << map_path << '\n';
+		m_input_file.close();
+		return false;
+	}
+	m_version = header_arr[1];
+	m_width = header_arr[2];
+	m_height = header_arr[3];
+	m_chunk_size = header_arr[4];
+	m_chunks_x_num = header_arr[5];
+	m_chunks_y_num = header_arr[6];
+
+	// Files of version 1 do not hold the city's record.
+	if (header_arr[1] >= 2)
+	{
+		std::uint32_t city_record_size{0};
+		read_value(m_input_file, city_record_size);
+		m_city_record_vec.resize(city_record_size);
+		m_input_file.read(m_city_record_vec.data(), m_city_record_vec.size());
+	}
+
+	// Read the chunk table and then all region aggregates.
+	m_entries_vec.resize(m_chunks_x_num * m_chunks_y_num);
+	m_summaries_vec.resize(m_entries_vec.size());
+	std::vector<std::uint32_t> regions_num_vec(m_entries_vec.size());
+	for (std::size_t i = 0; i < m_entries_vec.size(); ++i)
+	{
+		read_value(m_input_file, m_entries_vec[i].m_offset);
+		read_value(m_input_file, m_entries_vec[i].m_size);
+		read_value(m_input_file, regions_num_vec[i]);
+		read_value(m_input_file, m_summaries_vec[i].m_tile_type_num_arr);
+		read_value(m_input_file, m_summaries_vec[i].m_population);
+		read_value(m_input_file, m_summaries_vec[i].m_total_production);
+		read_value(m_input_file, m_summaries_vec[i].m_resource);
+	}
+	m_input_file.seekg(static_cast<std::streamoff>(regions_offset));
+	for (std::size_t i = 0; i < m_entries_vec.size(); ++i)
+	{
+		m_summaries_vec[i].m_region_aggregates_vec.resize(regions_num_vec[i]);
+		for (auto& each_aggregate : m_summaries_vec[i].m_region_aggregates_vec)
+		{
+			std::uint32_t region_id{0};
+			read_value(m_input_file, region_id);
+			each_aggregate.m_region_id = region_id;
+			read_value(m_input_file, each_aggregate.m_tiles_num);
+			read_value(m_input_file, each_aggregate.m_population);
+			read_value(m_input_file, each_aggregate.m_total_production);
+			read_value(m_input_file, each_aggregate.m_resource);
+		}
+	}
+	if (!m_input_file)
+	{
+		std::cerr << "Error, truncated chunk table in game map file " << map_path << '\n';
+		m_input_file.close();
+		return false;
+	}
+	return true;
+}
+
+bool MapChunkFile::is_open() const
+{
+	return m_input_file.is_open();
+}
+
+unsigned int MapChunkFile::get_width() const
+{
+	return m_width;
+}
+
+unsigned int MapChunkFile::get_height() const
+{
+	return m_height;
+}
+
+unsigned int MapChunkFile::get_chunks_x_num() const
+{
+	return m_chunks_x_num;
+}
+
+unsigned int MapChunkFile::get_chunks_y_num() const
+{
+	return m_chunks_y_num;
+}
+
+sf::Vector2u MapChunkFile::get_chunk_size(unsigned int chunk_idx) const
+{
+	const unsigned int chunk_x = chunk_idx % m_chunks_x_num;
+	const unsigned int chunk_y = chunk_idx / m_chunks_x_num;
+	return sf::Vector2u(std::min(m_chunk_size, m_width - chunk_x * m_chunk_size),
+		std::min(m_chunk_size, m_height - chunk_y * m_chunk_size));
+}
+
+const ChunkSummary& MapChunkFile::get_summary(unsigned int chunk_idx) const
+{
+	return m_summaries_vec.at(chunk_idx);
+}
+
+const std::vector<char>& MapChunkFile::get_city_record() const
+{
+	return m_city_record_vec;
+}
+
+bool MapChunkFile::read_all(std::vector<TileSnapshot>& tiles_vec)
+{
+	// Scatter each chunk's rows into the whole map.
+	tiles_vec.resize(m_width * m_height);
+	std::vector<TileSnapshot> chunk_tiles_vec;
+	for (unsigned int chunk_idx = 0; chunk_idx < m_entries_vec.size(); ++chunk_idx)
+	{
+		if (!this->read_chunk(chunk_idx, chunk_tiles_vec))
+			return false;
+		const sf::Vector2u chunk_size = this->get_chunk_size(chunk_idx);
+		const unsigned int origin_x = chunk_idx % m_chunks_x_num * m_chunk_size;
+		const unsigned int origin_y = chunk_idx / m_chunks_x_num * m_chunk_size;
+		for (unsigned int y = 0; y < chunk_size.y; ++y)
+		{
+			const auto row_begin = chunk_tiles_vec.begin() + y * chunk_size.x;
+			std::copy(row_begin, row_begin + chunk_size.x, tiles_vec.begin() + (origin_y + y) * m_width + origin_x);
+		}
+	}
+	return true;
+}
+
+bool MapChunkFile::read_chunk(unsigned int chunk_idx, std::vector<TileSnapshot>& chunk_tiles_vec)
+{
+	const sf::Vector2u chunk_size = this->get_chunk_size(chunk_idx);
+	chunk_tiles_vec.resize(chunk_size.x * chunk_size.y);
+	m_input_file.clear();
+	m_input_file.seekg(static_cast<std::streamoff>(m_entries_vec.at(chunk_idx).m_offset));
+	if (!read_tiles(m_input_file, chunk_tiles_vec, m_version >= 3))
+	{
+		std::cerr << "Error, failed to read chunk " << chunk_idx << " of the game map file\n";
+		return false;
+	}
+	return true;
+}
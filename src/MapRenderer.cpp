@@ -0,0 +1,79 @@
+#include <algorithm>
+#include <cmath>
+#include "MapRenderer.hpp"
+#include "Map.hpp"
+#include "Profiler.hpp"
+#include "RenderUtility.hpp"
+
+void MapRenderer::add_tile(TileTypeEnum tile_type, unsigned int tile_half_width_pixel, unsigned int tile_height_num,
+	sf::Texture& texture, const std::vector<Animation>& animation_vec)
+{
+	/* Since one texture contains at most 4 tiles, we need to set up the top left point of the current tile sprite
+	 * according to the whole texture.*/
+	sf::Sprite& sprite = m_sprite_arr[static_cast<unsigned int>(tile_type)];
+	sprite.setOrigin(sf::Vector2f(0.f, (tile_height_num - 1) * tile_half_width_pixel));
+	sprite.setTexture(texture);
+
+	// Set up animation handler's m_each_frame_size_rect(we only care about width and height here).
+	AnimationHandler& animationHandler = m_animationHandler_arr[static_cast<unsigned int>(tile_type)];
+	animationHandler = AnimationHandler(sf::IntRect(0, 0, 2 * tile_half_width_pixel,
+		tile_half_width_pixel * tile_height_num));
+
+	// Store all tile related animation.
+	for (auto each_anim : animation_vec)
+		animationHandler.addAnim(each_anim);
+	// Reset animation handler's elapsed time to 0.
+	animationHandler.update(0.f);
+}
+
+void MapRenderer::render(sf::RenderWindow& render_window, const Map& map, float dt)
+{
+	PROFILE_SCOPE("MapRenderer::render");
+	const unsigned int width = map.get_width();
+	const unsigned int height = map.get_height();
+	const unsigned int tile_half_width_pixel = map.get_tile_half_width();
+
+	/* Only visit tiles overlapping the view, so large maps cost as much as the visible part. Each tile's sprite spans
+	 * two half widths to the right of its position, and at most one half width above and below it. Inverse the
+	 * position formula below to get the visible range of (x - y) and (x + y). */
+	const sf::View& view = render_window.getView();
+	const sf::Vector2f view_top_left(view.getCenter() - view.getSize() * 0.5f);
+	const sf::Vector2f view_bottom_right(view.getCenter() + view.getSize() * 0.5f);
+	const float tile_half_width = static_cast<float>(tile_half_width_pixel);
+	const int min_diff = static_cast<int>(std::floor(view_top_left.x / tile_half_width)) - static_cast<int>(width) - 2;
+	const int max_diff = static_cast<int>(std::ceil(view_bottom_right.x / tile_half_width)) - static_cast<int>(width);
+	const int min_sum = static_cast<int>(std::floor(view_top_left.y * 2.f / tile_half_width)) - 2;
+	const int max_sum = static_cast<int>(std::ceil(view_bottom_right.y * 2.f / tile_half_width)) + 2;
+
+	// Iterate horizontally and then vertically to render each isometric tile.
+	for (int y = 0; y < static_cast<int>(height); ++y)
+	{
+		const int start_x = std::max(0, std::max(min_diff + y, min_sum - y));
+		const int end_x = std::min(static_cast<int>(width) - 1, std::min(max_diff + y, max_sum - y));
+		for (int x = start_x; x <= end_x; ++x)
+		{
+			const Tile& tile = map.get_tile_ref(y * static_cast<int>(width) + x);
+			sf::Sprite& sprite = m_sprite_arr[static_cast<unsigned int>(tile.m_tileType)];
+			AnimationHandler& animationHandler = m_animationHandler_arr[static_cast<unsigned int>(tile.m_tileType)];
+
+			// Get each isometric tile's position(tile coordinate to screen coordinate).
+			sprite.setPosition(sf::Vector2f(tile_half_width_pixel * (x - y) + width * tile_half_width_pixel,
+				tile_half_width_pixel * (x + y) * 0.5));
+
+			// If current tile is selected, set its color to be dark, white color otherwise.
+			if (map.get_selected_tile_condition(y * static_cast<int>(width) + x) == TILE_SELECTED_FLAG)
+				sprite.setColor(TILE_SELECTED_COLOR);
+			else
+				sprite.setColor(sf::Color::White);
+
+			// Switch to current tile object's animation.
+			animationHandler.changeAnim(tile.m_level);
+			// Update the current frame of animation.
+			animationHandler.update(dt);
+			// Set new current frame of animation's texture rect.
+			sprite.setTextureRect(animationHandler.get_each_frame_texture_rect());
+			// Draw current tile sprite on the render window.
+			render_window.draw(sprite);
+		}
+	}
+}
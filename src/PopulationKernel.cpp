@@ -0,0 +1,164 @@
+#include "PopulationKernel.hpp"
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define POPULATION_KERNEL_X86
+#include <immintrin.h>
+#endif
+
+namespace
+{
+	/**
+	 * The scalar kernel, also used for the tiles after the last full group of lanes.
+	 * @param population_arr A pointer of double indicates the tiles' populations, updated in place.
+	 * @param limit_arr A pointer of const double indicates the tiles' population limits.
+	 * @param tiles_num A std::size_t indicates the amount of tiles.
+	 * @param rate A double indicates the growth rate.
+	 * @param overflow_lane_arr A pointer of double indicates each lane's overflow sum.
+	 * @param population_lane_arr A pointer of double indicates each lane's population sum.
+	 */
+	void grow_and_clamp_scalar(double* population_arr, const double* limit_arr, std::size_t tiles_num, double rate,
+		double* overflow_lane_arr, double* population_lane_arr)
+	{
+		for (std::size_t i = 0; i < tiles_num; ++i)
+		{
+			double population = population_arr[i];
+			population += population * rate;
+			const double overflow = population > limit_arr[i] ? population - limit_arr[i] : 0.0;
+			population = population > limit_arr[i] ? limit_arr[i] : population;
+			population_arr[i] = population;
+			overflow_lane_arr[i % POPULATION_KERNEL_LANES_NUM] += overflow;
+			population_lane_arr[i % POPULATION_KERNEL_LANES_NUM] += population;
+		}
+	}
+
+#ifdef POPULATION_KERNEL_X86
+	/**
+	 * The SSE2 kernel, two registers hold the four lanes.
+	 * @return A std::size_t indicates the amount of tiles processed, a multiple of the lanes' amount.
+	 */
+	__attribute__((target("sse2")))
+	std::size_t grow_and_clamp_sse2(double* population_arr, const double* limit_arr, std::size_t tiles_num,
+		double rate, double* overflow_lane_arr, double* population_lane_arr)
+	{
+		const __m128d rate_vec = _mm_set1_pd(rate);
+		__m128d overflow_lo = _mm_loadu_pd(overflow_lane_arr);
+		__m128d overflow_hi = _mm_loadu_pd(overflow_lane_arr + 2);
+		__m128d population_sum_lo = _mm_loadu_pd(population_lane_arr);
+		__m128d population_sum_hi = _mm_loadu_pd(population_lane_arr + 2);
+		std::size_t i = 0;
+		for (; i + POPULATION_KERNEL_LANES_NUM <= tiles_num; i += POPULATION_KERNEL_LANES_NUM)
+		{
+			__m128d population_lo = _mm_loadu_pd(population_arr + i);
+			__m128d population_hi = _mm_loadu_pd(population_arr + i + 2);
+			const __m128d limit_lo = _mm_loadu_pd(limit_arr + i);
+			const __m128d limit_hi = _mm_loadu_pd(limit_arr + i + 2);
+			population_lo = _mm_add_pd(population_lo, _mm_mul_pd(population_lo, rate_vec));
+			population_hi = _mm_add_pd(population_hi, _mm_mul_pd(population_hi, rate_vec));
+			// Keep the difference only where the population exceeds the limit.
+			overflow_lo = _mm_add_pd(overflow_lo, _mm_and_pd(_mm_cmpgt_pd(population_lo, limit_lo),
+				_mm_sub_pd(population_lo, limit_lo)));
+			overflow_hi = _mm_add_pd(overflow_hi, _mm_and_pd(_mm_cmpgt_pd(population_hi, limit_hi),
+				_mm_sub_pd(population_hi, limit_hi)));
+			population_lo = _mm_min_pd(population_lo, limit_lo);
+			population_hi = _mm_min_pd(population_hi, limit_hi);
+			_mm_storeu_pd(population_arr + i, population_lo);
+			_mm_storeu_pd(population_arr + i + 2, population_hi);
+			population_sum_lo = _mm_add_pd(population_sum_lo, population_lo);
+			population_sum_hi = _mm_add_pd(population_sum_hi, population_hi);
+		}
+		_mm_storeu_pd(overflow_lane_arr, overflow_lo);
+		_mm_storeu_pd(overflow_lane_arr + 2, overflow_hi);
+		_mm_storeu_pd(population_lane_arr, population_sum_lo);
+		_mm_storeu_pd(population_lane_arr + 2, population_sum_hi);
+		return i;
+	}
+
+	/**
+	 * The AVX2 kernel, one register holds the four lanes.
+	 * @return A std::size_t indicates the amount of tiles processed, a multiple of the lanes' amount.
+	 */
+	__attribute__((target("avx2")))
+	std::size_t grow_and_clamp_avx2(double* population_arr, const double* limit_arr, std::size_t tiles_num,
+		double rate, double* overflow_lane_arr, double* population_lane_arr)
+	{
+		const __m256d rate_vec = _mm256_set1_pd(rate);
+		__m256d overflow_sum = _mm256_loadu_pd(overflow_lane_arr);
+		__m256d population_sum = _mm256_loadu_pd(population_lane_arr);
+		std::size_t i = 0;
+		for (; i + POPULATION_KERNEL_LANES_NUM <= tiles_num; i += POPULATION_KERNEL_LANES_NUM)
+		{
+			__m256d population = _mm256_loadu_pd(population_arr + i);
+			const __m256d limit = _mm256_loadu_pd(limit_arr + i);
+			// Multiply and add separately, a fused multiply-add would round differently from the scalar kernel.
+			population = _mm256_add_pd(population, _mm256_mul_pd(population, rate_vec));
+			overflow_sum = _mm256_add_pd(overflow_sum, _mm256_and_pd(_mm256_cmp_pd(population, limit, _CMP_GT_OQ),
+				_mm256_sub_pd(population, limit)));
+			population = _mm256_min_pd(population, limit);
+			_mm256_storeu_pd(population_arr + i, population);
+			population_sum = _mm256_add_pd(population_sum, population);
+		}
+		_mm256_storeu_pd(overflow_lane_arr, overflow_sum);
+		_mm256_storeu_pd(population_lane_arr, population_sum);
+		return i;
+	}
+#endif
+}
+
+SimdLevelEnum get_simd_level()
+{
+#ifdef POPULATION_KERNEL_X86
+	static const SimdLevelEnum simd_level = []()
+	{
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("avx2"))
+			return SimdLevelEnum::AVX2;
+		if (__builtin_cpu_supports("sse2"))
+			return SimdLevelEnum::SSE2;
+		return SimdLevelEnum::SCALAR;
+	}();
+	return simd_level;
+#else
+	return SimdLevelEnum::SCALAR;
+#endif
+}
+
+const char* simdLevelToStr(SimdLevelEnum simd_level)
+{
+	switch (simd_level)
+	{
+	case SimdLevelEnum::AVX2:
+		return "avx2";
+	case SimdLevelEnum::SSE2:
+		return "sse2";
+	default:
+		return "scalar";
+	}
+}
+
+void grow_and_clamp_populations(double* population_arr, const double* limit_arr, std::size_t tiles_num, double rate,
+	double& overflow_ref, double& total_population_ref, SimdLevelEnum simd_level)
+{
+	// Never use an instruction set wider than the CPU supports.
+	if (static_cast<int>(simd_level) > static_cast<int>(get_simd_level()))
+		simd_level = get_simd_level();
+
+	double overflow_lane_arr[POPULATION_KERNEL_LANES_NUM]{};
+	double population_lane_arr[POPULATION_KERNEL_LANES_NUM]{};
+	std::size_t processed_num{0};
+#ifdef POPULATION_KERNEL_X86
+	if (simd_level == SimdLevelEnum::AVX2)
+		processed_num = grow_and_clamp_avx2(population_arr, limit_arr, tiles_num, rate, overflow_lane_arr,
+			population_lane_arr);
+	else if (simd_level == SimdLevelEnum::SSE2)
+		processed_num = grow_and_clamp_sse2(population_arr, limit_arr, tiles_num, rate, overflow_lane_arr,
+			population_lane_arr);
+#endif
+	// The scalar kernel takes the remaining tiles, which still lands each tile in the lane of its index.
+	grow_and_clamp_scalar(population_arr + processed_num, limit_arr + processed_num, tiles_num - processed_num, rate,
+		overflow_lane_arr, population_lane_arr);
+
+	// Combine the lanes pairwise, the same way for every instruction set.
+	overflow_ref += (overflow_lane_arr[0] + overflow_lane_arr[1]) + (overflow_lane_arr[2] + overflow_lane_arr[3]);
+	total_population_ref += (population_lane_arr[0] + population_lane_arr[1]) + (population_lane_arr[2] +
+		population_lane_arr[3]);
+}
@@ -0,0 +1,136 @@
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include "Profiler.hpp"
+#include "Utility.hpp"
+
+namespace
+{
+	// When the profiler starts, all events' times are relative to it.
+	const std::chrono::steady_clock::time_point PROFILER_START_TIME(std::chrono::steady_clock::now());
+
+	/**
+	 * Retrieve all threads' ring buffers. They are never destroyed, so events of exited threads can still be dumped.
+	 * @return A reference of vector indicates the ring buffers.
+	 */
+	std::vector<std::unique_ptr<ProfileRingBuffer>>& get_ring_buffers()
+	{
+		static std::vector<std::unique_ptr<ProfileRingBuffer>> ring_buffers_vec;
+		return ring_buffers_vec;
+	}
+
+	/**
+	 * Retrieve the mutex which guards the ring buffers' vector. It is only locked when a thread records its first
+	 * event and when dumping.
+	 * @return A reference of mutex.
+	 */
+	std::mutex& get_ring_buffers_mutex()
+	{
+		static std::mutex ring_buffers_mutex;
+		return ring_buffers_mutex;
+	}
+
+	/**
+	 * Write the input string as a JSON string.
+	 * @param output_stream A reference of std::ostream indicates the stream to be written.
+	 * @param str A pointer of const char indicates the string.
+	 */
+	void write_json_string(std::ostream& output_stream, const char* str)
+	{
+		output_stream << '"';
+		for (; *str != '\0'; ++str)
+		{
+			if (*str == '"' || *str == '\\')
+				output_stream << '\\';
+			output_stream << *str;
+		}
+		output_stream << '"';
+	}
+}
+
+ProfileRingBuffer::ProfileRingBuffer(unsigned int thread_idx) : m_thread_idx(thread_idx),
+	m_events_vec(PROFILE_RING_BUFFER_EVENTS_NUM)
+{
+}
+
+void ProfileRingBuffer::push(const ProfileEvent& event)
+{
+	const std::uint64_t head = m_head.load(std::memory_order_relaxed);
+	m_events_vec[head % m_events_vec.size()] = event;
+	m_head.store(head + 1, std::memory_order_release);
+}
+
+void ProfileRingBuffer::copy_events(std::vector<ProfileEvent>& events_vec) const
+{
+	const std::uint64_t head = m_head.load(std::memory_order_acquire);
+	const std::uint64_t events_num = std::min<std::uint64_t>(head, m_events_vec.size());
+	for (std::uint64_t i = head - events_num; i < head; ++i)
+		events_vec.push_back(m_events_vec[i % m_events_vec.size()]);
+}
+
+unsigned int ProfileRingBuffer::get_thread_idx() const
+{
+	return m_thread_idx;
+}
+
+std::uint64_t Profiler::now_ns()
+{
+	return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now() - PROFILER_START_TIME).count());
+}
+
+void Profiler::record(const char* name, std::uint64_t start_ns, std::uint64_t end_ns)
+{
+	// Each thread registers its own ring buffer on its first event.
+	thread_local ProfileRingBuffer* ring_buffer_ptr = nullptr;
+	if (ring_buffer_ptr == nullptr)
+	{
+		std::lock_guard<std::mutex> lock(get_ring_buffers_mutex());
+		auto& ring_buffers_vec = get_ring_buffers();
+		ring_buffers_vec.emplace_back(new ProfileRingBuffer(static_cast<unsigned int>(ring_buffers_vec.size())));
+		ring_buffer_ptr = ring_buffers_vec.back().get();
+	}
+	ring_buffer_ptr->push(ProfileEvent{ name, start_ns, end_ns - start_ns });
+}
+
+bool Profiler::dump(const std::string& trace_path)
+{
+	std::ofstream output_file(trace_path, std::ios::out | std::ios::trunc);
+	if (output_file.fail())
+	{
+		std::cerr << "Error, cannot create profile trace file " << trace_path << '\n';
+		return false;
+	}
+
+	// Write each event as a complete event, times are in microseconds.
+	output_file << std::fixed << std::setprecision(3) << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+	bool is_first_event{true};
+	std::vector<ProfileEvent> events_vec;
+	std::lock_guard<std::mutex> lock(get_ring_buffers_mutex());
+	for (const auto& each_ring_buffer : get_ring_buffers())
+	{
+		events_vec.clear();
+		each_ring_buffer->copy_events(events_vec);
+		for (const auto& each_event : events_vec)
+		{
+			output_file << (is_first_event ? "\n" : ",\n") << "{\"name\":";
+			write_json_string(output_file, each_event.m_name);
+			output_file << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << each_ring_buffer->get_thread_idx() << ",\"ts\":" <<
+				each_event.m_start_ns / 1000.0 << ",\"dur\":" << each_event.m_duration_ns / 1000.0 << '}';
+			is_first_event = false;
+		}
+	}
+	output_file << "\n]}\n";
+
+	output_file.close();
+	if (output_file.fail())
+	{
+		std::cerr << "Error, failed to write profile trace file " << trace_path << '\n';
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,154 @@
+#include <fstream>
+#include <iostream>
+#include "SaveSlot.hpp"
+#include "CitySnapshot.hpp"
+#include "Utility.hpp"
+
+SaveSlot::SaveSlot(unsigned int slot_idx) : m_idx(slot_idx)
+{
+	// Slot 0 keeps the old "city_*.dat" names, other slots are named "cityN_*.dat".
+	const std::string slot_prefix(SAVE_DIRECTORY_PATH + SAVE_SLOT_FILE_PREFIX + (m_idx == 0 ? "" :
+		std::to_string(m_idx)));
+	m_cfg_path = slot_prefix + SAVE_SLOT_CFG_SUFFIX;
+	m_map_path = slot_prefix + SAVE_SLOT_MAP_SUFFIX;
+	m_journal_path = slot_prefix + SAVE_SLOT_JOURNAL_SUFFIX;
+	m_header_path = slot_prefix + SAVE_SLOT_HEADER_SUFFIX;
+}
+
+unsigned int SaveSlot::get_idx() const
+{
+	return m_idx;
+}
+
+const std::string& SaveSlot::get_cfg_path() const
+{
+	return m_cfg_path;
+}
+
+const std::string& SaveSlot::get_map_path() const
+{
+	return m_map_path;
+}
+
+const std::string& SaveSlot::get_journal_path() const
+{
+	return m_journal_path;
+}
+
+const std::string& SaveSlot::get_header_path() const
+{
+	return m_header_path;
+}
+
+std::string SaveSlot::get_default_name() const
+{
+	return SAVE_SLOT_DEFAULT_NAME_STR + std::to_string(m_idx + 1);
+}
+
+bool SaveSlot::is_used() const
+{
+	return std::ifstream(m_map_path).is_open() || std::ifstream(m_cfg_path).is_open();
+}
+
+bool SaveSlot::read_header(SaveSlotHeader& header) const
+{
+	header = SaveSlotHeader();
+	header.m_slot_idx = m_idx;
+	header.m_name = this->get_default_name();
+
+	std::ifstream input_file(m_header_path, std::ios::in | std::ios::binary);
+	std::uint32_t prefix_arr[3]{ 0, 0, 0 };
+	if (!input_file.read(reinterpret_cast<char*>(prefix_arr), sizeof(prefix_arr)) ||
+		prefix_arr[0] != SAVE_SLOT_HEADER_MAGIC || prefix_arr[1] != SAVE_SLOT_HEADER_VERSION)
+	{
+		// Saves without a header file only have their game map file to tell that the slot is used.
+		return this->is_used();
+	}
+
+	// The name's length is followed by its characters and then the fixed size summary.
+	std::string name(prefix_arr[2], '\0');
+	std::uint32_t dimension_arr[3]{ 0, 0, 0 };
+	double stats_arr[2]{ 0, 0 };
+	std::vector<std::uint8_t> thumbnail_vec(SAVE_SLOT_THUMBNAIL_SIZE * SAVE_SLOT_THUMBNAIL_SIZE);
+	input_file.read(&name[0], name.size());
+	input_file.read(reinterpret_cast<char*>(dimension_arr), sizeof(dimension_arr));
+	input_file.read(reinterpret_cast<char*>(stats_arr), sizeof(stats_arr));
+	input_file.read(reinterpret_cast<char*>(thumbnail_vec.data()), thumbnail_vec.size());
+	if (!input_file)
+	{
+		std::cerr << "Error, truncated save slot header file " << m_header_path << '\n';
+		return this->is_used();
+	}
+
+	header.m_has_summary = true;
+	header.m_name = name;
+	header.m_day = dimension_arr[0];
+	header.m_width = dimension_arr[1];
+	header.m_height = dimension_arr[2];
+	header.m_population = stats_arr[0];
+	header.m_fund = stats_arr[1];
+	header.m_thumbnail_vec = std::move(thumbnail_vec);
+	return true;
+}
+
+bool SaveSlot::write_header(const CitySnapshot& snapshot) const
+{
+	// Sample the nearest tile of each thumbnail pixel.
+	std::vector<std::uint8_t> thumbnail_vec(SAVE_SLOT_THUMBNAIL_SIZE * SAVE_SLOT_THUMBNAIL_SIZE,
+		static_cast<std::uint8_t>(TileTypeEnum::VOID));
+	if (!snapshot.m_tiles_vec.empty())
+	{
+		for (unsigned int y = 0; y < SAVE_SLOT_THUMBNAIL_SIZE; ++y)
+		{
+			for (unsigned int x = 0; x < SAVE_SLOT_THUMBNAIL_SIZE; ++x)
+			{
+				const unsigned int tile_x = x * snapshot.m_width / SAVE_SLOT_THUMBNAIL_SIZE;
+				const unsigned int tile_y = y * snapshot.m_height / SAVE_SLOT_THUMBNAIL_SIZE;
+				thumbnail_vec[y * SAVE_SLOT_THUMBNAIL_SIZE + x] = static_cast<std::uint8_t>(
+					snapshot.m_tiles_vec[tile_y * snapshot.m_width + tile_x].m_tileType);
+			}
+		}
+	}
+
+	const std::string temp_header_path(m_header_path + TEMP_FILE_SUFFIX);
+	std::ofstream output_file(temp_header_path, std::ios::out | std::ios::binary | std::ios::trunc);
+	const std::uint32_t prefix_arr[3]{ SAVE_SLOT_HEADER_MAGIC, SAVE_SLOT_HEADER_VERSION,
+									   static_cast<std::uint32_t>(snapshot.m_name.size()) };
+	const std::uint32_t dimension_arr[3]{ snapshot.m_day, snapshot.m_width, snapshot.m_height };
+	const double stats_arr[2]{ snapshot.m_city_population, snapshot.m_fund };
+	output_file.write(reinterpret_cast<const char*>(prefix_arr), sizeof(prefix_arr));
+	output_file.write(snapshot.m_name.data(), snapshot.m_name.size());
+	output_file.write(reinterpret_cast<const char*>(dimension_arr), sizeof(dimension_arr));
+	output_file.write(reinterpret_cast<const char*>(stats_arr), sizeof(stats_arr));
+	output_file.write(reinterpret_cast<const char*>(thumbnail_vec.data()), thumbnail_vec.size());
+
+	// Close the file and check if everything has been written.
+	output_file.close();
+	if (output_file.fail())
+	{
+		std::cerr << "Error, failed to write save slot header file " << temp_header_path << '\n';
+		return false;
+	}
+	return CitySnapshot::commit_file(temp_header_path, m_header_path);
+}
+
+void SaveSlot::read_all_headers(std::vector<SaveSlotHeader>& headers_vec)
+{
+	headers_vec.clear();
+	SaveSlotHeader header;
+	for (unsigned int i = 0; i < SAVE_SLOTS_NUM; ++i)
+	{
+		if (SaveSlot(i).read_header(header))
+			headers_vec.emplace_back(std::move(header));
+	}
+}
+
+unsigned int SaveSlot::find_free_slot_idx()
+{
+	for (unsigned int i = 0; i < SAVE_SLOTS_NUM; ++i)
+	{
+		if (!SaveSlot(i).is_used())
+			return i;
+	}
+	return SAVE_SLOTS_NUM;
+}
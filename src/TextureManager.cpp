@@ -1,3 +1,6 @@
+#include <chrono>
+#include "AssetPack.hpp"
+#include "JobSystem.hpp"
 #include "TextureManager.hpp"
 
 std::shared_ptr<TextureManager> TextureManager::m_instance = nullptr;
@@ -13,11 +16,54 @@ std::shared_ptr<TextureManager> TextureManager::getInstance()
 
 void TextureManager::loadTexture(const std::string& texture_name, const std::string& file_name)
 {
-	// Load the input texture from the input file.
-	sf::Texture texture;
+	/* Load the input texture from the input file straight into its m_str_texture_map entry. sf::Texture has no move
+	 * operations, so assigning a loaded texture would copy it and upload its pixels a second time. */
+	sf::Texture& texture = getInstance()->m_str_texture_map[texture_name];
 	texture.loadFromFile(file_name);
-	// Store (texture name, texture) as a key-value pair inside the m_str_texture_map.
-	getInstance()->m_str_texture_map[texture_name] = texture;
+}
+
+void TextureManager::decodeImages(const std::vector<std::string>& file_name_vec, std::vector<sf::Image>& image_vec,
+	double& decode_sum_ms)
+{
+	image_vec.clear();
+	image_vec.resize(file_name_vec.size());
+	std::vector<double> decode_ms_vec(file_name_vec.size(), 0.0);
+
+	// One image per job, so idle threads steal the remaining images and a large image never holds back the others.
+	JobSystem::getInstance()->parallel_for(0, file_name_vec.size(), 1, [&](std::size_t begin, std::size_t end)
+	{
+		for (std::size_t idx = begin; idx < end; ++idx)
+		{
+			const auto start_time = std::chrono::steady_clock::now();
+			image_vec[idx].loadFromFile(file_name_vec[idx]);
+			decode_ms_vec[idx] = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() -
+				start_time).count();
+		}
+	});
+
+	decode_sum_ms = 0.0;
+	for (const auto decode_ms : decode_ms_vec)
+		decode_sum_ms += decode_ms;
+}
+
+void TextureManager::storeImages(const std::vector<std::string>& texture_name_vec,
+	const std::vector<sf::Image>& image_vec)
+{
+	for (std::size_t i = 0; i < texture_name_vec.size() && i < image_vec.size(); ++i)
+	{
+		sf::Texture& texture = getInstance()->m_str_texture_map[texture_name_vec[i]];
+		texture.loadFromImage(image_vec[i]);
+	}
+}
+
+void TextureManager::storePackedTextures(const std::vector<PackedTexture>& packed_textures_vec)
+{
+	for (const auto& each_texture : packed_textures_vec)
+	{
+		sf::Texture& texture = getInstance()->m_str_texture_map[each_texture.m_name];
+		if (texture.create(each_texture.m_width, each_texture.m_height))
+			texture.update(each_texture.m_pixels_ptr);
+	}
 }
 
 sf::Texture& TextureManager::getTextureRef(const std::string& texture_str)
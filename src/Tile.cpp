@@ -1,33 +1,21 @@
 #include "Tile.hpp"
 #include "Utility.hpp"
 
-void Tile::render(sf::RenderWindow& render_window, float dt)
+bool Tile::is_level_up_ready() const
 {
-	// Switch to current tile object's animation.
-	m_animationHandler_ptr->changeAnim(m_level);
-	// Update the current frame of animation.
-	m_animationHandler_ptr->update(dt);
-	// Set new current frame of animation's texture rect.
-	m_sprite.setTextureRect(m_animationHandler_ptr->get_each_frame_texture_rect());
-	// Draw current tile sprite on the render window.
-	render_window.draw(m_sprite);
+	/* Check if current tile is a zone tile, and its current population reaches current maximum population, and also
+	 * current tile's level is still lower than the max level. */
+	return (m_tileType == TileTypeEnum::RESIDENTIAL || m_tileType == TileTypeEnum::COMMERCIAL ||
+		m_tileType == TileTypeEnum::INDUSTRIAL) && (m_population == m_population_limit_per_level * (m_level + 1)) &&
+		m_level < m_max_level;
 }
 
-void Tile::chanceLevelUp()
+unsigned int Tile::get_level_up_chance() const
 {
-	/* Check if current tile is a zone tile, and its current population reaches current maximum population,
-	 * and also current tile's level is still lower than the max level. */
-	if ((m_tileType == TileTypeEnum::RESIDENTIAL || m_tileType == TileTypeEnum::COMMERCIAL
-	|| m_tileType == TileTypeEnum::INDUSTRIAL) && (m_population == m_population_limit_per_level * (m_level + 1))
-	&& m_level < m_max_level)
-	{
-		/* (rand() % int(RAND_BASE_NUM) will range between 0 and 999. For LEVEL_BASE_NUM / (m_level + 1),
-		 * result will be 100 for level 0, thus 10% chance to level up. Result will be 50 for level 1 thus 5% chance
-		 * to level up. Result will be 33 for level 2 thus 3.3% chance to level up.
-		 * Result will be 25 for level 3 thus 2.5% chance to level up.*/
-		if((rand() % int(RAND_BASE_NUM)) < (LEVEL_BASE_NUM / (m_level + 1)))
-			++m_level;
-	}
+	/* Result will be 100 for level 0, thus 10% chance to level up. Result will be 50 for level 1 thus 5% chance to
+	 * level up. Result will be 33 for level 2 thus 3.3% chance to level up. Result will be 25 for level 3 thus 2.5%
+	 * chance to level up. */
+	return LEVEL_BASE_NUM / (m_level + 1);
 }
 
 unsigned int Tile::getCost() const
@@ -53,4 +41,58 @@ void Tile::set_production_per_day(float production_per_day)
 float Tile::get_production_per_day() const
 {
 	return m_production_per_day;
-}
\ No newline at end of file
+}
+
+std::string tileTypeToStr(TileTypeEnum tile_type)
+{
+	// A string store the result.
+	std::string res_str{};
+	// Check each case, for unlisted input, use Void to represent.
+	switch (tile_type)
+	{
+	case TileTypeEnum::INDUSTRIAL:
+		res_str = INDUSTRIAL_TILE_TEXTURE_NAME;
+		break;
+	case TileTypeEnum::COMMERCIAL:
+		res_str = COMMERCIAL_TILE_TEXTURE_NAME;
+		break;
+	case TileTypeEnum::RESIDENTIAL:
+		res_str = RESIDENTIAL_TILE_TEXTURE_NAME;
+		break;
+	case TileTypeEnum::GRASS:
+		res_str = GRASS_TILE_TEXTURE_NAME;
+		break;
+	case TileTypeEnum::FOREST:
+		res_str = FOREST_TILE_TEXTURE_NAME;
+		break;
+	case TileTypeEnum::WATER:
+		res_str = WATER_TILE_TEXTURE_NAME;
+		break;
+	case TileTypeEnum::ROAD:
+		res_str = ROAD_TILE_TEXTURE_NAME;
+		break;
+	default:
+		res_str = VOID_TILE_TEXTURE_NAME;
+		break;
+	}
+	return res_str;
+}
+
+void load_tiles(std::unordered_map<std::string, Tile>& str_tile_map)
+{
+	// Each type of tile has its own placement cost, population limit per level and maximum level.
+	str_tile_map[GRASS_TILE_TEXTURE_NAME] = Tile(TileTypeEnum::GRASS, GRASS_TILE_COST,
+		GRASS_CURR_LEVEL_POPULATION_LIMIT, GRASS_TILE_MAX_LEVEL);
+	str_tile_map[FOREST_TILE_TEXTURE_NAME] = Tile(TileTypeEnum::FOREST, FOREST_TILE_COST,
+		FOREST_CURR_LEVEL_POPULATION_LIMIT, FOREST_TILE_MAX_LEVEL);
+	str_tile_map[WATER_TILE_TEXTURE_NAME] = Tile(TileTypeEnum::WATER, WATER_TILE_COST,
+		WATER_CURR_LEVEL_POPULATION_LIMIT, WATER_TILE_MAX_LEVEL);
+	str_tile_map[RESIDENTIAL_TILE_TEXTURE_NAME] = Tile(TileTypeEnum::RESIDENTIAL, RESIDENTIAL_TILE_COST,
+		RESIDENTIAL_CURR_LEVEL_POPULATION_LIMIT, RESIDENTIAL_TILE_MAX_LEVEL);
+	str_tile_map[COMMERCIAL_TILE_TEXTURE_NAME] = Tile(TileTypeEnum::COMMERCIAL, COMMERCIAL_TILE_COST,
+		COMMERCIAL_CURR_LEVEL_POPULATION_LIMIT, COMMERCIAL_TILE_MAX_LEVEL);
+	str_tile_map[INDUSTRIAL_TILE_TEXTURE_NAME] = Tile(TileTypeEnum::INDUSTRIAL, INDUSTRIAL_TILE_COST,
+		INDUSTRIAL_CURR_LEVEL_POPULATION_LIMIT, INDUSTRIAL_TILE_MAX_LEVEL);
+	str_tile_map[ROAD_TILE_TEXTURE_NAME] = Tile(TileTypeEnum::ROAD, ROAD_TILE_COST, ROAD_CURR_LEVEL_POPULATION_LIMIT,
+		ROAD_TILE_MAX_LEVEL);
+}
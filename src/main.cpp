@@ -1,16 +1,32 @@
 // The main entrance of the game.
+#include <iostream>
 #include "MainMenuGameState.hpp"
+#include "Profiler.hpp"
 // Main entrance of the game.
-int main()
+int main(int argc, char* argv[])
 {
 	// Initialize random number generator.
 	srand (time(nullptr));
 	// Create the game
 	Game game;
+	/* Record player's input into a trace file(--record <path>) or replay one instead of player's input(--replay <path>).
+	 * Print how long each startup step takes(--startup-trace).*/
+	for (int i = 1; i < argc; ++i)
+	{
+		if (argv[i] == STARTUP_TRACE_OPTION_STR)
+			game.print_startup_trace(std::cout);
+		else if (i + 1 >= argc)
+			break;
+		else if (argv[i] == RECORD_TRACE_OPTION_STR)
+			game.m_record_trace_path = argv[++i];
+		else if (argv[i] == REPLAY_TRACE_OPTION_STR)
+			game.m_replay_trace_path = argv[++i];
+	}
 	std::shared_ptr<Game> game_ptr(&game);
-	MainMenuGameState main_menu_game_state(game_ptr);
 	// Let game start with main menu scene first.
-	game.push_state(std::make_unique<MainMenuGameState>(main_menu_game_state));
+	game.push_state(std::make_unique<MainMenuGameState>(game_ptr));
 	game.game_loop();
-	return 0;
+	// Dump the profiling events of the whole session if profiling is compiled in.
+	PROFILE_DUMP(PROFILE_TRACE_PATH);
+	return game.m_is_replay_failed ? 1 : 0;
 }